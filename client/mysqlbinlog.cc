@@ -1579,6 +1579,34 @@ Exit_status process_event(PRINT_EVENT_INFO *print_event_info, Log_event *ev,
         destroy_evt= FALSE;
       break;
     }
+    case TRANSACTION_PAYLOAD_EVENT:
+    {
+      /* Process the events of the payload as if they followed it */
+      Transaction_payload_reader reader;
+      const char *errmsg= NULL;
+      if (ev->print(result_file, print_event_info))
+        goto err;
+      if (reader.load((Transaction_payload_log_event*) ev, &errmsg))
+      {
+        error("%s", errmsg);
+        goto err;
+      }
+      while (reader.has_events())
+      {
+        Log_event *payload_ev;
+        if (!(payload_ev= reader.read_event(glob_description_event,
+                                            opt_verify_binlog_checksum,
+                                            &errmsg)))
+        {
+          error("Could not read event from transaction payload: %s", errmsg);
+          goto err;
+        }
+        if ((retval= process_event(print_event_info, payload_ev, pos,
+                                   logname)) != OK_CONTINUE)
+          goto end;
+      }
+      break;
+    }
     case START_ENCRYPTION_EVENT:
       glob_description_event->start_decryption((Start_encryption_log_event*)ev);
       /* fall through */
@@ -0,0 +1,54 @@
+MACRO (MYSQL_CHECK_ZSTD)
+
+  STRING(TOLOWER "${WITH_ZSTD}" WITH_ZSTD_LOWERCASE)
+
+  IF(NOT WITH_ZSTD)
+    MESSAGE_ONCE(zstd "WITH_ZSTD=OFF: binlog transaction compression disabled")
+
+  ELSEIF(NOT WITH_ZSTD_LOWERCASE STREQUAL "auto" AND NOT WITH_ZSTD_LOWERCASE STREQUAL "on")
+      MESSAGE(FATAL_ERROR "Wrong value for WITH_ZSTD")
+
+  ELSE()
+    FIND_PACKAGE(ZSTD QUIET)
+
+    IF(ZSTD_FOUND)
+      SET(SAVE_CMAKE_REQUIRED_INCLUDES ${CMAKE_REQUIRED_INCLUDES})
+      SET(SAVE_CMAKE_REQUIRED_LIBRARIES ${CMAKE_REQUIRED_LIBRARIES})
+      SET(CMAKE_REQUIRED_INCLUDES ${CMAKE_REQUIRED_INCLUDES} ${ZSTD_INCLUDE_DIRS})
+      SET(CMAKE_REQUIRED_LIBRARIES ${CMAKE_REQUIRED_LIBRARIES} ${ZSTD_LIBRARIES})
+      CHECK_C_SOURCE_COMPILES(
+      "
+      #include <zstd.h>
+      int main()
+      {
+         ZSTD_CCtx *cctx= ZSTD_createCCtx();
+         ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, 3);
+         return ZSTD_freeCCtx(cctx) != 0;
+      }"
+      HAVE_ZSTD)
+      SET(CMAKE_REQUIRED_INCLUDES ${SAVE_CMAKE_REQUIRED_INCLUDES})
+      SET(CMAKE_REQUIRED_LIBRARIES ${SAVE_CMAKE_REQUIRED_LIBRARIES})
+      IF(HAVE_ZSTD)
+        ADD_DEFINITIONS(-DHAVE_ZSTD=1)
+        INCLUDE_DIRECTORIES(SYSTEM ${ZSTD_INCLUDE_DIRS})
+        SET(ZSTD_LIBRARY ${ZSTD_LIBRARIES})
+      ENDIF()
+    ENDIF()
+
+    ADD_FEATURE_INFO(ZSTD HAVE_ZSTD "zstd binlog transaction compression")
+    IF(WITH_ZSTD_LOWERCASE STREQUAL "auto" AND HAVE_ZSTD)
+      MESSAGE_ONCE(zstd "WITH_ZSTD=AUTO: binlog transaction compression enabled")
+    ELSEIF(WITH_ZSTD_LOWERCASE STREQUAL "auto" AND NOT HAVE_ZSTD)
+      MESSAGE_ONCE(zstd "WITH_ZSTD=AUTO: binlog transaction compression disabled")
+    ELSEIF(HAVE_ZSTD)
+      MESSAGE_ONCE(zstd "WITH_ZSTD=ON: binlog transaction compression enabled")
+    ELSE()
+      # Forget it in cache, abort the build.
+      UNSET(WITH_ZSTD CACHE)
+      UNSET(ZSTD_LIBRARY CACHE)
+      MESSAGE(FATAL_ERROR "WITH_ZSTD=ON: Could not find zstd headers/libraries")
+    ENDIF()
+
+ ENDIF()
+
+ENDMACRO()
@@ -57,6 +57,12 @@ int decimal2bin(const decimal_t *from, uchar *to, decimal_digits_t precision,
                 decimal_digits_t scale);
 int bin2decimal(const uchar *from, decimal_t *to, decimal_digits_t precision,
                 decimal_digits_t scale);
+int decimal2longlong_scaled(const decimal_t *from, decimal_digits_t scale,
+                            longlong *to);
+int longlong_scaled2decimal(longlong from, decimal_digits_t scale,
+                            decimal_t *to);
+int bin2longlong_scaled(const uchar *from, decimal_digits_t precision,
+                        decimal_digits_t scale, longlong *to);
 
 uint decimal_size(decimal_digits_t precision, decimal_digits_t scale);
 uint decimal_bin_size(decimal_digits_t precision, decimal_digits_t scale);
@@ -77,6 +83,12 @@ int decimal_is_zero(const decimal_t *from);
 void max_decimal(decimal_digits_t precision, decimal_digits_t frac,
                  decimal_t *to);
 
+/*
+  Decimals of up to this many digits always fit into a longlong scaled
+  by 10^scale, see decimal2longlong_scaled()
+*/
+#define DECIMAL_SCALED_LONGLONG_DIGITS 18
+
 #define string2decimal(A,B,C) internal_str2dec((A), (B), (C), 0)
 #define string2decimal_fixed(A,B,C) internal_str2dec((A), (B), (C), 1)
 
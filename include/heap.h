@@ -82,7 +82,8 @@ struct st_level_info
 
 
 /*
-  Heap table records and hash index entries are stored in HP_BLOCKs.
+  Heap table records, blob data and hash index entries are stored in
+  HP_BLOCKs.
   HP_BLOCK is used as a 'growable array' of fixed-size records. Size of record
   is recbuffer bytes.
   The internal representation is as follows:
@@ -109,6 +110,12 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For referense */
 
+typedef struct st_hp_blob_desc		/* A blob column of the record */
+{
+  uint offset;				/* Offset of the blob in the record */
+  uint packlength;			/* Bytes used for the blob length */
+} HP_BLOB_DESC;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -133,7 +140,9 @@ typedef struct st_hp_keydef		/* Key definition with open */
 typedef struct st_heap_share
 {
   HP_BLOCK block;
+  HP_BLOCK blob_block;			/* Chunks with the blob data */
   HP_KEYDEF  *keydef;
+  HP_BLOB_DESC *blob_descs;
   ulonglong data_length,index_length,max_table_size;
   ulonglong auto_increment;
   ulong min_records,max_records;	/* Params to open */
@@ -147,9 +156,12 @@ typedef struct st_heap_share
   uint visible;                         /* Offset to the visible/deleted mark */
   uint changed;
   uint keys,max_key_length;
+  uint blobs;				/* Number of blob columns */
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
+  uchar *blob_del_link;			/* Link to next free blob chunk */
+  uchar *blob_pending;			/* Chunks of last deleted blobs */
   char * name;			/* Name of "memory-file" */
   time_t create_time;
   THR_LOCK lock;
@@ -173,6 +185,9 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar *blob_record;                   /* Record to store, for update */
+  uchar *blob_buff;                     /* Blobs longer than one chunk */
+  size_t blob_buff_length;
   enum ha_rkey_function last_find_flag;
   TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
   TREE_ELEMENT **last_pos;
@@ -188,6 +203,8 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_BLOB_DESC *blob_descs;
+  uint blobs;
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
   uint auto_key_type;
   uint keys;
@@ -217,6 +234,7 @@ extern int heap_update(HP_INFO *info,const uchar *old,const uchar *newdata);
 extern int heap_rrnd(HP_INFO *info,uchar *buf,uchar *pos);
 extern int heap_scan_init(HP_INFO *info);
 extern int heap_scan(HP_INFO *info, uchar *record);
+extern int heap_scan_restart(HP_INFO *info, uchar *record, ulong pos);
 extern int heap_delete(HP_INFO *info,const uchar *buff);
 extern int heap_info(HP_INFO *info,HEAPINFO *x,int flag);
 extern int heap_create(const char *name,
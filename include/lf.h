@@ -49,6 +49,8 @@ int lf_dynarray_iterate(LF_DYNARRAY *array, lf_dynarray_func func, void *arg);
 
 #define LF_PINBOX_PINS 4
 #define LF_PURGATORY_SIZE 100
+/* limbo lists of an LF_PINS in the epoch based mode, see lf_alloc-pin.c */
+#define LF_EPOCH_LIMBOS 3
 
 typedef void lf_pinbox_free_func(void *, void *, void*);
 
@@ -59,6 +61,8 @@ typedef struct {
   uint free_ptr_offset;
   uint32 volatile pinstack_top_ver;         /* this is a versioned pointer */
   uint32 volatile pins_in_array;            /* number of elements in array */
+  uint64 volatile epoch;                    /* global epoch, if epoch_based */
+  my_bool epoch_based;                      /* see lf_alloc-pin.c */
 } LF_PINBOX;
 
 typedef struct {
@@ -67,15 +71,29 @@ typedef struct {
   void  *purgatory;
   uint32 purgatory_count;
   uint32 volatile link;
+  /* the epoch based mode, see lf_alloc-pin.c */
+  uint64 volatile epoch;                    /* 0 when not in an operation */
+  uint32 epoch_nesting;
+  my_bool epoch_based;                      /* copy of LF_PINBOX::epoch_based */
+  my_bool epoch_search;                     /* lf_hash_search() result held */
+  void *limbo[LF_EPOCH_LIMBOS], *limbo_last[LF_EPOCH_LIMBOS];
+  uint64 limbo_epoch[LF_EPOCH_LIMBOS];
   /* avoid false sharing */
   char pad[CPU_LEVEL1_DCACHE_LINESIZE];
 } LF_PINS;
 
-/* compile-time assert to make sure we have enough pins.  */
+/*
+  compile-time assert to make sure we have enough pins.
+  In the epoch based mode pins protect nothing, no barrier is needed.
+*/
 #define lf_pin(PINS, PIN, ADDR)                                \
   do {                                                          \
     compile_time_assert(PIN < LF_PINBOX_PINS);                  \
-    my_atomic_storeptr(&(PINS)->pin[PIN], (ADDR));              \
+    if ((PINS)->epoch_based)                                    \
+      my_atomic_storeptr_explicit(&(PINS)->pin[PIN], (ADDR),    \
+                                  MY_MEMORY_ORDER_RELAXED);     \
+    else                                                        \
+      my_atomic_storeptr(&(PINS)->pin[PIN], (ADDR));            \
   } while(0)
 
 #define lf_unpin(PINS, PIN)        lf_pin(PINS, PIN, NULL)
@@ -90,6 +108,37 @@ LF_PINS *lf_pinbox_get_pins(LF_PINBOX *pinbox);
 void lf_pinbox_put_pins(LF_PINS *pins);
 void lf_pinbox_free(LF_PINS *pins, void *addr);
 
+/*
+  Enter and leave an operation on a pinbox in the epoch based mode.
+  Objects are only accessed between the two, calls may be nested.
+  Nothing is done for a pinbox that uses pins.
+*/
+static inline void lf_epoch_enter(LF_PINS *pins)
+{
+  if (pins->epoch_based && !pins->epoch_nesting++)
+  {
+    uint64 epoch= my_atomic_load64_explicit((int64 volatile*)
+                                            &pins->pinbox->epoch,
+                                            MY_MEMORY_ORDER_RELAXED);
+    for (;;)
+    {
+      uint64 now;
+      my_atomic_store64((int64 volatile*) &pins->epoch, epoch);
+      now= my_atomic_load64((int64 volatile*) &pins->pinbox->epoch);
+      if (now == epoch)
+        break;
+      epoch= now;
+    }
+  }
+}
+
+static inline void lf_epoch_exit(LF_PINS *pins)
+{
+  if (pins->epoch_based && !--pins->epoch_nesting)
+    my_atomic_store64_explicit((int64 volatile*) &pins->epoch, 0,
+                               MY_MEMORY_ORDER_RELEASE);
+}
+
 /*
   memory allocator, lf_alloc-pin.c
 */
@@ -104,6 +153,8 @@ typedef struct st_lf_allocator {
 } LF_ALLOCATOR;
 
 void lf_alloc_init(LF_ALLOCATOR *allocator, uint size, uint free_ptr_offset);
+/* must be called before any pins are taken, see lf_epoch_enter() */
+#define lf_alloc_set_epoch_based(A)    ((A)->pinbox.epoch_based= 1)
 void lf_alloc_destroy(LF_ALLOCATOR *allocator);
 uint lf_alloc_pool_count(LF_ALLOCATOR *allocator);
 /*
@@ -135,6 +186,7 @@ typedef struct st_lf_hash LF_HASH;
 typedef void (*lf_hash_initializer)(LF_HASH *hash, void *dst, const void *src);
 
 #define LF_HASH_UNIQUE 1
+#define LF_HASH_EPOCH  2     /* epoch based memory reclamation, no pins */
 
 /* lf_hash overhead per element (that is, sizeof(LF_SLIST) */
 extern const int LF_HASH_OVERHEAD;
@@ -148,7 +200,7 @@ struct st_lf_hash {
   CHARSET_INFO *charset;                /* see HASH */
   uint key_offset, key_length;          /* see HASH */
   uint element_size;                    /* size of memcpy'ed area on insert */
-  uint flags;                           /* LF_HASH_UNIQUE, etc */
+  uint flags;                           /* LF_HASH_UNIQUE, LF_HASH_EPOCH */
   int32 volatile size;                  /* size of array */
   int32 volatile count;                 /* number of elements in the hash */
 };
@@ -173,7 +225,16 @@ int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins,
 */
 #define lf_hash_get_pins(HASH)       lf_alloc_get_pins(&(HASH)->alloc)
 #define lf_hash_put_pins(PINS)       lf_pinbox_put_pins(PINS)
-#define lf_hash_search_unpin(PINS)   lf_unpin((PINS), 2)
+/* release the element returned by lf_hash_search() */
+static inline void lf_hash_search_unpin(LF_PINS *pins)
+{
+  lf_unpin(pins, 2);
+  if (pins->epoch_search)
+  {
+    pins->epoch_search= 0;
+    lf_epoch_exit(pins);
+  }
+}
 /*
   cleanup
 */
@@ -131,6 +131,8 @@ double my_atof(const char *nptr);
 size_t my_fcvt(double x, int precision, char *to, my_bool *error);
 size_t my_gcvt(double x, my_gcvt_arg_type type, int width, char *to,
                my_bool *error);
+/* Cleared by unit tests to compare with the bignum conversions */
+extern my_bool my_fast_dtoa;
 
 /*
   The longest string my_fcvt can return is 311 + "precision" bytes.
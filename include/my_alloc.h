@@ -53,6 +53,20 @@ typedef struct st_mem_root
   unsigned short first_block_usage;
   unsigned short flags;
 
+  /*
+    Maximum size of the blocks that free_root(MY_KEEP_PREALLOC) keeps
+    for reuse, including the preallocated block (0: keep only that one)
+  */
+  size_t keep_limit;
+  /* Total size of the blocks at recent free_root() calls, decaying */
+  size_t high_water;
+  /*
+    Statistics: blocks allocated, and blocks kept by free_root();
+    the owner of the root may read and reset them
+  */
+  size_t blocks_allocated;
+  size_t blocks_reused;
+
   void (*error_handler)(void);
 
   PSI_memory_key psi_key;
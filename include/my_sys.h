@@ -64,6 +64,7 @@ C_MODE_START
 #define MY_NOSYMLINKS  512U     /* my_open(): don't follow symlinks */
 #define MY_FULL_IO     512U     /* my_read(): loop until I/O is complete */
 #define MY_DONT_CHECK_FILESIZE 128U /* Option to init_io_cache() */
+#define MY_READ_AHEAD  1024U    /* init_io_cache(): asynchronous read-ahead */
 #define MY_LINK_WARNING 32U	/* my_redel() gives warning if links */
 #define MY_COPYTIME	64U	/* my_redel() copies time */
 #define MY_DELETE_OLD	256U	/* my_create_with_symlink() */
@@ -434,6 +435,12 @@ typedef struct st_io_cache		/* Used when caching files */
     READ_CACHE mode is supported.
   */
   IO_CACHE_SHARE *share;
+  /*
+    Read-ahead of the next buffer while the current one is consumed. Set
+    up for a READ_CACHE with MY_READ_AHEAD if the server provides
+    asynchronous reads, NULL otherwise.
+  */
+  struct st_io_cache_aio *aio;
 
   /*
     A caller will use my_b_read() macro to read from the cache
@@ -896,6 +903,7 @@ extern void init_alloc_root(PSI_memory_key key, MEM_ROOT *mem_root,
 extern void *alloc_root(MEM_ROOT *mem_root, size_t Size);
 extern void *multi_alloc_root(MEM_ROOT *mem_root, ...);
 extern void free_root(MEM_ROOT *root, myf MyFLAGS);
+extern void set_root_keep_limit(MEM_ROOT *root, size_t keep_limit);
 extern void set_prealloc_root(MEM_ROOT *root, char *ptr);
 extern void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
                                 size_t prealloc_size);
@@ -99,6 +99,33 @@
   between THD's (LF_PINS::stack_ends_here being a primary reason
   for this limitation).
 */
+
+/*
+  Epoch based reclamation
+
+  A pinbox with epoch_based set does not look at pins at all. Pins are
+  still set by the lock-free algorithms, but without memory barriers and
+  no one scans them. Instead, every operation is bracketed by
+  lf_epoch_enter() and lf_epoch_exit(), which publish in LF_PINS::epoch
+  the global epoch that the thread saw when it started (0 means "not in
+  an operation"). That is one full barrier per operation instead of one
+  per pin.
+
+  A freed object is put into one of LF_EPOCH_LIMBOS thread-local limbo
+  lists, tagged with the global epoch read after the object was unlinked.
+  Every LF_PURGATORY_SIZE free() the thread tries to advance the global
+  epoch, which succeeds only when every thread that is in an operation
+  has seen the current epoch. When the global epoch is two ahead of the
+  tag of a limbo list, every thread that could have seen the objects in
+  it has left its operation, and the list is freed as a whole. Tags that
+  are not yet freeable are either the current epoch or the one before,
+  thus three lists are always enough.
+
+  The price is that a thread stuck in an operation stops all reclamation
+  in the pinbox, and the memory waiting in limbo is not bounded by the
+  number of pins. The mode is chosen per LF_HASH with LF_HASH_EPOCH, or
+  per LF_ALLOCATOR with lf_alloc_set_epoch_based().
+*/
 #include "mysys_priv.h"
 #include <lf.h>
 #include "my_cpu.h"
@@ -112,6 +139,7 @@
 #define LF_PINBOX_MAX_PINS 65536
 
 static void lf_pinbox_real_free(LF_PINS *pins);
+static uint lf_epoch_reclaim(LF_PINS *pins);
 
 /*
   Initialize a pinbox. Normally called from lf_alloc_init.
@@ -127,6 +155,8 @@ void lf_pinbox_init(LF_PINBOX *pinbox, uint free_ptr_offset,
   pinbox->free_ptr_offset= free_ptr_offset;
   pinbox->free_func= free_func;
   pinbox->free_func_arg= free_func_arg;
+  pinbox->epoch= 1;
+  pinbox->epoch_based= 0;
 }
 
 void lf_pinbox_destroy(LF_PINBOX *pinbox)
@@ -193,6 +223,11 @@ LF_PINS *lf_pinbox_get_pins(LF_PINBOX *pinbox)
   el->link= pins;
   el->purgatory_count= 0;
   el->pinbox= pinbox;
+  el->epoch= 0;
+  el->epoch_nesting= 0;
+  el->epoch_based= pinbox->epoch_based;
+  el->epoch_search= 0;
+  bzero(el->limbo, sizeof(el->limbo));
 
   return el;
 }
@@ -217,6 +252,7 @@ void lf_pinbox_put_pins(LF_PINS *pins)
     int i;
     for (i= 0; i < LF_PINBOX_PINS; i++)
       DBUG_ASSERT(pins->pin[i] == 0);
+    DBUG_ASSERT(!pins->epoch_nesting);
   }
 #endif /* DBUG_OFF */
 
@@ -226,6 +262,11 @@ void lf_pinbox_put_pins(LF_PINS *pins)
     and they would have pinned addresses that the caller wants to free.
     Thus: only free pins when all work is done and nobody can wait for you!!!
   */
+  if (pins->epoch_based)
+  {
+    while (lf_epoch_reclaim(pins))
+      pthread_yield();
+  }
   while (pins->purgatory_count)
   {
     lf_pinbox_real_free(pins);
@@ -257,6 +298,40 @@ static int ptr_cmp(void **a, void **b)
     (PINS)->purgatory_count++;                                          \
   } while (0)
 
+/*
+  Put an object into the limbo list tagged with the current global epoch,
+  see "Epoch based reclamation" above
+*/
+static void add_to_limbo(LF_PINS *pins, void *addr)
+{
+  LF_PINBOX *pinbox= pins->pinbox;
+  /* read after the object was unlinked by the caller */
+  uint64 epoch= my_atomic_load64((int64 volatile*) &pinbox->epoch);
+  int i;
+
+  for (;;)
+  {
+    for (i= 0; i < LF_EPOCH_LIMBOS; i++)
+      if (pins->limbo[i] && pins->limbo_epoch[i] == epoch)
+        goto found;
+    for (i= 0; i < LF_EPOCH_LIMBOS; i++)
+      if (!pins->limbo[i])
+        goto found;
+    /* all lists are older than this epoch, one of them can be freed */
+    lf_epoch_reclaim(pins);
+  }
+found:
+  *(void **)((char *)addr+pinbox->free_ptr_offset)= pins->limbo[i];
+  if (!pins->limbo[i])
+  {
+    pins->limbo_last[i]= addr;
+    pins->limbo_epoch[i]= epoch;
+  }
+  pins->limbo[i]= addr;
+  if (++pins->purgatory_count % LF_PURGATORY_SIZE == 0)
+    lf_epoch_reclaim(pins);
+}
+
 /*
   Free an object allocated via pinbox allocator
 
@@ -266,6 +341,11 @@ static int ptr_cmp(void **a, void **b)
 */
 void lf_pinbox_free(LF_PINS *pins, void *addr)
 {
+  if (pins->epoch_based)
+  {
+    add_to_limbo(pins, addr);
+    return;
+  }
   add_to_purgatory(pins, addr);
   if (pins->purgatory_count % LF_PURGATORY_SIZE == 0)
    lf_pinbox_real_free(pins);
@@ -403,6 +483,63 @@ static void lf_pinbox_real_free(LF_PINS *pins)
     pinbox->free_func(first, last, pinbox->free_func_arg);
 }
 
+/*
+  callback for lf_dynarray_iterate:
+  see if any thread is in an operation with an older epoch than the given one
+*/
+static int epoch_lagging(LF_PINS *el, uint64 *epoch)
+{
+  LF_PINS *el_end= el+LF_DYNARRAY_LEVEL_LENGTH;
+  for (; el < el_end; el++)
+  {
+    uint64 e= my_atomic_load64((int64 volatile*) &el->epoch);
+    if (e && e != *epoch)
+      return 1;
+  }
+  return 0;
+}
+
+/*
+  Try to advance the global epoch and free the limbo lists that are old
+  enough
+
+  RETURN
+    the number of limbo lists that are still not empty
+*/
+static uint lf_epoch_reclaim(LF_PINS *pins)
+{
+  LF_PINBOX *pinbox= pins->pinbox;
+  uint64 epoch= my_atomic_load64((int64 volatile*) &pinbox->epoch);
+  uint i, left= 0;
+
+  if (!lf_dynarray_iterate(&pinbox->pinarray,
+                           (lf_dynarray_func) epoch_lagging, &epoch))
+  {
+    /* if the CAS fails, someone else has advanced it */
+    int64 expected= (int64) epoch;
+    if (my_atomic_cas64((int64 volatile*) &pinbox->epoch, &expected,
+                        (int64) epoch + 1))
+      epoch++;
+    else
+      epoch= (uint64) expected;
+  }
+  for (i= 0; i < LF_EPOCH_LIMBOS; i++)
+  {
+    if (!pins->limbo[i])
+      continue;
+    if (epoch - pins->limbo_epoch[i] >= 2)
+    {
+      pinbox->free_func(pins->limbo[i], pins->limbo_last[i],
+                        pinbox->free_func_arg);
+      pins->limbo[i]= 0;
+    }
+    else
+      left++;
+  }
+  pins->purgatory_count= 0;
+  return left;
+}
+
 /* lock-free memory allocator for fixed-size objects */
 
 /*
@@ -487,11 +624,14 @@ void lf_alloc_destroy(LF_ALLOCATOR *allocator)
   DESCRIPTION
     Pop an unused object from the stack or malloc it is the stack is empty.
     pin[0] is used, it's removed on return.
+    In the epoch based mode this is an operation of its own, see
+    lf_epoch_enter().
 */
 void *lf_alloc_new(LF_PINS *pins)
 {
   LF_ALLOCATOR *allocator= (LF_ALLOCATOR *)(pins->pinbox->free_func_arg);
   uchar *node;
+  lf_epoch_enter(pins);
   for (;;)
   {
     do
@@ -516,6 +656,7 @@ void *lf_alloc_new(LF_PINS *pins)
       break;
   }
  lf_unpin(pins, 0);
+  lf_epoch_exit(pins);
   return node;
 }
 
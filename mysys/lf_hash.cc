@@ -360,6 +360,8 @@ void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
 {
   lf_alloc_init(&hash->alloc, sizeof(LF_SLIST)+element_size,
                 offsetof(LF_SLIST, key));
+  if (flags & LF_HASH_EPOCH)
+    lf_alloc_set_epoch_based(&hash->alloc);
   lf_dynarray_init(&hash->array, sizeof(LF_SLIST *));
   hash->size= 1;
   hash->count= 0;
@@ -395,20 +397,7 @@ void lf_hash_destroy(LF_HASH *hash)
   lf_dynarray_destroy(&hash->array);
 }
 
-/*
-  DESCRIPTION
-    inserts a new element to a hash. it will have a _copy_ of
-    data, not a pointer to it.
-
-  RETURN
-    0 - inserted
-    1 - didn't (unique key conflict)
-   -1 - out of memory
-
-  NOTE
-    see l_insert() for pin usage notes
-*/
-int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
+static int lf_hash_insert_low(LF_HASH *hash, LF_PINS *pins, const void *data)
 {
   int csize, bucket, hashnr;
   LF_SLIST *node, **el;
@@ -437,6 +426,28 @@ int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
   return 0;
 }
 
+/*
+  DESCRIPTION
+    inserts a new element to a hash. it will have a _copy_ of
+    data, not a pointer to it.
+
+  RETURN
+    0 - inserted
+    1 - didn't (unique key conflict)
+   -1 - out of memory
+
+  NOTE
+    see l_insert() for pin usage notes
+*/
+int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
+{
+  int res;
+  lf_epoch_enter(pins);
+  res= lf_hash_insert_low(hash, pins, data);
+  lf_epoch_exit(pins);
+  return res;
+}
+
 /*
   DESCRIPTION
     deletes an element with the given key from the hash (if a hash is
@@ -452,9 +463,11 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
 {
   LF_SLIST **el;
   uint bucket, hashnr;
+  int res= 1;
 
   hashnr= hash->hash_function(hash->charset, (uchar *)key, keylen) & INT_MAX32;
 
+  lf_epoch_enter(pins);
   /* hide OOM errors - if we cannot initialize a bucket, try the previous one */
   for (bucket= hashnr % hash->size; ;bucket= my_clear_highest_bit(bucket))
   {
@@ -462,15 +475,17 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
     if (el && (*el || initialize_bucket(hash, el, bucket, pins) == 0))
       break;
     if (unlikely(bucket == 0))
-      return 1; /* if there's no bucket==0, the hash is empty */
+      goto end; /* if there's no bucket==0, the hash is empty */
   }
-  if (l_delete(el, hash->charset, my_reverse_bits(hashnr) | 1,
-              (uchar *)key, keylen, pins))
+  if (!l_delete(el, hash->charset, my_reverse_bits(hashnr) | 1,
+               (uchar *)key, keylen, pins))
   {
-    return 1;
+    my_atomic_add32(&hash->count, -1);
+    res= 0;
   }
-  my_atomic_add32(&hash->count, -1);
-  return 0;
+end:
+  lf_epoch_exit(pins);
+  return res;
 }
 
 /*
@@ -481,14 +496,17 @@ int lf_hash_delete(LF_HASH *hash, LF_PINS *pins, const void *key, uint keylen)
 
   NOTE
     see l_search() for pin usage notes
+    in the epoch based mode the operation lasts until lf_hash_search_unpin()
+    if an element is found
 */
 void *lf_hash_search_using_hash_value(LF_HASH *hash, LF_PINS *pins,
                                       my_hash_value_type hashnr,
                                       const void *key, uint keylen)
 {
-  LF_SLIST **el, *found;
+  LF_SLIST **el, *found= 0;
   uint bucket;
 
+  lf_epoch_enter(pins);
   /* hide OOM errors - if we cannot initialize a bucket, try the previous one */
   for (bucket= hashnr % hash->size; ;bucket= my_clear_highest_bit(bucket))
   {
@@ -496,10 +514,15 @@ void *lf_hash_search_using_hash_value(LF_HASH *hash, LF_PINS *pins,
     if (el && (*el || initialize_bucket(hash, el, bucket, pins) == 0))
       break;
     if (unlikely(bucket == 0))
-      return 0; /* if there's no bucket==0, the hash is empty */
+      goto end; /* if there's no bucket==0, the hash is empty */
   }
   found= l_search(el, hash->charset, my_reverse_bits(hashnr) | 1,
                  (uchar *)key, keylen, pins);
+end:
+  if (found && pins->epoch_based && !pins->epoch_search)
+    pins->epoch_search= 1;        /* lf_hash_search_unpin() will exit */
+  else
+    lf_epoch_exit(pins);
   return found ? found+1 : 0;
 }
 
@@ -525,14 +548,19 @@ int lf_hash_iterate(LF_HASH *hash, LF_PINS *pins,
   el= (LF_SLIST **)lf_dynarray_lvalue(&hash->array, bucket);
   if (unlikely(!el))
     return 0; /* if there's no bucket==0, the hash is empty */
+  lf_epoch_enter(pins);
   if (*el == NULL && unlikely(initialize_bucket(hash, el, bucket, pins)))
+  {
+    lf_epoch_exit(pins);
     return 0; /* if there's no bucket==0, the hash is empty */
+  }
 
   res= l_find(el, 0, 0, (uchar*)argument, 0, &cursor, pins, action);
 
   lf_unpin(pins, 2);
   lf_unpin(pins, 1);
   lf_unpin(pins, 0);
+  lf_epoch_exit(pins);
   return res;
 }
 
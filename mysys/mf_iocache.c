@@ -20,7 +20,7 @@
   length records. A read isn't allowed to go over file-length. A read is ok
   if it ends at file-length and next read can try to read after file-length
   (and get a EOF-error).
-  Possibly use of asyncronic io.
+  READ_CACHE can use asynchronous read-ahead, see _my_b_cache_read_async().
   macros for read and writes for faster io.
   Used instead of FILE when reading or writing whole files.
   One can change info->pos_in_file to a higher value to skip bytes in file if
@@ -65,12 +65,14 @@ PSI_file_key key_file_io_cache;
 
 static int _my_b_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count);
 static int _my_b_cache_read_r(IO_CACHE *info, uchar *Buffer, size_t Count);
+static int _my_b_cache_read_async(IO_CACHE *info, uchar *Buffer, size_t Count);
 static int _my_b_seq_read(IO_CACHE *info, uchar *Buffer, size_t Count);
 static int _my_b_cache_write(IO_CACHE *info, const uchar *Buffer, size_t Count);
 static int _my_b_cache_write_r(IO_CACHE *info, const uchar *Buffer, size_t Count);
 
 int (*_my_b_encr_read)(IO_CACHE *info,uchar *Buffer,size_t Count)= 0;
 int (*_my_b_encr_write)(IO_CACHE *info,const uchar *Buffer,size_t Count)= 0;
+int (*_my_b_aio_read)(IO_CACHE_AIO *aio)= 0;
 
 
 
@@ -112,7 +114,9 @@ init_functions(IO_CACHE* info)
     /* fall through */
   case READ_FIFO:
     DBUG_ASSERT(!(info->myflags & MY_ENCRYPT));
-    info->read_function = info->share ? _my_b_cache_read_r : _my_b_cache_read;
+    info->read_function = info->share ? _my_b_cache_read_r :
+                          info->aio ? _my_b_cache_read_async :
+                          _my_b_cache_read;
     info->write_function = info->share ? _my_b_cache_write_r : _my_b_cache_write;
     break;
   case TYPE_NOT_SET:
@@ -126,6 +130,123 @@ init_functions(IO_CACHE* info)
 }
 
 
+/*
+  Allocate the read-ahead buffer of a READ_CACHE opened with MY_READ_AHEAD
+
+  The read-ahead is only used if the server has provided asynchronous reads
+  and the cache reads a real file with a buffer of its own. Failure to
+  allocate is not an error, the cache then just reads synchronously.
+*/
+
+static void io_cache_aio_init(IO_CACHE *info)
+{
+  IO_CACHE_AIO *aio;
+  if (!(info->myflags & MY_READ_AHEAD) || info->aio || !_my_b_aio_read ||
+      info->file < 0 || info->share || !info->alloced_buffer ||
+      (info->myflags & MY_ENCRYPT))
+    return;
+  if (!(aio= (IO_CACHE_AIO*) my_malloc(key_memory_IO_CACHE, sizeof(*aio),
+                                       MYF(info->myflags &
+                                           MY_THREAD_SPECIFIC))))
+    return;
+  if (!(aio->buffer= (uchar*) my_malloc(key_memory_IO_CACHE,
+                                        info->alloced_buffer,
+                                        MYF(info->myflags &
+                                            MY_THREAD_SPECIFIC))))
+  {
+    my_free(aio);
+    return;
+  }
+  mysql_mutex_init(key_IO_CACHE_AIO_mutex, &aio->mutex, MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_IO_CACHE_AIO_cond, &aio->cond, 0);
+  aio->pending= aio->started= 0;
+  info->aio= aio;
+}
+
+
+/* Wait for the read-ahead and forget about it */
+
+static void io_cache_aio_wait(IO_CACHE_AIO *aio)
+{
+  if (!aio->started)
+    return;
+  mysql_mutex_lock(&aio->mutex);
+  while (aio->pending)
+    mysql_cond_wait(&aio->cond, &aio->mutex);
+  mysql_mutex_unlock(&aio->mutex);
+  aio->started= 0;
+}
+
+
+static void io_cache_aio_end(IO_CACHE *info)
+{
+  IO_CACHE_AIO *aio= info->aio;
+  if (!aio)
+    return;
+  io_cache_aio_wait(aio);
+  mysql_cond_destroy(&aio->cond);
+  mysql_mutex_destroy(&aio->mutex);
+  my_free(aio->buffer);
+  my_free(aio);
+  info->aio= 0;
+}
+
+
+/*
+  Start reading the buffer that follows the one in the cache
+
+  The read is aligned like the ones of _my_b_cache_read() and does not
+  go past end_of_file.
+*/
+
+static void io_cache_aio_start(IO_CACHE *info)
+{
+  IO_CACHE_AIO *aio= info->aio;
+  my_off_t pos_in_file= info->pos_in_file +
+                        (size_t) (info->read_end - info->buffer);
+  size_t length;
+
+  DBUG_ASSERT(!aio->started);
+  if (pos_in_file >= info->end_of_file)
+    return;
+  length= info->read_length - (size_t) (pos_in_file & (IO_SIZE-1));
+  if (length > info->end_of_file - pos_in_file)
+    length= (size_t) (info->end_of_file - pos_in_file);
+
+  aio->file= info->file;
+  aio->pos_in_file= pos_in_file;
+  aio->length= length;
+  aio->read_length= 0;
+  aio->error= 0;
+  aio->pending= 1;
+  if (_my_b_aio_read(aio))
+    aio->pending= 0;
+  else
+    aio->started= 1;
+}
+
+
+/*
+  Called by the asynchronous read service when a read has completed
+
+  SYNOPSIS
+    my_b_aio_read_done()
+      aio                       The read-ahead
+      length                    Number of bytes read, or (size_t) -1
+      error                     errno if the read failed
+*/
+
+void my_b_aio_read_done(IO_CACHE_AIO *aio, size_t length, int error)
+{
+  mysql_mutex_lock(&aio->mutex);
+  aio->read_length= length;
+  aio->error= error;
+  aio->pending= 0;
+  mysql_cond_signal(&aio->cond);
+  mysql_mutex_unlock(&aio->mutex);
+}
+
+
 /*
   Initialize an IO_CACHE object
 
@@ -198,6 +319,7 @@ int init_io_cache_ext(IO_CACHE *info, File file, size_t cachesize,
 
   info->disk_writes= 0;
   info->share=0;
+  info->aio= 0;
 
   if (!cachesize && !(cachesize= my_default_record_cache_size))
     DBUG_RETURN(1);				/* No cache requested */
@@ -290,6 +412,8 @@ int init_io_cache_ext(IO_CACHE *info, File file, size_t cachesize,
   info->end_of_file= end_of_file;
   info->error=0;
   info->type= type;
+  if (type == READ_CACHE)
+    io_cache_aio_init(info);
   init_functions(info);
   DBUG_RETURN(0);
 }
@@ -327,6 +451,8 @@ int init_slave_io_cache(IO_CACHE *master, IO_CACHE *slave)
   }
   memcpy(slave, master, sizeof(IO_CACHE));
   slave->buffer= slave_buf;
+  slave->aio= 0;
+  slave->read_function= _my_b_cache_read;
 
   memcpy(slave->buffer, master->buffer, master->alloced_buffer);
   slave->read_pos= slave->buffer + (master->read_pos - master->buffer);
@@ -427,6 +553,15 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   DBUG_ASSERT(type == READ_CACHE || type == WRITE_CACHE);
   DBUG_ASSERT(info->type == READ_CACHE || info->type == WRITE_CACHE);
 
+  /* The file may change before the next read, drop any read-ahead */
+  if (info->aio)
+  {
+    if (type == READ_CACHE)
+      io_cache_aio_wait(info->aio);
+    else
+      io_cache_aio_end(info);
+  }
+
   /* If the whole file is in memory, avoid flushing to disk */
   if (! clear_cache &&
       seek_offset >= info->pos_in_file &&
@@ -511,6 +646,8 @@ my_bool reinit_io_cache(IO_CACHE *info, enum cache_type type,
   }
   info->type=type;
   info->error=0;
+  if (type == READ_CACHE)
+    io_cache_aio_init(info);
   init_functions(info);
   DBUG_RETURN(0);
 } /* reinit_io_cache */
@@ -775,6 +912,85 @@ int _my_b_cache_read(IO_CACHE *info, uchar *Buffer, size_t Count)
 }
 
 
+/*
+  Read buffered, with read-ahead of the next buffer.
+
+  SYNOPSIS
+    _my_b_cache_read_async()
+      info                      IO_CACHE pointer
+      Buffer                    Buffer to retrieve count bytes from file
+      Count                     Number of bytes to read into Buffer
+
+  NOTE
+    If the read-ahead started by the previous call has read the data that
+    follows the cache buffer, the buffers are swapped, and the next
+    read-ahead is started before the data is returned. So a sequential
+    reader only waits for the disk if it is faster than the disk.
+    Otherwise, e.g. after a seek, we read with _my_b_cache_read().
+
+    The read-ahead reads with pread() and does not move the file position,
+    so the next synchronous read has to seek.
+
+  RETURN
+    0      we succeeded in reading all data
+    1      Error: couldn't read requested characters. In this case:
+             If info->error == -1, we got a read error.
+             Otherwise info->error contains the number of bytes in Buffer.
+*/
+
+static int _my_b_cache_read_async(IO_CACHE *info, uchar *Buffer, size_t Count)
+{
+  IO_CACHE_AIO *aio= info->aio;
+  my_off_t pos_in_file;
+  size_t left_length= 0;
+  DBUG_ENTER("_my_b_cache_read_async");
+
+  pos_in_file=info->pos_in_file+ (size_t) (info->read_end - info->buffer);
+
+  if (aio->started)
+  {
+    io_cache_aio_wait(aio);
+    if (aio->pos_in_file == pos_in_file && pos_in_file < info->end_of_file &&
+        aio->read_length && aio->read_length != (size_t) -1)
+    {
+      /* end_of_file may have been lowered after the read was started */
+      size_t length= (size_t) MY_MIN(aio->read_length,
+                                     info->end_of_file - pos_in_file);
+      uchar *buffer= info->buffer;
+      info->buffer= info->request_pos= aio->buffer;
+      info->write_buffer= info->buffer;
+      aio->buffer= buffer;
+
+      info->pos_in_file= pos_in_file;
+      info->read_pos= info->buffer;
+      info->read_end= info->buffer + length;
+      info->seek_not_done= 1;
+      if (Count <= length)
+      {
+        memcpy(Buffer, info->buffer, Count);
+        info->read_pos+= Count;
+        io_cache_aio_start(info);
+        DBUG_RETURN(0);
+      }
+      memcpy(Buffer, info->buffer, length);
+      Buffer+= length;
+      Count-= length;
+      left_length= length;
+      info->read_pos= info->read_end;
+    }
+  }
+
+  if (_my_b_cache_read(info, Buffer, Count))
+  {
+    if (info->error >= 0)
+      info->error+= (int) left_length;
+    DBUG_RETURN(1);
+  }
+  io_cache_aio_start(info);
+  DBUG_RETURN(0);
+}
+
+
 /*
   Prepare IO_CACHE for shared use.
 
@@ -870,6 +1086,8 @@ void init_io_cache_share(IO_CACHE *read_cache, IO_CACHE_SHARE *cshare,
   cshare->source_cache=    write_cache; /* Can be NULL. */
 
   read_cache->share=         cshare;
+  /* The threads share one buffer, no read-ahead */
+  io_cache_aio_end(read_cache);
   read_cache->read_function= _my_b_cache_read_r;
 
   if (write_cache)
@@ -1774,6 +1992,7 @@ int end_io_cache(IO_CACHE *info)
 
   if (info->alloced_buffer)
   {
+    io_cache_aio_end(info);
     info->alloced_buffer=0;
     if (info->file != -1)			/* File doesn't exist */
       error= my_b_flush_io_cache(info,1);
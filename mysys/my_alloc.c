@@ -33,6 +33,12 @@
 /* Don't allocate too small blocks */
 #define ROOT_MIN_BLOCK_SIZE 256
 
+/*
+  Block sizes double every 4 blocks up to this size (or the block size of
+  the root, if that is bigger); after that they grow linearly
+*/
+#define ROOT_MAX_GROWN_BLOCK_SIZE (1024*1024)
+
 /* bits in MEM_ROOT->flags */
 #define ROOT_FLAG_THREAD_SPECIFIC 1
 #define ROOT_FLAG_MPROTECT        2
@@ -164,6 +170,8 @@ void init_alloc_root(PSI_memory_key key, MEM_ROOT *mem_root, size_t block_size,
   mem_root->error_handler= 0;
   mem_root->block_num= 4;			/* We shift this with >>2 */
   mem_root->first_block_usage= 0;
+  mem_root->keep_limit= mem_root->high_water= 0;
+  mem_root->blocks_allocated= mem_root->blocks_reused= 0;
   mem_root->psi_key= key;
 
 #if !(defined(HAVE_valgrind) && defined(EXTRA_DEBUG))
@@ -177,6 +185,7 @@ void init_alloc_root(PSI_memory_key key, MEM_ROOT *mem_root, size_t block_size,
       mem_root->free->size= alloced_size;
       mem_root->free->left= alloced_size - ALIGN_SIZE(sizeof(USED_MEM));
       mem_root->free->next= 0;
+      mem_root->blocks_allocated++;
       TRASH_MEM(mem_root->free);
     }
   }
@@ -247,6 +256,7 @@ void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
         mem->left= alloced_size - ALIGN_SIZE(sizeof(USED_MEM));
         mem->next= *prev;
         *prev= mem_root->pre_alloc= mem;
+        mem_root->blocks_allocated++;
         TRASH_MEM(mem);
       }
       else
@@ -324,8 +334,16 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
     size_t alloced_length;
 
     /* Increase block size over time if there is a lot of mallocs */
-    block_size= (MY_ALIGN(mem_root->block_size, ROOT_MIN_BLOCK_SIZE) *
-                 (mem_root->block_num >> 2)- MALLOC_OVERHEAD);
+    block_size= MY_ALIGN(mem_root->block_size, ROOT_MIN_BLOCK_SIZE);
+    if (block_size < ROOT_MAX_GROWN_BLOCK_SIZE)
+    {
+      uint shift= MY_MIN((mem_root->block_num >> 2) - 1, 12);
+      get_size= MY_MIN(block_size << shift, ROOT_MAX_GROWN_BLOCK_SIZE);
+    }
+    else
+      get_size= block_size;
+    block_size= MY_MAX(block_size * (mem_root->block_num >> 2), get_size) -
+                MALLOC_OVERHEAD;
     get_size= length + ALIGN_SIZE(sizeof(USED_MEM));
     get_size= MY_MAX(get_size, block_size);
 
@@ -337,6 +355,7 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
       DBUG_RETURN((void*) 0);                      /* purecov: inspected */
     }
     mem_root->block_num++;
+    mem_root->blocks_allocated++;
     next->next= *prev;
     next->size= alloced_length;
     next->left= alloced_length - ALIGN_SIZE(sizeof(USED_MEM));
@@ -446,6 +465,72 @@ static inline void mark_blocks_free(MEM_ROOT* root)
   root->first_block_usage= 0;
   root->block_num= 4;
 }
+
+
+/*
+  Free the blocks of a root, except the preallocated block and other
+  blocks that cover the memory which the root has recently used, up to
+  keep_limit bytes in total. These will serve the next allocations
+  without malloc.
+
+  The recent usage is the maximum of the memory used at each call,
+  decaying by 1/8 per call, so that the kept memory shrinks again after
+  a peak.
+*/
+
+static void keep_blocks(MEM_ROOT *root)
+{
+  USED_MEM *next, *old, *keep_list= 0, **last= &keep_list;
+  USED_MEM *lists[2];
+  size_t used= 0, kept= 0, keep, n_kept= 0;
+  uint i;
+
+  lists[0]= root->used;
+  lists[1]= root->free;
+  for (i= 0; i < 2; i++)
+    for (next= lists[i]; next; next= next->next)
+      used+= next->size - next->left;
+  root->high_water= MY_MAX(used, root->high_water - root->high_water / 8);
+  keep= MY_MIN(root->high_water, root->keep_limit);
+
+  if (root->pre_alloc)
+    kept= root->pre_alloc->size;
+  for (i= 0; i < 2; i++)
+  {
+    for (next= lists[i]; next;)
+    {
+      old= next; next= next->next;
+      if (old == root->pre_alloc)
+        continue;
+      if (kept >= keep || kept + old->size > root->keep_limit)
+      {
+        root_free(root, old, old->size);
+        continue;
+      }
+      kept+= old->size;
+      n_kept++;
+      *last= old;
+      last= &old->next;
+    }
+  }
+  *last= 0;
+  if (root->pre_alloc)
+  {
+    root->pre_alloc->next= keep_list;
+    keep_list= root->pre_alloc;
+  }
+  root->free= keep_list;
+
+  for (next= root->free; next; next= next->next)
+  {
+    next->left= next->size - ALIGN_SIZE(sizeof(USED_MEM));
+    TRASH_MEM(next);
+  }
+  root->used= 0;
+  root->block_num= 4 + (uint) n_kept;
+  root->first_block_usage= 0;
+  root->blocks_reused+= n_kept;
+}
 #endif
 
 
@@ -487,6 +572,13 @@ void free_root(MEM_ROOT *root, myf MyFlags)
 #endif
   if (!(MyFlags & MY_KEEP_PREALLOC))
     root->pre_alloc=0;
+#if !(defined(HAVE_valgrind) && defined(EXTRA_DEBUG))
+  else if (root->keep_limit)
+  {
+    keep_blocks(root);
+    DBUG_VOID_RETURN;
+  }
+#endif
 
   for (next=root->used; next ;)
   {
@@ -514,6 +606,18 @@ void free_root(MEM_ROOT *root, myf MyFlags)
 }
 
 
+/*
+  Set how much memory free_root(MY_KEEP_PREALLOC) may keep for reuse,
+  including the preallocated block. This is meant for roots that are
+  freed after each use, like the one for executing statements.
+*/
+
+void set_root_keep_limit(MEM_ROOT *root, size_t keep_limit)
+{
+  root->keep_limit= keep_limit;
+}
+
+
 /*
   Find block that contains an object and set the pre_alloc to it
 */
@@ -442,7 +442,7 @@ PSI_mutex_key key_LOCK_localtime_r;
 #endif /* !defined(HAVE_LOCALTIME_R) || !defined(HAVE_GMTIME_R) */
 
 PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
-  key_IO_CACHE_SHARE_mutex, key_KEY_CACHE_cache_lock,
+  key_IO_CACHE_SHARE_mutex, key_IO_CACHE_AIO_mutex, key_KEY_CACHE_cache_lock,
   key_LOCK_alarm, key_LOCK_timer,
   key_my_thread_var_mutex, key_THR_LOCK_charset, key_THR_LOCK_heap,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
@@ -461,6 +461,7 @@ static PSI_mutex_info all_mysys_mutexes[]=
   { &key_BITMAP_mutex, "BITMAP::mutex", 0},
   { &key_IO_CACHE_append_buffer_lock, "IO_CACHE::append_buffer_lock", 0},
   { &key_IO_CACHE_SHARE_mutex, "IO_CACHE::SHARE_mutex", 0},
+  { &key_IO_CACHE_AIO_mutex, "IO_CACHE_AIO::mutex", 0},
   { &key_KEY_CACHE_cache_lock, "KEY_CACHE::cache_lock", 0},
   { &key_LOCK_alarm, "LOCK_alarm", PSI_FLAG_GLOBAL},
   { &key_LOCK_timer, "LOCK_timer", PSI_FLAG_GLOBAL},
@@ -480,7 +481,7 @@ static PSI_mutex_info all_mysys_mutexes[]=
 };
 
 PSI_cond_key key_COND_alarm, key_COND_timer, key_IO_CACHE_SHARE_cond,
-  key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
+  key_IO_CACHE_SHARE_cond_writer, key_IO_CACHE_AIO_cond, key_my_thread_var_suspend,
   key_THR_COND_threads, key_WT_RESOURCE_cond;
 
 static PSI_cond_info all_mysys_conds[]=
@@ -489,6 +490,7 @@ static PSI_cond_info all_mysys_conds[]=
   { &key_COND_timer, "COND_timer", PSI_FLAG_GLOBAL},
   { &key_IO_CACHE_SHARE_cond, "IO_CACHE_SHARE::cond", 0},
   { &key_IO_CACHE_SHARE_cond_writer, "IO_CACHE_SHARE::cond_writer", 0},
+  { &key_IO_CACHE_AIO_cond, "IO_CACHE_AIO::cond", 0},
   { &key_my_thread_var_suspend, "my_thread_var::suspend", 0},
   { &key_THR_COND_threads, "THR_COND_threads", PSI_FLAG_GLOBAL},
   { &key_WT_RESOURCE_cond, "WT_RESOURCE::cond", 0}
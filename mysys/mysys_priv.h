@@ -43,7 +43,7 @@ extern PSI_mutex_key key_LOCK_localtime_r;
 #endif /* !defined(HAVE_LOCALTIME_R) || !defined(HAVE_GMTIME_R) */
 
 extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
-  key_IO_CACHE_SHARE_mutex, key_KEY_CACHE_cache_lock, key_LOCK_alarm,
+  key_IO_CACHE_SHARE_mutex, key_IO_CACHE_AIO_mutex, key_KEY_CACHE_cache_lock, key_LOCK_alarm,
   key_my_thread_var_mutex, key_THR_LOCK_charset, key_THR_LOCK_heap,
   key_THR_LOCK_lock, key_THR_LOCK_malloc,
   key_THR_LOCK_mutex, key_THR_LOCK_myisam, key_THR_LOCK_net,
@@ -51,7 +51,7 @@ extern PSI_mutex_key key_BITMAP_mutex, key_IO_CACHE_append_buffer_lock,
   key_TMPDIR_mutex, key_THR_LOCK_myisam_mmap, key_LOCK_timer;
 
 extern PSI_cond_key key_COND_alarm, key_COND_timer, key_IO_CACHE_SHARE_cond,
-  key_IO_CACHE_SHARE_cond_writer, key_my_thread_var_suspend,
+  key_IO_CACHE_SHARE_cond_writer, key_IO_CACHE_AIO_cond, key_my_thread_var_suspend,
   key_THR_COND_threads;
 
 #ifdef USE_ALARM_THREAD
@@ -116,6 +116,28 @@ typedef struct {
 extern int (*_my_b_encr_read)(IO_CACHE *info,uchar *Buffer,size_t Count);
 extern int (*_my_b_encr_write)(IO_CACHE *info,const uchar *Buffer,size_t Count);
 
+/*
+  Read-ahead of the next buffer of a READ_CACHE that was initialized with
+  MY_READ_AHEAD. The read is done by _my_b_aio_read(), which must call
+  my_b_aio_read_done() when it has completed.
+*/
+typedef struct st_io_cache_aio
+{
+  mysql_mutex_t mutex;
+  mysql_cond_t cond;
+  uchar *buffer;                        /* The read-ahead buffer */
+  my_off_t pos_in_file;                 /* Where buffer is read from */
+  size_t length;                        /* Number of bytes requested */
+  size_t read_length;                   /* Bytes read, or (size_t) -1 */
+  int error;                            /* errno of a failed read */
+  File file;
+  my_bool pending;                      /* The read has not completed */
+  my_bool started;                      /* A read was submitted */
+} IO_CACHE_AIO;
+
+extern int (*_my_b_aio_read)(IO_CACHE_AIO *aio);
+extern void my_b_aio_read_done(IO_CACHE_AIO *aio, size_t length, int error);
+
 #ifdef SAFEMALLOC
 void *sf_malloc(size_t size, myf my_flags);
 void *sf_realloc(void *ptr, size_t size, myf my_flags);
@@ -1027,6 +1027,13 @@ class Field: public Value_source
   }
   virtual bool val_bool()= 0;
   virtual my_decimal *val_decimal(my_decimal *)=0;
+  /*
+    Get the value as an integer scaled by 10^scale, for DECIMAL arithmetic
+    without my_decimal. Returns true if the value cannot be read this way,
+    then val_decimal() must be used.
+  */
+  virtual bool val_decimal_scaled(longlong *to, decimal_digits_t scale)
+  { return true; }
   inline String *val_str(String *str) { return val_str(str, str); }
   /*
      val_str(buf1, buf2) gets two buffers and should use them as follows:
@@ -2413,6 +2420,11 @@ class Field_new_decimal final :public Field_num {
     return (ulonglong) my_decimal(ptr, precision, dec).to_longlong(true);
   }
   my_decimal *val_decimal(my_decimal *) override;
+  bool val_decimal_scaled(longlong *to, decimal_digits_t scale) override
+  {
+    return scale != dec || precision > DECIMAL_SCALED_LONGLONG_DIGITS ||
+           bin2longlong_scaled(ptr, precision, dec, to) != E_DEC_OK;
+  }
   String *val_str(String *val_buffer, String *) override
   {
     uint fixed_precision= zerofill ? precision : 0;
@@ -2477,6 +2489,11 @@ class Field_int :public Field_num
   }
   int store_decimal(const my_decimal *) override;
   my_decimal *val_decimal(my_decimal *) override;
+  bool val_decimal_scaled(longlong *to, decimal_digits_t scale) override
+  {
+    /* UNSIGNED BIGINT values above LONGLONG_MAX do not fit */
+    return scale || ((*to= val_int()) < 0 && unsigned_flag);
+  }
   bool val_bool() override { return val_int() != 0; }
   ulonglong val_uint() override
   {
@@ -400,7 +400,7 @@ SORT_INFO *filesort(THD *thd, TABLE *table, Filesort *filesort,
 	/* Open cached file if it isn't open */
     if (! my_b_inited(outfile) &&
 	open_cached_file(outfile,mysql_tmpdir,TEMP_PREFIX,READ_RECORD_BUFFER,
-			  MYF(MY_WME)))
+			  MYF(MY_WME | MY_READ_AHEAD)))
       goto err;
     if (reinit_io_cache(outfile,WRITE_CACHE,0L,0,0))
       goto err;
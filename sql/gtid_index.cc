@@ -0,0 +1,289 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "unireg.h"
+#include "mysqld.h"
+#include "gtid_index.h"
+
+/*
+  File format, all numbers little-endian:
+
+    header:  5 bytes magic and version
+    entry:   4 bytes length of the payload
+             payload:
+               8 bytes offset of the Gtid_log_event in the binlog file
+               4 bytes number of GTIDs
+               for each GTID 4 bytes domain_id, 4 bytes server_id,
+               8 bytes seq_no
+             4 bytes checksum of the payload
+
+  Entries are only ever appended, with increasing offsets.
+*/
+
+static const uchar gtid_index_magic[]= { 0xfe, 'G', 'I', 'X', 1 };
+#define GTID_INDEX_HEADER_LEN sizeof(gtid_index_magic)
+#define GTID_INDEX_ENTRY_HEADER_LEN 12
+#define GTID_INDEX_GTID_LEN 16
+
+
+static void gtid_index_name(char *buf, const char *binlog_name)
+{
+  strxnmov(buf, FN_REFLEN - 1, binlog_name, GTID_INDEX_EXT, NullS);
+}
+
+
+/*
+  Start the index of a binlog file.
+
+  The binlog writer creates the index together with the binlog file. When
+  a dump thread rebuilds a missing index while it reads the binlog file,
+  the index is written to a temporary file that is renamed when the whole
+  binlog file was read. If another thread is already rebuilding the same
+  index, nothing is done.
+
+  @retval false  ok
+  @retval true   the index could not be created
+*/
+
+bool Gtid_index_writer::open(const char *binlog_name, my_off_t span_arg,
+                             bool rebuild)
+{
+  DBUG_ASSERT(!is_open());
+  gtid_index_name(name, binlog_name);
+  strxnmov(tmp_name, FN_REFLEN - 1, name, ".tmp", NullS);
+  rebuilding= rebuild;
+  if ((file= mysql_file_create(key_file_binlog_gtid_index,
+                               rebuild ? tmp_name : name, 0,
+                               O_WRONLY | O_TRUNC | O_BINARY |
+                               (rebuild ? O_EXCL : 0),
+                               MYF(0))) < 0)
+    return true;
+  if (mysql_file_write(file, gtid_index_magic, GTID_INDEX_HEADER_LEN,
+                       MYF(MY_NABP)))
+  {
+    discard();
+    return true;
+  }
+  span= span_arg;
+  last_offset= BIN_LOG_HEADER_SIZE;
+  state.clear();
+  return false;
+}
+
+
+/*
+  Note the Gtid_log_event at the given offset of the binlog file.
+
+  Must be called for every Gtid_log_event of the binlog file, in order.
+*/
+
+void Gtid_index_writer::process_gtid(my_off_t offset, const rpl_gtid *gtid)
+{
+  size_t i;
+
+  if (!is_open())
+    return;
+
+  if (offset >= last_offset + span && state.elements() &&
+      write_entry(offset))
+  {
+    /* Better no index than one with holes */
+    discard();
+    return;
+  }
+
+  for (i= 0; i < state.elements(); i++)
+  {
+    rpl_gtid *elem= &state.at(i);
+    if (elem->domain_id == gtid->domain_id &&
+        elem->server_id == gtid->server_id)
+    {
+      if (elem->seq_no < gtid->seq_no)
+        elem->seq_no= gtid->seq_no;
+      return;
+    }
+  }
+  if (state.append(*gtid))
+    discard();
+}
+
+
+bool Gtid_index_writer::write_entry(my_off_t offset)
+{
+  size_t count= state.elements();
+  size_t length= GTID_INDEX_ENTRY_HEADER_LEN + count * GTID_INDEX_GTID_LEN;
+  uchar *p;
+
+  if (record.alloc(length + 8))
+    return true;
+  p= (uchar*) record.ptr();
+  int4store(p, (uint32) length);
+  int8store(p + 4, offset);
+  int4store(p + 12, (uint32) count);
+  p+= 4 + GTID_INDEX_ENTRY_HEADER_LEN;
+  for (size_t i= 0; i < count; i++, p+= GTID_INDEX_GTID_LEN)
+  {
+    const rpl_gtid *elem= &state.at(i);
+    int4store(p, elem->domain_id);
+    int4store(p + 4, elem->server_id);
+    int8store(p + 8, elem->seq_no);
+  }
+  int4store(p, my_checksum(0, record.ptr() + 4, length));
+  if (mysql_file_write(file, (uchar*) record.ptr(), length + 8,
+                       MYF(MY_NABP)))
+    return true;
+  last_offset= offset;
+  return false;
+}
+
+
+/* Finish the index, when the whole binlog file was processed */
+
+void Gtid_index_writer::close()
+{
+  if (!is_open())
+    return;
+  mysql_file_close(file, MYF(0));
+  file= -1;
+  if (rebuilding &&
+      mysql_file_rename(key_file_binlog_gtid_index, tmp_name, name, MYF(0)))
+    mysql_file_delete(key_file_binlog_gtid_index, tmp_name, MYF(0));
+}
+
+
+/* Remove an unfinished index */
+
+void Gtid_index_writer::discard()
+{
+  if (!is_open())
+    return;
+  mysql_file_close(file, MYF(0));
+  file= -1;
+  mysql_file_delete(key_file_binlog_gtid_index,
+                    rebuilding ? tmp_name : name, MYF(0));
+}
+
+
+bool gtid_index_exists(const char *binlog_name)
+{
+  char buf[FN_REFLEN];
+  gtid_index_name(buf, binlog_name);
+  return !my_access(buf, F_OK);
+}
+
+
+/*
+  Check that a dump thread starting at slave position state would skip
+  every event group before an index entry.
+*/
+
+static bool gtid_index_entry_usable(const uchar *p, uint32 count,
+                                    slave_connection_state *state)
+{
+  for (; count; count--, p+= GTID_INDEX_GTID_LEN)
+  {
+    uint32 domain_id= uint4korr(p);
+    uint32 server_id= uint4korr(p + 4);
+    uint64 seq_no= uint8korr(p + 8);
+    slave_connection_state::entry *entry= state->find_entry(domain_id);
+
+    /* Domains the slave has no position in are sent from the start */
+    if (!entry || (entry->flags & slave_connection_state::START_ON_EMPTY_DOMAIN))
+      return false;
+    /* The slave position would be reached before the entry */
+    if (entry->gtid.server_id == server_id && seq_no >= entry->gtid.seq_no)
+      return false;
+  }
+  return true;
+}
+
+
+/*
+  Find the offset in a binlog file at which a dump thread with the given
+  slave position can start reading, without missing any event group that
+  it would send to the slave.
+
+  Only offsets up to max_offset are considered.
+
+  @return The offset of a Gtid_log_event, or 0 when the binlog file must be
+          read from its start.
+*/
+
+my_off_t gtid_index_find_start(const char *binlog_name,
+                               slave_connection_state *state,
+                               my_off_t max_offset)
+{
+  char buf[FN_REFLEN];
+  File file;
+  MY_STAT stat;
+  uchar *data= NULL;
+  my_off_t start= 0;
+
+  gtid_index_name(buf, binlog_name);
+  if ((file= mysql_file_open(key_file_binlog_gtid_index, buf,
+                             O_RDONLY | O_BINARY, MYF(0))) < 0)
+    return 0;
+  if (my_fstat(file, &stat, MYF(0)) ||
+      (size_t) stat.st_size < GTID_INDEX_HEADER_LEN ||
+      !(data= (uchar*) my_malloc(PSI_INSTRUMENT_ME, (size_t) stat.st_size,
+                                 MYF(0))) ||
+      mysql_file_read(file, data, (size_t) stat.st_size, MYF(MY_NABP)) ||
+      memcmp(data, gtid_index_magic, GTID_INDEX_HEADER_LEN))
+    goto end;
+
+  {
+    const uchar *p= data + GTID_INDEX_HEADER_LEN;
+    const uchar *end= data + stat.st_size;
+
+    /* Entries are cumulative, so stop at the first one that can't be used */
+    while (end - p >= 8)
+    {
+      size_t length= uint4korr(p);
+      if (length < GTID_INDEX_ENTRY_HEADER_LEN ||
+          (size_t) (end - p) < length + 8 ||
+          my_checksum(0, p + 4, length) != uint4korr(p + 4 + length))
+        break;                                  /* Truncated or corrupt */
+      my_off_t offset= uint8korr(p + 4);
+      uint32 count= uint4korr(p + 12);
+      if (length != GTID_INDEX_ENTRY_HEADER_LEN +
+                    (size_t) count * GTID_INDEX_GTID_LEN ||
+          offset > max_offset ||
+          !gtid_index_entry_usable(p + 4 + GTID_INDEX_ENTRY_HEADER_LEN,
+                                   count, state))
+        break;
+      start= offset;
+      p+= length + 8;
+    }
+  }
+
+end:
+  my_free(data);
+  mysql_file_close(file, MYF(0));
+  return start;
+}
+
+
+/* Delete the index of a binlog file, if there is one */
+
+void gtid_index_delete(const char *binlog_name)
+{
+  char buf[FN_REFLEN];
+  gtid_index_name(buf, binlog_name);
+  mysql_file_delete(key_file_binlog_gtid_index, buf, MYF(0));
+  strxnmov(buf + strlen(buf), FN_REFLEN - 1 - strlen(buf), ".tmp", NullS);
+  mysql_file_delete(key_file_binlog_gtid_index, buf, MYF(0));
+}
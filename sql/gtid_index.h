@@ -0,0 +1,87 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#ifndef GTID_INDEX_H
+#define GTID_INDEX_H
+
+#include "rpl_gtid.h"
+#include "sql_array.h"
+#include "sql_string.h"
+
+/*
+  Sparse GTID index of a binlog file.
+
+  The index is a sidecar file <binlog name>.idx next to the binlog file.
+  Every binlog_gtid_index_span bytes of binlog, at the start of an event
+  group, it records the offset of the Gtid_log_event together with the
+  highest seq_no of every (domain_id, server_id) logged in the binlog file
+  before that offset.
+
+  A dump thread that starts at a GTID position can then seek to the last
+  recorded offset before which it would skip every event group anyway,
+  instead of reading the binlog file from its start. Offsets are the
+  positions in the binlog file as written, so the index works the same for
+  encrypted and compressed binlogs.
+
+  The index is only a hint: it is not synced, a truncated or corrupt tail
+  is ignored, and the event at the chosen offset is checked before it is
+  used.
+*/
+
+#define GTID_INDEX_EXT ".idx"
+
+class Gtid_index_writer
+{
+public:
+  Gtid_index_writer()
+    : file(-1), span(0), last_offset(0), state(PSI_INSTRUMENT_MEM),
+      rebuilding(false)
+  {}
+  ~Gtid_index_writer()
+  {
+    if (rebuilding)
+      discard();
+    else
+      close();
+  }
+
+  bool open(const char *binlog_name, my_off_t span_arg, bool rebuild);
+  bool is_open() const { return file >= 0; }
+  void process_gtid(my_off_t offset, const rpl_gtid *gtid);
+  void close();
+  void discard();
+
+private:
+  bool write_entry(my_off_t offset);
+
+  File file;
+  my_off_t span;
+  my_off_t last_offset;
+  /* Highest seq_no of each (domain_id, server_id) so far in the file */
+  Dynamic_array<rpl_gtid> state;
+  String record;
+  /* Set when rebuilding: the index is written to a temporary file */
+  bool rebuilding;
+  char name[FN_REFLEN];
+  char tmp_name[FN_REFLEN];
+};
+
+bool gtid_index_exists(const char *binlog_name);
+my_off_t gtid_index_find_start(const char *binlog_name,
+                               slave_connection_state *state,
+                               my_off_t max_offset);
+void gtid_index_delete(const char *binlog_name);
+
+#endif /* GTID_INDEX_H */
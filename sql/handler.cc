@@ -1807,6 +1807,14 @@ int ha_commit_trans(THD *thd, bool all)
   need_prepare_ordered= FALSE;
   need_commit_ordered= FALSE;
 
+  /*
+    With binlog_single_sync_commit the engines need not make the prepare
+    durable, the binlog group commit does it together with the binlog sync.
+  */
+  if (is_real_trans && opt_binlog_single_sync_commit &&
+      tc_log == &mysql_bin_log)
+    thd->durability_property= HA_IGNORE_DURABILITY;
+
   for (Ha_trx_info *hi= ha_info; hi; hi= hi->next())
   {
     handlerton *ht= hi->ht();
@@ -1822,11 +1830,15 @@ int ha_commit_trans(THD *thd, bool all)
       trans->no_2pc would have been set.
     */
     if (unlikely(prepare_or_error(ht, thd, all)))
+    {
+      thd->durability_property= HA_REGULAR_DURABILITY;
       goto err;
+    }
 
     need_prepare_ordered|= (ht->prepare_ordered != NULL);
     need_commit_ordered|= (ht->commit_ordered != NULL);
   }
+  thd->durability_property= HA_REGULAR_DURABILITY;
   DEBUG_SYNC(thd, "ha_commit_trans_after_prepare");
   DBUG_EXECUTE_IF("crash_commit_after_prepare", DBUG_SUICIDE(););
 
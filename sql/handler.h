@@ -1467,6 +1467,25 @@ struct handlerton
      recovery process.
    */
    void (*commit_checkpoint_request)(void *cookie);
+   /*
+     The recovered_binlog_pos() handlerton method is used by
+     binlog_single_sync_commit. When that is enabled, prepare() may skip
+     the durable flush if the thread's durability property is
+     HA_IGNORE_DURABILITY. The binlog group commit then calls
+     flush_logs() while it syncs the binlog, so that the prepare is made
+     durable before the transaction is committed or acknowledged.
+
+     After a crash, the binlog may then contain transactions whose prepare
+     was lost. At XA recovery the engine reports the binlog file name and
+     the end offset of the last transaction whose commit was durably
+     recorded, as found at startup; anything later that is not found
+     prepared was lost and is removed from the binlog.
+
+     The method is optional. Returns false on success, true if the engine
+     has no recorded binlog position.
+   */
+   bool (*recovered_binlog_pos)(handlerton *hton, char *file_name,
+                                ulonglong *pos);
   /*
     "Disable or enable checkpointing internal to the storage engine. This is
     used for FLUSH TABLES WITH READ LOCK AND DISABLE CHECKPOINT to ensure that
@@ -1675,6 +1675,17 @@ class Item :public Value_source,
         to TRUE.
   */
   virtual my_decimal *val_decimal(my_decimal *decimal_buffer)= 0;
+  /*
+    Return the value as an integer scaled by 10^scale, when it can be had
+    without a my_decimal, see Field::val_decimal_scaled().
+
+    RETURN
+      FALSE  *to is set, or the value is NULL (null_value is set)
+      TRUE   the value must be read with val_decimal(). Nothing with
+             side effects has been evaluated.
+  */
+  virtual bool val_decimal_scaled(longlong *to, decimal_digits_t scale)
+  { return true; }
   /*
     Return boolean value of item.
 
@@ -3556,6 +3567,12 @@ class Item_field :public Item_ident,
   double val_real() override;
   longlong val_int() override;
   my_decimal *val_decimal(my_decimal *) override;
+  bool val_decimal_scaled(longlong *to, decimal_digits_t scale) override
+  {
+    if ((null_value= field->is_null()))
+      return false;
+    return field->val_decimal_scaled(to, scale);
+  }
   String *val_str(String*) override;
   void save_result(Field *to) override;
   double val_result() override;
@@ -4379,6 +4396,11 @@ class Item_int :public Item_num
   longlong val_int_min() const override { return value; }
   double val_real() override { return (double) value; }
   my_decimal *val_decimal(my_decimal *) override;
+  bool val_decimal_scaled(longlong *to, decimal_digits_t scale) override
+  {
+    *to= value;
+    return scale || (value < 0 && unsigned_flag);
+  }
   String *val_str(String*) override;
   int save_in_field(Field *field, bool no_conversions) override;
   bool is_order_clause_position() const override { return true; }
@@ -4497,6 +4519,8 @@ class Item_decimal :public Item_num
   { return decimal_value.to_string(to); }
   my_decimal *val_decimal(my_decimal *val) override
   { return &decimal_value; }
+  bool val_decimal_scaled(longlong *to, decimal_digits_t scale) override
+  { return decimal2longlong_scaled(&decimal_value, scale, to) != E_DEC_OK; }
   const my_decimal *const_ptr_my_decimal() const override
   { return &decimal_value; }
   int save_in_field(Field *field, bool no_conversions) override;
@@ -6636,6 +6660,8 @@ class Item_default_value : public Item_field
   double val_real() override;
   longlong val_int() override;
   my_decimal *val_decimal(my_decimal *decimal_value) override;
+  bool val_decimal_scaled(longlong *to, decimal_digits_t scale) override
+  { return true; }
   bool get_date(THD *thd, MYSQL_TIME *ltime,date_mode_t fuzzydate) override;
   bool val_native(THD *thd, Native *to) override;
   bool val_native_result(THD *thd, Native *to) override;
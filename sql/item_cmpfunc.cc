@@ -846,8 +846,53 @@ int Arg_comparator::compare_real()
   return -1;
 }
 
+/*
+  Compare two DECIMAL values that fit in a longlong, see
+  Item::val_decimal_scaled().
+
+  RETURN
+    FALSE  *cmp is set, or *is_null if one of the values is NULL
+    TRUE   the values must be compared as my_decimal
+*/
+static bool cmp_decimal_scaled(Item *a, Item *b, int *cmp, bool *is_null)
+{
+  longlong val1, val2;
+  if (a->val_decimal_scaled(&val1, a->decimals))
+    return true;
+  if ((*is_null= a->null_value))
+    return false;
+  if (b->val_decimal_scaled(&val2, b->decimals))
+    return true;
+  if ((*is_null= b->null_value))
+    return false;
+  /* Bring both to the larger scale */
+  for (uint i= a->decimals; i < b->decimals; i++)
+  {
+    if (val1 > LONGLONG_MAX / 10 || val1 < LONGLONG_MIN / 10)
+      return true;
+    val1*= 10;
+  }
+  for (uint i= b->decimals; i < a->decimals; i++)
+  {
+    if (val2 > LONGLONG_MAX / 10 || val2 < LONGLONG_MIN / 10)
+      return true;
+    val2*= 10;
+  }
+  *cmp= val1 < val2 ? -1 : val1 > val2;
+  return false;
+}
+
+
 int Arg_comparator::compare_decimal()
 {
+  int cmp;
+  bool is_null;
+  if (!cmp_decimal_scaled(*a, *b, &cmp, &is_null))
+  {
+    if (set_null)
+      owner->null_value= is_null;
+    return is_null ? -1 : cmp;
+  }
   VDec val1(*a);
   if (!val1.is_null())
   {
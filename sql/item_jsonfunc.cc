@@ -383,6 +383,196 @@ static int path_setup_nwc(json_path_t *p, CHARSET_INFO *i_cs,
 }
 
 
+/*
+  Index of the members of the top-level object of a JSON document.
+
+  A path starting with a key, like '$.a.b', is searched for by scanning
+  the members of the top-level object one after another. A statement
+  calling several JSON functions on the same document, like a few
+  JSON_VALUE() on one column, scans the document again in every call.
+  The index remembers where the members start, so that the search can
+  go straight to the member with the key. The engine is left in exactly
+  the state the scan would have left it in, so neither the results nor
+  the errors change.
+
+  The indexes of the last documents searched are kept in
+  THD::json_key_indexes until the end of the statement. A document is
+  only indexed when it is searched for the second time. It is recognized
+  by its contents, so the cache never has to be invalidated.
+*/
+
+static const size_t JSON_KEY_INDEX_MIN_LENGTH= 256;
+static const size_t JSON_KEY_INDEX_MAX_LENGTH= 256 * 1024;
+
+class Json_key_index
+{
+  String doc;                   /* Copy of the document */
+  bool built;
+  json_engine_t first_key;      /* The engine at the first member */
+  Dynamic_array<uint> keys;     /* Offsets of the members in doc */
+
+public:
+  Json_key_index() :built(false), keys(PSI_INSTRUMENT_MEM) {}
+  bool matches(const String *js) const
+  {
+    return doc.length() == js->length() && doc.charset() == js->charset() &&
+           !memcmp(doc.ptr(), js->ptr(), js->length());
+  }
+  void set(const String *js)
+  {
+    built= false;
+    keys.clear();
+    if (doc.copy(*js))
+      doc.free();
+  }
+  bool is_built() const { return built; }
+  void build(THD *thd);
+  void find(json_engine_t *je, json_path_t *p, json_path_step_t **cur_step,
+            uint *array_counters);
+};
+
+
+class Json_key_index_cache
+{
+  static const uint N_DOCS= 4;
+  Json_key_index docs[N_DOCS];
+  uint next_doc;
+
+public:
+  Json_key_index_cache() :next_doc(0) {}
+  Json_key_index *get(THD *thd, const String *js);
+};
+
+
+/*
+  Scan the top-level object the way json_find_path() does and record
+  where its members start.
+
+  The scan stops at the first error. The members before it are fine to
+  use, as the document is correct up to the last member recorded.
+*/
+void Json_key_index::build(THD *thd)
+{
+  const uchar *start= (const uchar *) doc.ptr();
+  json_engine_t je;
+
+  built= true;
+  json_scan_start(&je, doc.charset(), start, start + doc.length());
+  je.killed_ptr= (uchar *) &thd->killed;
+  if (json_read_value(&je) || je.value_type != JSON_VALUE_OBJECT)
+    return;
+
+  while (json_scan_next(&je) == 0 && je.state == JST_KEY)
+  {
+    if (keys.elements() == 0)
+      first_key= je;
+    if (keys.append((uint) (je.s.c_str - start)) || json_skip_key(&je))
+      break;
+  }
+}
+
+
+/*
+  Move je, which has just been started on the indexed document, to the
+  first member matching the first step of the path. That is where
+  json_find_path() would stop. If no member matches, move it to the last
+  member recorded, json_find_path() then goes on from there.
+*/
+void Json_key_index::find(json_engine_t *je, json_path_t *p,
+                          json_path_step_t **cur_step, uint *array_counters)
+{
+  const uchar *start= (const uchar *) doc.ptr();
+  const uchar *js_start= je->s.c_str;
+  volatile uchar *killed_ptr= je->killed_ptr;
+  json_string_t key_name;
+  json_engine_t k;
+  size_t n;
+
+  DBUG_ASSERT(je->state == JST_VALUE && je->stack_p == 0);
+  if (keys.elements() == 0)
+    return;
+
+  json_string_set_cs(&key_name, p->s.cs);
+  k= first_key;
+  for (n= 0; n < keys.elements() - 1; n++)
+  {
+    k.s= first_key.s;
+    k.s.c_str= start + keys.at(n);
+    k.state= JST_KEY;
+    json_string_set_str(&key_name, p->steps[1].key, p->steps[1].key_end);
+    if (json_key_matches(&k, &key_name))
+      break;
+  }
+
+  /* The state is the same at every member, but for the position */
+  *je= first_key;
+  je->killed_ptr= killed_ptr;
+  je->s.c_str= js_start + keys.at(n);
+  je->s.str_end= js_start + doc.length();
+  je->value= js_start + (first_key.value - start);
+  je->value_begin= js_start + (first_key.value_begin - start);
+  je->value_end= js_start + (first_key.value_end - start);
+  array_counters[1]= 0;
+  *cur_step= p->steps + 1;
+}
+
+
+/*
+  Return the index of the document js, or NULL if the document was not
+  searched before. Then it is remembered in place of the oldest one.
+*/
+Json_key_index *Json_key_index_cache::get(THD *thd, const String *js)
+{
+  for (uint i= 0; i < N_DOCS; i++)
+  {
+    if (docs[i].matches(js))
+    {
+      if (!docs[i].is_built())
+        docs[i].build(thd);
+      return &docs[i];
+    }
+  }
+  docs[next_doc++ % N_DOCS].set(js);
+  return NULL;
+}
+
+
+/*
+  Set up the search of the path p in the document js, with je just
+  started on js, for json_find_path(). Uses the index of the top-level
+  object of js when the document has been searched before.
+*/
+void json_find_path_start(json_engine_t *je, const String *js,
+                          json_path_t *p, json_path_step_t **cur_step,
+                          uint *array_counters)
+{
+  THD *thd;
+  Json_key_index *index;
+
+  *cur_step= p->steps;
+  if (js->length() < JSON_KEY_INDEX_MIN_LENGTH ||
+      js->length() > JSON_KEY_INDEX_MAX_LENGTH ||
+      p->last_step == p->steps ||
+      p->steps[0].type != JSON_PATH_ARRAY_WILD ||
+      p->steps[1].type != JSON_PATH_KEY)
+    return;
+
+  thd= current_thd;
+  if (!thd->json_key_indexes &&
+      !(thd->json_key_indexes= new Json_key_index_cache()))
+    return;
+  if ((index= thd->json_key_indexes->get(thd, js)))
+    index->find(je, p, cur_step, array_counters);
+}
+
+
+void json_key_index_cache_clear(Json_key_index_cache **cp)
+{
+  delete *cp;
+  *cp= NULL;
+}
+
+
 longlong Item_func_json_valid::val_int()
 {
   String *js= args[0]->val_json(&tmp_value);
@@ -491,7 +681,7 @@ longlong Item_func_json_exists::val_int()
   json_scan_start(&je, js->charset(),(const uchar *) js->ptr(),
                   (const uchar *) js->ptr() + js->length());
 
-  path.cur_step= path.p.steps;
+  json_find_path_start(&je, js, &path.p, &path.cur_step, array_counters);
   if (json_find_path(&je, &path.p, &path.cur_step, array_counters))
   {
     if (je.s.error)
@@ -555,7 +745,7 @@ bool Json_path_extractor::extract(String *str, Item *item_js, Item *item_jp,
   str->length(0);
   str->set_charset(cs);
 
-  cur_step= p.steps;
+  json_find_path_start(&je, js, &p, &cur_step, array_counters);
 continue_search:
   if (json_find_path(&je, &p, &cur_step, array_counters))
     return true;
@@ -1261,7 +1451,7 @@ longlong Item_func_json_contains::val_int()
     if (args[2]->null_value)
       goto return_null;
 
-    path.cur_step= path.p.steps;
+    json_find_path_start(&je, js, &path.p, &path.cur_step, array_counters);
     if (json_find_path(&je, &path.p, &path.cur_step, array_counters))
     {
       if (je.s.error)
@@ -1396,7 +1586,8 @@ longlong Item_func_json_contains_path::val_int()
     json_scan_start(&je, js->charset(),(const uchar *) js->ptr(),
                     (const uchar *) js->ptr() + js->length());
 
-    c_path->cur_step= c_path->p.steps;
+    json_find_path_start(&je, js, &c_path->p, &c_path->cur_step,
+                         array_counters);
     if (json_find_path(&je, &c_path->p, &c_path->cur_step, array_counters))
     {
       /* Path wasn't found. */
@@ -2693,7 +2884,7 @@ longlong Item_func_json_length::val_int()
     if (args[1]->null_value)
       goto null_return;
 
-    path.cur_step= path.p.steps;
+    json_find_path_start(&je, js, &path.p, &path.cur_step, array_counters);
     if (json_find_path(&je, &path.p, &path.cur_step, array_counters))
     {
       if (je.s.error)
@@ -3386,7 +3577,7 @@ String *Item_func_json_keys::val_str(String *str)
   if (args[1]->null_value)
     goto null_return;
 
-  path.cur_step= path.p.steps;
+  json_find_path_start(&je, js, &path.p, &path.cur_step, array_counters);
 
   if (json_find_path(&je, &path.p, &path.cur_step, array_counters))
   {
@@ -47,6 +47,10 @@ void report_path_error_ex(const char *ps, json_path_t *p,
 void report_json_error_ex(const char *js, json_engine_t *je,
                           const char *fname, int n_param,
                           Sql_condition::enum_warning_level lv);
+void json_find_path_start(json_engine_t *je, const String *js,
+                          json_path_t *p, json_path_step_t **cur_step,
+                          uint *array_counters);
+void json_key_index_cache_clear(Json_key_index_cache **cp);
 int check_overlaps(json_engine_t *js, json_engine_t *value, bool compare_whole);
 int json_find_overlap_with_object(json_engine_t *js,
                                               json_engine_t *value,
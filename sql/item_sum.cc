@@ -1495,6 +1495,7 @@ Item_sum_sum::Item_sum_sum(THD *thd, Item_sum_sum *item)
    Type_handler_hybrid_field_type(item),
    direct_added(FALSE), direct_reseted_field(FALSE),
    curr_dec_buff(item->curr_dec_buff),
+   scaled_sum(item->scaled_sum),
    count(item->count)
 {
   /* TODO: check if the following assignments are really needed */
@@ -1530,6 +1531,7 @@ void Item_sum_sum::clear()
   if (result_type() == DECIMAL_RESULT)
   {
     curr_dec_buff= 0;
+    scaled_sum= 0;
     my_decimal_set_zero(dec_buffs);
   }
   else
@@ -1556,6 +1558,7 @@ void Item_sum_sum::fix_length_and_dec_decimal()
                                                            decimals,
                                                            unsigned_flag);
   curr_dec_buff= 0;
+  scaled_sum= 0;
   my_decimal_set_zero(dec_buffs);
 }
 
@@ -1637,7 +1640,40 @@ void Item_sum_sum::add_helper(bool perform_removal)
     {
       direct_reseted_field= FALSE;
       my_decimal value;
-      const my_decimal *val= aggr->arg_val_decimal(&value);
+      const my_decimal *val;
+      longlong scaled;
+      if (!aggr->arg_val_decimal_scaled(&scaled, scaled_sum_scale()))
+      {
+        if (aggr->arg_is_null(true))
+          DBUG_VOID_RETURN;
+        if (!perform_removal)
+        {
+          count++;
+          if (scaled > 0 ? scaled_sum > LONGLONG_MAX - scaled
+                         : scaled_sum < LONGLONG_MIN - scaled)
+            flush_scaled_sum();
+          scaled_sum+= scaled;
+          null_value= 0;
+          DBUG_VOID_RETURN;
+        }
+        /* -LONGLONG_MIN does not fit, it is subtracted as a decimal */
+        if (likely(scaled != LONGLONG_MIN))
+        {
+          if (count == 0)
+            DBUG_VOID_RETURN;
+          count--;
+          if (scaled < 0 ? scaled_sum > LONGLONG_MAX + scaled
+                         : scaled_sum < LONGLONG_MIN + scaled)
+            flush_scaled_sum();
+          scaled_sum-= scaled;
+          null_value= (count > 0) ? 0 : 1;
+          DBUG_VOID_RETURN;
+        }
+        longlong_scaled2decimal(scaled, scaled_sum_scale(), &value);
+        val= &value;
+      }
+      else
+        val= aggr->arg_val_decimal(&value);
       if (!aggr->arg_is_null(true))
       {
         if (perform_removal)
@@ -1703,13 +1739,30 @@ void Item_sum_sum::add_helper(bool perform_removal)
 }
 
 
+void Item_sum_sum::flush_scaled_sum()
+{
+  if (scaled_sum)
+  {
+    my_decimal value;
+    longlong_scaled2decimal(scaled_sum, scaled_sum_scale(), &value);
+    my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
+                   &value, dec_buffs + curr_dec_buff);
+    curr_dec_buff^= 1;
+    scaled_sum= 0;
+  }
+}
+
+
 longlong Item_sum_sum::val_int()
 {
   DBUG_ASSERT(fixed());
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    flush_scaled_sum();
     return dec_buffs[curr_dec_buff].to_longlong(unsigned_flag);
+  }
   return val_int_from_real();
 }
 
@@ -1720,7 +1773,10 @@ double Item_sum_sum::val_real()
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    flush_scaled_sum();
     sum= dec_buffs[curr_dec_buff].to_double();
+  }
   return sum;
 }
 
@@ -1740,7 +1796,10 @@ my_decimal *Item_sum_sum::val_decimal(my_decimal *val)
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    flush_scaled_sum();
     return null_value ? NULL : (dec_buffs + curr_dec_buff);
+  }
   return val_decimal_from_real(val);
 }
 
@@ -1818,6 +1877,13 @@ my_decimal *Aggregator_simple::arg_val_decimal(my_decimal *value)
 }
 
 
+bool Aggregator_simple::arg_val_decimal_scaled(longlong *to,
+                                               decimal_digits_t scale)
+{
+  return item_sum->args[0]->val_decimal_scaled(to, scale);
+}
+
+
 double Aggregator_simple::arg_val_real()
 {
   return item_sum->args[0]->val_real();
@@ -1855,6 +1921,15 @@ my_decimal *Aggregator_distinct::arg_val_decimal(my_decimal * value)
 }
 
 
+bool Aggregator_distinct::arg_val_decimal_scaled(longlong *to,
+                                                 decimal_digits_t scale)
+{
+  return use_distinct_values ?
+    table->field[0]->val_decimal_scaled(to, scale) :
+    item_sum->args[0]->val_decimal_scaled(to, scale);
+}
+
+
 double Aggregator_distinct::arg_val_real()
 {
   return use_distinct_values ? table->field[0]->val_real() :
@@ -2085,6 +2160,7 @@ my_decimal *Item_sum_avg::val_decimal(my_decimal *val)
   if (result_type() != DECIMAL_RESULT)
     return val_decimal_from_real(val);
 
+  flush_scaled_sum();
   sum_dec= dec_buffs + curr_dec_buff;
   int2my_decimal(E_DEC_FATAL_ERROR, count, 0, &cnt);
   my_decimal_div(E_DEC_FATAL_ERROR, val, sum_dec, &cnt, prec_increment);
@@ -92,6 +92,12 @@ class Aggregator : public Sql_alloc
 
   /** Decimal value of being-aggregated argument */
   virtual my_decimal *arg_val_decimal(my_decimal * value) = 0;
+  /**
+    Value of being-aggregated argument as an integer scaled by 10^scale,
+    see Item::val_decimal_scaled(). Returns true if arg_val_decimal()
+    must be used instead.
+  */
+  virtual bool arg_val_decimal_scaled(longlong *to, decimal_digits_t scale)= 0;
   /** Floating point value of being-aggregated argument */
   virtual double arg_val_real() = 0;
   /**
@@ -693,6 +699,7 @@ class Aggregator_distinct : public Aggregator
   bool add();
   void endup();
   virtual my_decimal *arg_val_decimal(my_decimal * value);
+  virtual bool arg_val_decimal_scaled(longlong *to, decimal_digits_t scale);
   virtual double arg_val_real();
   virtual bool arg_is_null(bool use_null_value);
 
@@ -720,6 +727,7 @@ class Aggregator_simple : public Aggregator
   bool add() { return item_sum->add(); }
   void endup() {};
   virtual my_decimal *arg_val_decimal(my_decimal * value);
+  virtual bool arg_val_decimal_scaled(longlong *to, decimal_digits_t scale);
   virtual double arg_val_real();
   virtual bool arg_is_null(bool use_null_value);
 };
@@ -805,7 +813,21 @@ class Item_sum_sum :public Item_sum_num,
   my_decimal direct_sum_decimal;
   my_decimal dec_buffs[2];
   uint curr_dec_buff;
+  /*
+    Part of the DECIMAL sum not yet added to dec_buffs, as an integer
+    scaled by 10^scaled_sum_scale(). Arguments which fit in a longlong are
+    summed here and moved to dec_buffs only when it would overflow, or
+    when the value is read.
+  */
+  longlong scaled_sum;
   bool fix_length_and_dec(THD *thd) override;
+  void flush_scaled_sum();
+  /*
+    The scale of the argument. It is not always the scale of the result:
+    AVG() has prec_increment more decimals.
+  */
+  decimal_digits_t scaled_sum_scale() const
+  { return (decimal_digits_t) args[0]->decimals; }
 
 public:
   Item_sum_sum(THD *thd, Item *item_par, bool distinct):
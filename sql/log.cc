@@ -40,6 +40,7 @@
 #include "sql_audit.h"
 #include "mysqld.h"
 #include "ddl_log.h"
+#include "key.h"                                // key_copy, key_hashnr
 
 #include <my_dir.h>
 #include <m_ctype.h>				// For test_if_number
@@ -69,6 +70,9 @@
 #include "semisync_master.h"
 #include "semisync_slave.h"
 #include <utility>     // pair
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #endif
 
 /* max size of the log message */
@@ -161,6 +165,45 @@ static MYSQL_BIN_LOG::xid_count_per_binlog *
     binlog_background_thread_queue= NULL;
 
 static bool start_binlog_background_thread();
+pthread_handler_t binlog_redo_sync_thread(void *arg);
+static bool binlog_single_sync_commit_init();
+
+/*
+  Redo log sync for binlog_single_sync_commit.
+
+  Transactions then do not sync the redo log of the storage engine when
+  they prepare. Instead the group commit leader asks this thread to sync
+  the redo log while it syncs the binlog itself, and waits for both before
+  the group becomes visible to dump threads and is committed in the engine.
+  The two syncs thus overlap instead of following each other.
+
+  Only the group commit leader, holding LOCK_log, makes requests, so there
+  is at most one request pending.
+*/
+class Binlog_redo_sync
+{
+public:
+  Binlog_redo_sync()
+    : hton(NULL), started(false), stop(false), pending(false), error(false)
+  {}
+  bool start(handlerton *hton_arg);
+  void shutdown();
+  bool is_started() const { return started; }
+  handlerton *engine() const { return hton; }
+  void request();
+  bool wait();
+  void thread_main();
+
+private:
+  handlerton *hton;
+  mysql_mutex_t lock;
+  mysql_cond_t cond;
+  bool started;
+  /* Protected by lock */
+  bool stop, pending, error;
+};
+
+static Binlog_redo_sync binlog_redo_sync;
 
 static rpl_binlog_state rpl_global_gtid_binlog_state;
 
@@ -275,9 +318,14 @@ void make_default_log_name(char **out, const char* log_ext, bool once)
 class binlog_cache_data
 {
 public:
-  binlog_cache_data(): m_pending(0), status(0),
+  binlog_cache_data(): payload(0), payload_size(0), payload_alloced(0),
+  payload_uncompressed_size(0), payload_checksum_alg(BINLOG_CHECKSUM_ALG_OFF),
+  events(0), reserved_offset(0), m_pending(0), status(0),
   before_stmt_pos(MY_OFF_T_UNDEF),
   incident(FALSE),
+  writeset(key_memory_binlog_cache_mngr),
+  writeset_incomplete(opt_binlog_dependency_tracking !=
+                      BINLOG_DEPENDENCY_TRACKING_WRITESET),
   saved_max_binlog_cache_size(0), ptr_binlog_cache_use(0),
   ptr_binlog_cache_disk_use(0)
   { }
@@ -286,6 +334,7 @@ class binlog_cache_data
   {
     DBUG_ASSERT(empty());
     close_cached_file(&cache_log);
+    my_free(payload);
   }
 
   /*
@@ -336,10 +385,22 @@ class binlog_cache_data
       compute_statistics();
     if (truncate_file)
       my_chsize(cache_log.file, 0, 0, MYF(MY_WME));
+    payload_size= 0;
+    events= 0;
+    reserved_offset= 0;
+    if (payload_alloced > CACHE_FILE_TRUNC_SIZE)
+    {
+      my_free(payload);
+      payload= 0;
+      payload_alloced= 0;
+    }
 
     status= 0;
     incident= FALSE;
     before_stmt_pos= MY_OFF_T_UNDEF;
+    writeset.clear();
+    writeset_incomplete= (opt_binlog_dependency_tracking !=
+                          BINLOG_DEPENDENCY_TRACKING_WRITESET);
     DBUG_ASSERT(empty());
   }
 
@@ -405,11 +466,65 @@ class binlog_cache_data
     status|= status_arg;
   }
 
+  /*
+    Writeset of the cached events: hashes of the unique key values of all
+    rows changed. Used by binlog_transaction_dependency_tracking=WRITESET.
+  */
+  void add_to_writeset(ulonglong hash)
+  {
+    if (writeset_incomplete)
+      return;
+    if (writeset.elements() >= BINLOG_WRITESET_MAX_KEYS)
+      set_writeset_incomplete();
+    else if (writeset.append(hash))
+      set_writeset_incomplete();
+  }
+
+  /*
+    Called when the cache contains something that can not be described by
+    row hashes (statements, DDL, tables without unique keys, ...). Such a
+    transaction is always treated as conflicting with everything else.
+  */
+  void set_writeset_incomplete()
+  {
+    writeset_incomplete= true;
+    writeset.clear();
+  }
+
+  bool has_complete_writeset() const
+  {
+    return !writeset_incomplete;
+  }
+
+  const Dynamic_array<ulonglong> &get_writeset() const
+  {
+    return writeset;
+  }
+
   /*
     Cache to store data before copying it to the binary log.
   */
   IO_CACHE cache_log;
 
+  /*
+    The cache compressed into the payload of a Transaction_payload_log_event,
+    with binlog_transaction_compression. payload_size is 0 if there is none.
+    The events in it carry the checksums of payload_checksum_alg.
+  */
+  uchar *payload;
+  size_t payload_size, payload_alloced;
+  uint32 payload_uncompressed_size;
+  enum_binlog_checksum_alg payload_checksum_alg;
+
+  /*
+    The number of events in a cache of at least binlog_large_commit_threshold
+    bytes, or 0 if they were not counted. Group commit reserves a range of
+    the binlog of the known size for such a cache, at reserved_offset, and
+    writes the cache into it after it released LOCK_log.
+  */
+  ulonglong events;
+  my_off_t reserved_offset;
+
 private:
   /*
     Pending binrows event. This event is the event where the rows are currently
@@ -435,6 +550,13 @@ class binlog_cache_data
   */ 
   bool incident;
 
+  /*
+    Hashes of the unique keys changed by the cached row events, and whether
+    the cache has anything else in it that they do not describe.
+  */
+  Dynamic_array<ulonglong> writeset;
+  bool writeset_incomplete;
+
   /**
     This function computes binlog cache and disk usage.
   */
@@ -525,8 +647,18 @@ class binlog_cache_mngr {
                                      param_ptr_binlog_cache_use,
                                      param_ptr_binlog_cache_disk_use);
      last_commit_pos_file[0]= 0;
+#ifdef HAVE_ZSTD
+     zstd_cctx= NULL;
+#endif
   }
 
+#ifdef HAVE_ZSTD
+  ~binlog_cache_mngr()
+  {
+    ZSTD_freeCCtx(zstd_cctx);
+  }
+#endif
+
   void reset(bool do_stmt, bool do_trx)
   {
     if (do_stmt)
@@ -581,6 +713,10 @@ class binlog_cache_mngr {
   //Will be reset when gtid is written into binlog
   uchar  gtid_flags3;
   decltype (rpl_gtid::seq_no) sa_seq_no;
+#ifdef HAVE_ZSTD
+  /* Compression context for binlog_transaction_compression, made on use */
+  ZSTD_CCtx *zstd_cctx;
+#endif
 private:
 
   binlog_cache_mngr& operator=(const binlog_cache_mngr& info);
@@ -2948,6 +3084,9 @@ bool MYSQL_LOG::open(
     goto err;
 
   if (init_io_cache(&log_file, file, (log_type == LOG_NORMAL ? IO_SIZE :
+                                      io_cache_type == SEQ_READ_APPEND &&
+                                      relay_log_buffer_size ?
+                                      relay_log_buffer_size :
                                       LOG_BIN_IO_SIZE),
                     io_cache_type, seek_offset, 0,
                     MYF(MY_WME | MY_NABP |
@@ -3496,7 +3635,7 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period)
    bytes_written(0), last_used_log_number(0),
    file_id(1), open_count(1),
    group_commit_queue(0), group_commit_queue_busy(FALSE),
-   num_commits(0), num_group_commits(0),
+   cache_fill_pending(false), num_commits(0), num_group_commits(0),
    group_commit_trigger_count(0), group_commit_trigger_timeout(0),
    group_commit_trigger_lock_wait(0),
    sync_period_ptr(sync_period), sync_counter(0),
@@ -3574,6 +3713,7 @@ void MYSQL_BIN_LOG::cleanup()
     mysql_cond_destroy(&COND_relay_log_updated);
     mysql_cond_destroy(&COND_bin_log_updated);
     mysql_cond_destroy(&COND_queue_busy);
+    mysql_cond_destroy(&COND_cache_fill);
     mysql_cond_destroy(&COND_xid_list);
     mysql_cond_destroy(&COND_binlog_background_thread);
     mysql_cond_destroy(&COND_binlog_background_thread_end);
@@ -3610,6 +3750,7 @@ void MYSQL_BIN_LOG::init_pthread_objects()
   mysql_cond_init(m_key_relay_log_update, &COND_relay_log_updated, 0);
   mysql_cond_init(m_key_bin_log_update, &COND_bin_log_updated, 0);
   mysql_cond_init(m_key_COND_queue_busy, &COND_queue_busy, 0);
+  mysql_cond_init(key_BINLOG_COND_cache_fill, &COND_cache_fill, 0);
   mysql_cond_init(key_BINLOG_COND_xid_list, &COND_xid_list, 0);
 
   mysql_mutex_init(key_BINLOG_LOCK_binlog_background_thread,
@@ -4085,6 +4226,11 @@ bool MYSQL_BIN_LOG::open(const char *log_name,
     }
   }
 
+  if (!is_relay_log && opt_binlog_gtid_index &&
+      gtid_index.open(log_file_name, opt_binlog_gtid_index_span, false))
+    sql_print_warning("Could not create the GTID index of binlog file '%s'",
+                      log_file_name);
+
   log_state= LOG_OPENED;
 
 #ifdef HAVE_REPLICATION
@@ -4415,6 +4561,13 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
     write to the index log file.
   */
   mysql_mutex_lock(&LOCK_log);
+  if (!is_relay_log)
+  {
+    /* A group commit may still write ranges of the binlog it reserved */
+    lock_binlog_end_pos();
+    wait_for_cache_fill();
+    unlock_binlog_end_pos();
+  }
   mysql_mutex_lock(&LOCK_index);
 
   if (!is_relay_log)
@@ -4463,6 +4616,10 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
       no new ones will be written. So we can proceed to delete the logs.
     */
     mysql_mutex_unlock(&LOCK_xid_list);
+#ifdef HAVE_REPLICATION
+    /* The new binlog files may reuse the names of the cached ones */
+    binlog_tail_cache_clear();
+#endif
   }
 
   /* Save variables so that we can reopen the log */
@@ -4493,6 +4650,8 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
 
   for (;;)
   {
+    if (!is_relay_log)
+      gtid_index_delete(linfo.log_file_name);
     if (unlikely((error= my_delete(linfo.log_file_name, MYF(0)))))
     {
       if (my_errno == ENOENT) 
@@ -4601,6 +4760,10 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool create_new_log,
     reset_master_pending--;
     reset_master_count++;
     mysql_mutex_unlock(&LOCK_xid_list);
+#ifdef HAVE_REPLICATION
+    /* Drop anything cached from the deleted files while we were running */
+    binlog_tail_cache_clear();
+#endif
   }
 
   mysql_mutex_unlock(&LOCK_index);
@@ -5109,6 +5272,8 @@ int MYSQL_BIN_LOG::purge_index_entry(THD *thd, ulonglong *reclaimed_space,
         error= 0;
 
         DBUG_PRINT("info",("purging %s",log_info.log_file_name));
+        if (!is_relay_log)
+          gtid_index_delete(log_info.log_file_name);
         if (!my_delete(log_info.log_file_name, MYF(0)))
         {
           if (reclaimed_space)
@@ -5408,6 +5573,13 @@ int MYSQL_BIN_LOG::new_file_impl()
     DBUG_RETURN(error);
   }
 
+  if (!is_relay_log)
+  {
+    lock_binlog_end_pos();
+    wait_for_cache_fill();
+    unlock_binlog_end_pos();
+  }
+
   mysql_mutex_lock(&LOCK_index);
 
   /* Reuse old name if not binlog and not update log */
@@ -5600,7 +5772,7 @@ bool MYSQL_BIN_LOG::append_no_lock(Log_event* ev)
   }
   bytes_written+= ev->data_written;
   DBUG_PRINT("info",("max_size: %lu",max_size));
-  if (flush_and_sync(0))
+  if (flush_relay_log_append())
     goto err;
   if (my_b_append_tell(&log_file) > max_size)
     error= new_file_without_locking();
@@ -5659,7 +5831,7 @@ bool MYSQL_BIN_LOG::write_event_buffer(uchar* buf, uint len)
 
   error= 0;
   DBUG_PRINT("info",("max_size: %lu",max_size));
-  if (flush_and_sync(0))
+  if (flush_relay_log_append())
     goto err;
   if (my_b_append_tell(&log_file) > max_size)
     error= new_file_without_locking();
@@ -5693,6 +5865,32 @@ bool MYSQL_BIN_LOG::flush_and_sync(bool *synced)
   return err;
 }
 
+/*
+  Write out the events the slave I/O thread appended to the relay log.
+
+  With relay_log_buffer_size, the events stay in the append buffer of the
+  relay log IO_CACHE, from which the SQL thread reads them, until the
+  buffer is full (my_b_append() writes it out then) or the relay log is due
+  to be synced. Other points that need the relay log file to be complete,
+  like rotation and updates of master.info, flush the IO_CACHE themselves.
+*/
+
+bool MYSQL_BIN_LOG::flush_relay_log_append()
+{
+  DBUG_ASSERT(log_file.type == SEQ_READ_APPEND);
+  if (relay_log_buffer_size && relay_log_recovery)
+  {
+    uint sync_period= get_sync_period();
+    if (!sync_period || sync_counter + 1 < sync_period)
+    {
+      if (sync_period)
+        sync_counter++;
+      return false;
+    }
+  }
+  return flush_and_sync(0);
+}
+
 void MYSQL_BIN_LOG::start_union_events(THD *thd, query_id_t query_id_param)
 {
   DBUG_ASSERT(!thd->binlog_evt_union.do_union);
@@ -6280,6 +6478,246 @@ THD::binlog_set_pending_rows_event(Rows_log_event* ev, bool is_transactional)
 }
 
 
+/**
+  Add the unique keys of a logged row to the writeset of its binlog cache.
+
+  @param thd           the thread logging the row
+  @param is_trans      @c true if the row goes to the transactional cache
+  @param table         table the row belongs to
+  @param record        the row, in the format of table->record[0]
+  @param cols          columns that are valid in @c record, NULL for all
+  @param changed_cols  columns changed by an update, NULL if the whole row
+                       is inserted or deleted
+
+  Every unique key of the row that has no NULL parts is hashed together
+  with the table name. If a key that changes can not be computed, or the
+  row can not be identified at all, the writeset is marked as incomplete
+  and the transaction will be treated as conflicting with everything.
+*/
+
+void binlog_add_writeset(THD *thd, bool is_trans, TABLE *table,
+                         const uchar *record, const MY_BITMAP *cols,
+                         const MY_BITMAP *changed_cols)
+{
+  binlog_cache_mngr *const cache_mngr= thd->binlog_setup_trx_data();
+  if (!cache_mngr)
+    return;
+
+  binlog_cache_data *cache_data=
+    cache_mngr->get_binlog_cache_data(use_trans_cache(thd, is_trans));
+  if (!cache_data->has_complete_writeset())
+    return;
+
+  /*
+    Foreign keys make rows depend on rows of other tables, which are not
+    part of the writeset.
+  */
+  if (opt_binlog_dependency_tracking != BINLOG_DEPENDENCY_TRACKING_WRITESET ||
+      !table->file->can_switch_engines() ||
+      table->file->referenced_by_foreign_key())
+  {
+    cache_data->set_writeset_incomplete();
+    return;
+  }
+
+  TABLE_SHARE *share= table->s;
+  ulong table_nr1= 1, table_nr2= 4;
+  my_ci_hash_sort(&my_charset_bin, (const uchar*) share->table_cache_key.str,
+                  share->table_cache_key.length, &table_nr1, &table_nr2);
+
+  uchar key_buff[MAX_KEY_LENGTH];
+  bool identified= false;
+  for (uint keynr= 0; keynr < share->keys; keynr++)
+  {
+    KEY *key_info= table->key_info + keynr;
+    if (!(key_info->flags & HA_NOSAME))
+      continue;
+    if (key_info->algorithm == HA_KEY_ALG_LONG_HASH)
+    {
+      cache_data->set_writeset_incomplete();
+      return;
+    }
+
+    KEY_PART_INFO *key_part= key_info->key_part;
+    KEY_PART_INFO *key_part_end= key_part + key_info->user_defined_key_parts;
+    bool changed= !changed_cols || keynr == share->primary_key;
+    bool available= true;
+    bool has_null= false;
+    for (; key_part < key_part_end; key_part++)
+    {
+      uint fieldnr= key_part->fieldnr - 1;
+      if (cols && !bitmap_is_set(cols, fieldnr))
+        available= false;
+      else if (key_part->field->is_null_in_record(record))
+        has_null= true;
+      if (changed_cols && bitmap_is_set(changed_cols, fieldnr))
+        changed= true;
+    }
+    if (!available)
+    {
+      if (changed)
+      {
+        cache_data->set_writeset_incomplete();
+        return;
+      }
+      continue;
+    }
+    if (has_null)
+      continue;                                 // NULLs are never duplicates
+
+    key_copy(key_buff, record, key_info, 0);
+    ulonglong hash= ((ulonglong) table_nr1 << 8) + keynr;
+    hash^= key_hashnr(key_info, key_info->user_defined_key_parts, key_buff);
+    hash*= 0x9E3779B97F4A7C15ULL;
+    hash^= hash >> 31;
+    cache_data->add_to_writeset(hash);
+    identified= true;
+  }
+
+  if (!identified)
+    cache_data->set_writeset_incomplete();
+}
+
+
+/*
+  Assigns the commit_id of transactions written to the binlog with
+  binlog_transaction_dependency_tracking=WRITESET.
+
+  A parallel slave applies transactions with the same commit_id in
+  parallel, as they were group committed together on the master and so
+  could not conflict. With writeset tracking, a run of consecutive
+  transactions gets the same commit_id as long as none of them changes a
+  unique key changed by another in the run, even when they were committed
+  in different groups.
+
+  The keys of the current run are kept in a bitmap, two bits per key; a
+  false positive only starts a new run. Transactions without a complete
+  writeset end the current run. All members are protected by LOCK_log.
+*/
+
+class Binlog_writeset_history
+{
+public:
+  Binlog_writeset_history() { reset(); }
+
+  /* Forget the current run; the next transaction will start a new one. */
+  void reset()
+  {
+    run_commit_id= 0;
+    run_group_id= 0;
+    run_closed= true;
+  }
+
+  uint64 get_commit_id(THD *thd, binlog_cache_mngr *cache_mngr,
+                       bool using_stmt_cache, bool using_trx_cache,
+                       uint64 group_commit_id);
+
+private:
+  static const uint BITS= 1 << 16;
+  static const uint MAX_KEYS= BINLOG_WRITESET_MAX_KEYS;
+
+  static uint bit1(ulonglong hash) { return (uint) hash & (BITS - 1); }
+  static uint bit2(ulonglong hash) { return (uint) (hash >> 32) & (BITS - 1); }
+  bool is_set(uint bit) const
+  { return (bits[bit / 64] >> (bit % 64)) & 1; }
+  void set(uint bit) { bits[bit / 64]|= 1ULL << (bit % 64); }
+
+  ulonglong bits[BITS / 64];
+  uint keys;
+  /* commit_id given to the transactions in the current run */
+  uint64 run_commit_id;
+  /* group commit id of the run, if it consists of only one group so far */
+  uint64 run_group_id;
+  /* A transaction without writeset was added, the run can not be extended */
+  bool run_closed;
+};
+
+
+uint64
+Binlog_writeset_history::get_commit_id(THD *thd,
+                                       binlog_cache_mngr *cache_mngr,
+                                       bool using_stmt_cache,
+                                       bool using_trx_cache,
+                                       uint64 group_commit_id)
+{
+  binlog_cache_data *caches[2];
+  uint n_caches= 0;
+  size_t n_keys= 0;
+
+  if (using_stmt_cache && !cache_mngr->stmt_cache.empty())
+    caches[n_caches++]= &cache_mngr->stmt_cache;
+  if (using_trx_cache && !cache_mngr->trx_cache.empty())
+    caches[n_caches++]= &cache_mngr->trx_cache;
+
+  bool usable= n_caches > 0;
+  for (uint i= 0; usable && i < n_caches; i++)
+  {
+    usable= caches[i]->has_complete_writeset() && !caches[i]->has_incident();
+    n_keys+= caches[i]->get_writeset().elements();
+  }
+  if (n_keys > MAX_KEYS)
+    usable= false;
+
+  bool join= false;
+  if (run_commit_id && group_commit_id && group_commit_id == run_group_id)
+  {
+    /* Committed together with the rest of the run, so no conflict */
+    join= true;
+  }
+  else if (!run_closed && usable && keys + n_keys <= MAX_KEYS)
+  {
+    join= true;
+    for (uint i= 0; join && i < n_caches; i++)
+    {
+      const Dynamic_array<ulonglong> &writeset= caches[i]->get_writeset();
+      for (size_t j= 0; j < writeset.elements(); j++)
+      {
+        ulonglong hash= writeset.at(j);
+        if (is_set(bit1(hash)) && is_set(bit2(hash)))
+        {
+          join= false;
+          break;
+        }
+      }
+    }
+    if (join)
+      run_group_id= 0;
+  }
+
+  if (!join)
+  {
+    uint64 commit_id= (uint64) thd->query_id;
+    if (commit_id == run_commit_id || commit_id == 0)
+      commit_id= run_commit_id + 1;
+    run_commit_id= commit_id;
+    run_group_id= group_commit_id;
+    run_closed= false;
+    keys= 0;
+    bzero(bits, sizeof(bits));
+  }
+
+  if (usable && keys + n_keys <= MAX_KEYS)
+  {
+    for (uint i= 0; i < n_caches; i++)
+    {
+      const Dynamic_array<ulonglong> &writeset= caches[i]->get_writeset();
+      for (size_t j= 0; j < writeset.elements(); j++)
+      {
+        set(bit1(writeset.at(j)));
+        set(bit2(writeset.at(j)));
+      }
+    }
+    keys+= (uint) n_keys;
+  }
+  else
+    run_closed= true;
+
+  return run_commit_id;
+}
+
+static Binlog_writeset_history binlog_writeset_history;
+
+
 /**
   This function removes the pending rows event, discarding any outstanding
   rows. If there is no pending rows event available, this is effectively a
@@ -6444,6 +6882,7 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
   }
 #endif
 
+  gtid_index.process_gtid(my_b_tell(&log_file), &gtid);
   if (write_event(&gtid_event))
     DBUG_RETURN(true);
   status_var_add(thd->status_var.binlog_bytes_written, gtid_event.data_written);
@@ -6771,6 +7210,7 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
           commit_id= entry->val_int(&null_value);
         });
       res= write_gtid_event(thd, true, using_trans, commit_id);
+      binlog_writeset_history.reset();
       if (mdl_request.ticket)
         thd->mdl_context.release_lock(mdl_request.ticket);
       thd->backup_commit_lock= 0;
@@ -6790,6 +7230,9 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       if (thd->lex->stmt_accessed_non_trans_temp_table() && is_trans_cache)
         thd->transaction->stmt.mark_modified_non_trans_temp_table();
       thd->binlog_start_trans_and_stmt();
+      /* Only row events can be described by a writeset */
+      if (event_info->get_type_code() != TABLE_MAP_EVENT)
+        cache_data->set_writeset_incomplete();
     }
     DBUG_PRINT("info",("event type: %d",event_info->get_type_code()));
 
@@ -7128,7 +7571,19 @@ int MYSQL_BIN_LOG::rotate(bool force_rotate, bool* check_purge)
   //todo: fix the macro def and restore safe_mutex_assert_owner(&LOCK_log);
   *check_purge= false;
 
-  if (force_rotate || (my_b_tell(&log_file) >= (my_off_t) max_size))
+  bool do_rotate= force_rotate;
+  if (!do_rotate && my_b_tell(&log_file) >= (my_off_t) max_size)
+  {
+    /*
+      Do not wait for a group commit to write its reserved ranges; the
+      binlog is rotated by the next write after them.
+    */
+    lock_binlog_end_pos();
+    do_rotate= !cache_fill_pending;
+    unlock_binlog_end_pos();
+  }
+
+  if (do_rotate)
   {
     ulong binlog_id= current_binlog_id;
     /*
@@ -7422,6 +7877,7 @@ class CacheWriter: public Log_event_writer
     write_cache()
     thd      Current_thread
     cache    Cache to write to the binary log
+    file     The binary log, or a range of it reserved by reserve_cache_range()
 
   DESCRIPTION
     Write the contents of the cache to the binary log. The cache will
@@ -7432,18 +7888,19 @@ class CacheWriter: public Log_event_writer
     events prior to fill in the binlog cache.
 */
 
-int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
+int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache, IO_CACHE *file)
 {
   DBUG_ENTER("MYSQL_BIN_LOG::write_cache");
 
-  mysql_mutex_assert_owner(&LOCK_log);
+  if (file == &log_file)
+    mysql_mutex_assert_owner(&LOCK_log);
   if (reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
     DBUG_RETURN(ER_ERROR_ON_WRITE);
   size_t length= my_b_bytes_in_cache(cache), group, carry, hdr_offs;
   size_t val;
   size_t end_log_pos_inc= 0; // each event processed adds BINLOG_CHECKSUM_LEN 2 t
   uchar header[LOG_EVENT_HEADER_LEN];
-  CacheWriter writer(thd, &log_file, binlog_checksum_options, &crypto);
+  CacheWriter writer(thd, file, binlog_checksum_options, &crypto);
 
   if (crypto.scheme)
   {
@@ -7468,7 +7925,7 @@ int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
     split.
   */
 
-  group= (size_t)my_b_tell(&log_file);
+  group= (size_t)my_b_tell(file);
   hdr_offs= carry= 0;
 
   do
@@ -7593,6 +8050,354 @@ int MYSQL_BIN_LOG::write_cache(THD *thd, IO_CACHE *cache)
   DBUG_RETURN(0);                               // All OK
 }
 
+
+/*
+  Write a binlog cache to the binary log, as the Transaction_payload event
+  compressed from it by binlog_compress_cache() if there is one that still
+  has the checksums the binary log needs. A large cache of which
+  binlog_count_cache_events() counted the events only gets its range of the
+  binary log reserved here; write_reserved_caches() writes it later.
+*/
+
+int MYSQL_BIN_LOG::write_payload_or_cache(THD *thd,
+                                          binlog_cache_data *cache_data)
+{
+  mysql_mutex_assert_owner(&LOCK_log);
+  if (cache_data->payload_size &&
+      cache_data->payload_checksum_alg == binlog_checksum_options)
+  {
+    Transaction_payload_log_event ev(thd, cache_data->payload,
+                                     (uint32) cache_data->payload_size,
+                                     cache_data->payload_uncompressed_size);
+    if (write_event(&ev))
+      return ER_ERROR_ON_WRITE;
+    status_var_add(thd->status_var.binlog_bytes_written, ev.data_written);
+    return 0;
+  }
+  if (cache_data->events && !crypto.scheme)
+    return reserve_cache_range(thd, cache_data);
+  return write_cache(thd, &cache_data->cache_log);
+}
+
+
+/*
+  Reserve the range of the binary log that write_cache() would fill with
+  the events of a binlog cache, by moving the write position of the binlog
+  past it.
+
+  The length of the range is known from the number of events in the cache,
+  as write_cache() only adds a checksum to each event. The range is
+  written by write_reserved_caches() after the group commit released
+  LOCK_log. A cache that is not larger than the write buffer of the binary
+  log is written the usual way.
+*/
+
+int MYSQL_BIN_LOG::reserve_cache_range(THD *thd, binlog_cache_data *cache_data)
+{
+  uint checksum_len= (binlog_checksum_options != BINLOG_CHECKSUM_ALG_OFF ?
+                      BINLOG_CHECKSUM_LEN : 0);
+  my_off_t length= (my_b_tell(&cache_data->cache_log) +
+                    cache_data->events * checksum_len);
+  my_off_t offset= my_b_tell(&log_file);
+  mysql_mutex_assert_owner(&LOCK_log);
+
+  if (length <= log_file.buffer_length)
+  {
+    cache_data->events= 0;
+    return write_cache(thd, &cache_data->cache_log);
+  }
+  /*
+    Continue writing at the end of the range. Unlike my_b_seek(), which
+    only moves the write position when the new one is in the buffer,
+    reinit_io_cache() writes out what is buffered and seeks in the file,
+    so no stale bytes of the buffer are written over the range.
+  */
+  if (reinit_io_cache(&log_file, WRITE_CACHE, offset + length, 0, 0))
+    return ER_ERROR_ON_WRITE;
+  cache_data->reserved_offset= offset;
+  return 0;
+}
+
+
+/*
+  A range of the binary log reserved for a large transaction could not be
+  written. The binary log can not be repaired while the server runs, as
+  the events of the group commit and maybe of the next one follow the
+  range. So the server is aborted: none of these transactions is committed
+  in the engines yet, and crash recovery truncates the binary log at the
+  first range that was not written and rolls them back, see
+  binlog_unwritten_range().
+*/
+
+static void binlog_reserved_range_failed(const char *log_name, File file,
+                                         my_off_t offset)
+{
+  static const uchar unwritten[LOG_EVENT_HEADER_LEN]= { 0 };
+  sql_print_error("Could not write a transaction to the binary log '%s' at "
+                  "position %llu (errno: %d). Aborting; crash recovery "
+                  "truncates the binary log at that position.",
+                  log_name, (ulonglong) offset, errno);
+  /* The range may be partly written; make it look unwritten to recovery */
+  if (file >= 0)
+    (void) my_pwrite(file, unwritten, sizeof(unwritten), offset, MYF(0));
+  abort();
+}
+
+
+/*
+  Write the binlog caches for which the group commit in QUEUE reserved a
+  range of the binary log with reserve_cache_range().
+
+  The group commit leader does this after it released LOCK_log, so that the
+  next group commit can write its transactions to the binary log meanwhile;
+  cache_fill_pending keeps binlog_end_pos and rotation behind the ranges
+  until they are written. The ranges are written through a file descriptor
+  of our own, as the next group commit moves the file position of the one
+  of log_file.
+
+  SYNCED tells if the group commit synced the binary log, in which case the
+  ranges are synced too.
+
+  Returns true if the ranges could not be synced; the error is set in the
+  group commit entries, as for a failed sync in trx_group_commit_leader().
+  If a range can not be written, the server is aborted, see
+  binlog_reserved_range_failed().
+*/
+
+bool MYSQL_BIN_LOG::write_reserved_caches(group_commit_entry *queue,
+                                          bool synced)
+{
+  File file;
+  bool error= false;
+  DBUG_ENTER("MYSQL_BIN_LOG::write_reserved_caches");
+
+  file= mysql_file_open(key_file_binlog, log_file_name,
+                        O_WRONLY | O_BINARY, MYF(MY_WME));
+
+  for (group_commit_entry *current= queue; current; current= current->next)
+  {
+    binlog_cache_mngr *mngr= current->cache_mngr;
+    binlog_cache_data *caches[]= { &mngr->stmt_cache, &mngr->trx_cache };
+
+    for (binlog_cache_data *cache_data : caches)
+    {
+      IO_CACHE range;
+      bool failed;
+
+      if (!cache_data->reserved_offset)
+        continue;
+      set_current_thd(current->thd);
+      if (!(failed= file < 0 ||
+                    init_io_cache(&range, file, LOG_BIN_IO_SIZE, WRITE_CACHE,
+                                  cache_data->reserved_offset, 0,
+                                  MYF(MY_WME | MY_NABP | MY_WAIT_IF_FULL))))
+      {
+        failed= write_cache(current->thd, &cache_data->cache_log, &range);
+        if (end_io_cache(&range))
+          failed= true;
+      }
+      if (unlikely(failed))
+        binlog_reserved_range_failed(log_file_name, file,
+                                     cache_data->reserved_offset);
+      cache_data->reserved_offset= 0;
+    }
+  }
+  set_current_thd(queue->thd);
+
+  if (synced && mysql_file_sync(file, MYF(MY_WME | MY_SYNC_FILESIZE)))
+  {
+    error= true;
+    for (group_commit_entry *current= queue; current; current= current->next)
+    {
+      if (!current->error)
+      {
+        current->error= ER_ERROR_ON_WRITE;
+        current->commit_errno= errno;
+        current->error_cache= NULL;
+      }
+    }
+  }
+  mysql_file_close(file, MYF(MY_WME));
+  DBUG_RETURN(error);
+}
+
+
+#ifdef HAVE_ZSTD
+/*
+  Feed LEN bytes to the zstd stream of the payload of a binlog cache,
+  growing the payload buffer as needed.
+*/
+
+static bool binlog_compress_data(ZSTD_CCtx *cctx, binlog_cache_data *data,
+                                 const uchar *src, size_t len,
+                                 ZSTD_EndDirective mode)
+{
+  ZSTD_inBuffer in= { src, len, 0 };
+  for (;;)
+  {
+    if (data->payload_size == data->payload_alloced)
+    {
+      size_t alloc= MY_MAX(data->payload_alloced * 2, ZSTD_CStreamOutSize());
+      uchar *buf= (uchar *) my_realloc(key_memory_binlog_cache_mngr,
+                                       data->payload, alloc,
+                                       MYF(MY_ALLOW_ZERO_PTR));
+      if (!buf)
+        return true;
+      data->payload= buf;
+      data->payload_alloced= alloc;
+    }
+    ZSTD_outBuffer out= { data->payload, data->payload_alloced,
+                          data->payload_size };
+    size_t res= ZSTD_compressStream2(cctx, &out, &in, mode);
+    data->payload_size= out.pos;
+    if (ZSTD_isError(res))
+      return true;
+    if (mode == ZSTD_e_end ? res == 0 : in.pos == in.size)
+      return false;
+  }
+}
+
+
+/*
+  Compress the events of a binlog cache into the payload of a
+  Transaction_payload_log_event, for binlog_transaction_compression.
+
+  This is done by the committing thread before it queues for group commit,
+  so that transactions are compressed in parallel and not under LOCK_log.
+  The events get the lengths, checksums and zero end_log_pos that
+  write_cache() would give them in the binary log. If compression fails or
+  does not make the events smaller, no payload is made and the cache is
+  written as is.
+*/
+
+static void binlog_compress_cache(binlog_cache_mngr *mngr,
+                                  binlog_cache_data *data)
+{
+  IO_CACHE *cache= &data->cache_log;
+  my_off_t length= my_b_tell(cache);
+  size_t uncompressed= 0;
+  uint checksum_len;
+  ZSTD_CCtx *cctx;
+
+  data->payload_size= 0;
+  /* The slave must be able to expand it in one buffer */
+  if (length > global_system_variables.max_allowed_packet)
+    return;
+  if (!(cctx= mngr->zstd_cctx) &&
+      !(cctx= mngr->zstd_cctx= ZSTD_createCCtx()))
+    return;
+  ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only);
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+                         (int) opt_binlog_transaction_compression_level);
+  data->payload_checksum_alg= (enum_binlog_checksum_alg) binlog_checksum_options;
+  checksum_len= (data->payload_checksum_alg != BINLOG_CHECKSUM_ALG_OFF ?
+                 BINLOG_CHECKSUM_LEN : 0);
+
+  if (reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
+    goto err;
+
+  while (my_b_tell(cache) < length)
+  {
+    uchar header[LOG_EVENT_HEADER_LEN];
+    uchar crc_buf[BINLOG_CHECKSUM_LEN];
+    ha_checksum crc;
+    size_t ev_len, remains;
+
+    if (my_b_read(cache, header, LOG_EVENT_HEADER_LEN))
+      goto err;
+    ev_len= uint4korr(header + EVENT_LEN_OFFSET);
+    if (ev_len < LOG_EVENT_HEADER_LEN)
+      goto err;
+    int4store(header + EVENT_LEN_OFFSET, ev_len + checksum_len);
+    int4store(header + LOG_POS_OFFSET, 0);
+    crc= my_checksum(0, header, LOG_EVENT_HEADER_LEN);
+    if (binlog_compress_data(cctx, data, header, LOG_EVENT_HEADER_LEN,
+                             ZSTD_e_continue))
+      goto err;
+
+    for (remains= ev_len - LOG_EVENT_HEADER_LEN; remains; )
+    {
+      if (cache->read_pos == cache->read_end && !my_b_fill(cache))
+        goto err;
+      size_t chunk= MY_MIN(remains,
+                           (size_t) (cache->read_end - cache->read_pos));
+      crc= my_checksum(crc, cache->read_pos, chunk);
+      if (binlog_compress_data(cctx, data, cache->read_pos, chunk,
+                               ZSTD_e_continue))
+        goto err;
+      cache->read_pos+= chunk;
+      remains-= chunk;
+    }
+    if (checksum_len)
+    {
+      int4store(crc_buf, crc);
+      if (binlog_compress_data(cctx, data, crc_buf, checksum_len,
+                               ZSTD_e_continue))
+        goto err;
+    }
+    uncompressed+= ev_len + checksum_len;
+  }
+
+  if (binlog_compress_data(cctx, data, NULL, 0, ZSTD_e_end) ||
+      data->payload_size >= uncompressed)
+    goto err;
+  data->payload_uncompressed_size= (uint32) uncompressed;
+  goto end;
+
+err:
+  data->payload_size= 0;
+end:
+  /* Leave the cache as it was, for write_cache() to read it again */
+  reinit_io_cache(cache, WRITE_CACHE, length, 0, 0);
+}
+#endif /* HAVE_ZSTD */
+
+
+/*
+  Count the events of a binlog cache of at least
+  binlog_large_commit_threshold bytes, so that the group commit can reserve
+  the range of the binary log they take without reading them; see
+  MYSQL_BIN_LOG::reserve_cache_range().
+
+  This is done by the committing thread before it queues for group commit.
+  Only the event headers are read. If the cache can not be read, the events
+  are not counted and the cache is written the usual way.
+*/
+
+static void binlog_count_cache_events(binlog_cache_data *data)
+{
+  IO_CACHE *cache= &data->cache_log;
+  my_off_t length= my_b_tell(cache), pos= 0;
+  ulonglong events= 0;
+
+  data->events= 0;
+  if (data->payload_size || length < opt_binlog_large_commit_threshold)
+    return;
+  if (reinit_io_cache(cache, READ_CACHE, 0, 0, 0))
+    goto end;
+
+  while (pos < length)
+  {
+    uchar header[LOG_EVENT_HEADER_LEN];
+    size_t ev_len;
+
+    my_b_seek(cache, pos);
+    if (my_b_read(cache, header, LOG_EVENT_HEADER_LEN))
+      goto end;
+    ev_len= uint4korr(header + EVENT_LEN_OFFSET);
+    if (ev_len < LOG_EVENT_HEADER_LEN)
+      goto end;
+    pos+= ev_len;
+    events++;
+  }
+  if (pos == length)
+    data->events= events;
+
+end:
+  /* Leave the cache as it was, for write_cache() to read it again */
+  reinit_io_cache(cache, WRITE_CACHE, length, 0, 0);
+}
+
 /*
   Helper function to get the error code of the query to be binlogged.
  */
@@ -7799,6 +8604,24 @@ MYSQL_BIN_LOG::write_transaction_to_binlog(THD *thd,
       entry.need_unlog= true;
   }
 
+#ifdef HAVE_ZSTD
+  if (thd->variables.binlog_transaction_compression)
+  {
+    if (using_stmt_cache && !cache_mngr->stmt_cache.empty())
+      binlog_compress_cache(cache_mngr, &cache_mngr->stmt_cache);
+    if (using_trx_cache && !cache_mngr->trx_cache.empty())
+      binlog_compress_cache(cache_mngr, &cache_mngr->trx_cache);
+  }
+#endif
+
+  if (opt_binlog_large_commit_threshold)
+  {
+    if (using_stmt_cache && !cache_mngr->stmt_cache.empty())
+      binlog_count_cache_events(&cache_mngr->stmt_cache);
+    if (using_trx_cache && !cache_mngr->trx_cache.empty())
+      binlog_count_cache_events(&cache_mngr->trx_cache);
+  }
+
   if (cache_mngr->stmt_cache.has_incident() ||
       cache_mngr->trx_cache.has_incident())
   {
@@ -7876,6 +8699,7 @@ MYSQL_BIN_LOG::queue_for_group_commit(group_commit_entry *orig_entry)
   if (wfc && wfc->waitee.load(std::memory_order_acquire))
   {
     wait_for_commit *loc_waitee;
+    ulonglong wait_start;
 
     mysql_mutex_lock(&wfc->LOCK_wait_commit);
     /*
@@ -7924,6 +8748,7 @@ MYSQL_BIN_LOG::queue_for_group_commit(group_commit_entry *orig_entry)
       */
       wfc->opaque_pointer= orig_entry;
       DEBUG_SYNC(orig_entry->thd, "group_commit_waiting_for_prior");
+      wait_start= microsecond_interval_timer();
       orig_entry->thd->ENTER_COND(&wfc->COND_wait_commit,
                                   &wfc->LOCK_wait_commit,
                                   &stage_waiting_for_prior_transaction_to_commit,
@@ -7973,6 +8798,9 @@ MYSQL_BIN_LOG::queue_for_group_commit(group_commit_entry *orig_entry)
         }
       }
       orig_entry->thd->EXIT_COND(&old_stage);
+#ifdef HAVE_REPLICATION
+      rpl_count_prior_commit_wait(orig_entry->thd, wait_start);
+#endif
     }
     else
       mysql_mutex_unlock(&wfc->LOCK_wait_commit);
@@ -8333,6 +9161,9 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
   group_commit_entry *current, *last_in_queue;
   group_commit_entry *queue= NULL;
   bool check_purge= false;
+  /* If caches are written to reserved ranges after LOCK_log is released */
+  bool reserved= false;
+  bool synced= false, sync_error= false;
   ulong UNINIT_VAR(binlog_id);
   uint64 commit_id;
   DBUG_ENTER("MYSQL_BIN_LOG::trx_group_commit_leader");
@@ -8418,10 +9249,26 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
                   !cache_mngr->trx_cache.empty()  ||
                   current->thd->transaction->xid_state.is_explicit_XA());
 
+      uint64 entry_commit_id= commit_id;
+      if (opt_binlog_dependency_tracking ==
+            BINLOG_DEPENDENCY_TRACKING_WRITESET &&
+          !DBUG_IF("binlog_force_commit_id"))
+        entry_commit_id=
+          binlog_writeset_history.get_commit_id(current->thd, cache_mngr,
+                                                current->using_stmt_cache,
+                                                current->using_trx_cache,
+                                                commit_id);
+      else
+        binlog_writeset_history.reset();
+
       if (unlikely((current->error= write_transaction_or_stmt(current,
-                                                              commit_id))))
+                                                              entry_commit_id))))
         current->commit_errno= errno;
 
+      if (cache_mngr->stmt_cache.reserved_offset ||
+          cache_mngr->trx_cache.reserved_offset)
+        reserved= true;
+
       strmake_buf(cache_mngr->last_commit_pos_file, log_file_name);
       commit_offset= my_b_write_tell(&log_file);
       cache_mngr->last_commit_pos_offset= commit_offset;
@@ -8447,8 +9294,29 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
     }
     set_current_thd(leader->thd);
 
-    bool synced= 0;
-    if (unlikely(flush_and_sync(&synced)))
+    /*
+      With binlog_single_sync_commit the prepare of the transactions is not
+      durable yet; sync the redo log of the engine while we sync the binlog.
+    */
+    bool redo_sync= binlog_redo_sync.is_started();
+    if (redo_sync)
+      binlog_redo_sync.request();
+    sync_error= flush_and_sync(&synced);
+    if (redo_sync && binlog_redo_sync.wait())
+      sync_error= true;
+    DBUG_EXECUTE_IF("crash_after_binlog_sync", DBUG_SUICIDE(););
+    if (reserved)
+    {
+      /*
+        Keep binlog_end_pos and rotation behind our reserved ranges until
+        we wrote them. Only one group commit at a time writes its ranges.
+      */
+      lock_binlog_end_pos();
+      wait_for_cache_fill();
+      cache_fill_pending= true;
+      unlock_binlog_end_pos();
+    }
+    if (unlikely(sync_error))
     {
       for (current= queue; current != NULL; current= current->next)
       {
@@ -8494,8 +9362,11 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
         Note: must be _after_ the RUN_HOOK(after_flush) or else
         semi-sync might not have put the transaction into
         it's list before dump-thread tries to send it
+
+        With reserved ranges, this is done once they are written.
       */
-      update_binlog_end_pos(commit_offset);
+      if (!reserved)
+        update_binlog_end_pos(commit_offset);
 
       if (unlikely(any_error))
         sql_print_error("Failed to run 'after_flush' hooks");
@@ -8547,6 +9418,33 @@ MYSQL_BIN_LOG::trx_group_commit_leader(group_commit_entry *leader)
 
   DEBUG_SYNC(leader->thd, "commit_after_release_LOCK_log");
 
+  if (reserved)
+  {
+    /*
+      Write the large caches while the next group commit can write to the
+      binlog; it waits for us before it moves binlog_end_pos or rotates.
+      The binlog was not rotated, so commit_offset is still our end.
+
+      Until they are written, the binlog has a range of zeros that events
+      of our group commit, and maybe of the next one, follow. None of them
+      is committed in the engines before we are done: the next group
+      commit waits for LOCK_after_binlog_sync. After a crash, recovery
+      truncates the binlog at the range, see binlog_unwritten_range().
+    */
+    DBUG_EXECUTE_IF("crash_before_write_reserved_caches", DBUG_SUICIDE(););
+    bool range_sync_error= write_reserved_caches(queue, synced);
+    lock_binlog_end_pos();
+    cache_fill_pending= false;
+    if (likely(!sync_error && !range_sync_error))
+    {
+      DBUG_ASSERT(commit_offset >= binlog_end_pos);
+      binlog_end_pos= commit_offset;
+      signal_bin_log_update();
+    }
+    mysql_cond_broadcast(&COND_cache_fill);
+    unlock_binlog_end_pos();
+  }
+
   /*
     Loop through threads and run the binlog_sync hook
   */
@@ -8674,7 +9572,7 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
     DBUG_RETURN(ER_ERROR_ON_WRITE);
 
   if (entry->using_stmt_cache && !mngr->stmt_cache.empty() &&
-      write_cache(entry->thd, mngr->get_binlog_cache_log(FALSE)))
+      write_payload_or_cache(entry->thd, &mngr->stmt_cache))
   {
     entry->error_cache= &mngr->stmt_cache.cache_log;
     DBUG_RETURN(ER_ERROR_ON_WRITE);
@@ -8694,7 +9592,7 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                       DBUG_SUICIDE();
                     });
 
-    if (write_cache(entry->thd, mngr->get_binlog_cache_log(TRUE)))
+    if (write_payload_or_cache(entry->thd, &mngr->trx_cache))
     {
       entry->error_cache= &mngr->trx_cache.cache_log;
       DBUG_RETURN(ER_ERROR_ON_WRITE);
@@ -9009,6 +9907,7 @@ void MYSQL_BIN_LOG::close(uint exiting)
       mysql_file_seek(log_file.file, org_position, MY_SEEK_SET, MYF(0));
     }
 
+    gtid_index.close();
     /* this will cleanup IO_CACHE, sync and close the file */
     MYSQL_LOG::close(exiting);
   }
@@ -10276,6 +11175,8 @@ bool MYSQL_BIN_LOG::truncate_and_remove_binlogs(const char *file_name,
   else
   {
     char buf[21];
+    /* The GTID index of the file may point past the new end */
+    gtid_index_delete(file_name);
     longlong10_to_str(ptr_gtid->seq_no, buf, 10);
     sql_print_information("Successfully truncated binlog file:%s "
                           "from previous file size %llu "
@@ -10319,6 +11220,9 @@ int TC_LOG_BINLOG::open(const char *opt_name)
     DBUG_RETURN(1);
   }
 
+  if (opt_binlog_single_sync_commit && binlog_single_sync_commit_init())
+    opt_binlog_single_sync_commit= false;
+
   error= do_binlog_recovery(opt_name, true);
   binlog_state_recover_done= true;
   DBUG_RETURN(error);
@@ -10327,6 +11231,7 @@ int TC_LOG_BINLOG::open(const char *opt_name)
 /** This is called on shutdown, after ha_panic. */
 void TC_LOG_BINLOG::close()
 {
+  binlog_redo_sync.shutdown();
 }
 
 /*
@@ -10768,6 +11673,207 @@ start_binlog_background_thread()
 
   return 0;
 }
+
+#ifdef HAVE_PSI_INTERFACE
+static PSI_thread_key key_thread_binlog_redo_sync;
+static PSI_mutex_key key_LOCK_binlog_redo_sync;
+static PSI_cond_key key_COND_binlog_redo_sync;
+
+static PSI_thread_info all_binlog_redo_sync_threads[]=
+{
+  { &key_thread_binlog_redo_sync, "binlog_redo_sync", PSI_FLAG_GLOBAL},
+};
+
+static PSI_mutex_info all_binlog_redo_sync_mutexes[]=
+{
+  { &key_LOCK_binlog_redo_sync, "Binlog_redo_sync::lock", PSI_FLAG_GLOBAL},
+};
+
+static PSI_cond_info all_binlog_redo_sync_conds[]=
+{
+  { &key_COND_binlog_redo_sync, "Binlog_redo_sync::cond", PSI_FLAG_GLOBAL},
+};
+#endif /* HAVE_PSI_INTERFACE */
+
+bool Binlog_redo_sync::start(handlerton *hton_arg)
+{
+  pthread_t th;
+  DBUG_ASSERT(!started);
+
+#ifdef HAVE_PSI_INTERFACE
+  if (PSI_server)
+  {
+    PSI_server->register_thread("sql", all_binlog_redo_sync_threads,
+                                array_elements(all_binlog_redo_sync_threads));
+    PSI_server->register_mutex("sql", all_binlog_redo_sync_mutexes,
+                               array_elements(all_binlog_redo_sync_mutexes));
+    PSI_server->register_cond("sql", all_binlog_redo_sync_conds,
+                              array_elements(all_binlog_redo_sync_conds));
+  }
+#endif
+
+  hton= hton_arg;
+  mysql_mutex_init(key_LOCK_binlog_redo_sync, &lock, MY_MUTEX_INIT_SLOW);
+  mysql_cond_init(key_COND_binlog_redo_sync, &cond, NULL);
+  if (mysql_thread_create(key_thread_binlog_redo_sync, &th, &connection_attrib,
+                          binlog_redo_sync_thread, this))
+  {
+    mysql_cond_destroy(&cond);
+    mysql_mutex_destroy(&lock);
+    return true;
+  }
+  started= true;
+  return false;
+}
+
+
+void Binlog_redo_sync::shutdown()
+{
+  if (!started)
+    return;
+  mysql_mutex_lock(&lock);
+  stop= true;
+  mysql_cond_broadcast(&cond);
+  while (stop)
+    mysql_cond_wait(&cond, &lock);
+  mysql_mutex_unlock(&lock);
+  mysql_cond_destroy(&cond);
+  mysql_mutex_destroy(&lock);
+  started= false;
+}
+
+
+void Binlog_redo_sync::request()
+{
+  mysql_mutex_lock(&lock);
+  DBUG_ASSERT(!pending);
+  pending= true;
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+}
+
+
+/*
+  Wait for the pending request to complete.
+
+  @retval false  the redo log was synced
+  @retval true   the redo log sync failed
+*/
+
+bool Binlog_redo_sync::wait()
+{
+  bool res;
+  mysql_mutex_lock(&lock);
+  while (pending)
+    mysql_cond_wait(&cond, &lock);
+  res= error;
+  mysql_mutex_unlock(&lock);
+  return res;
+}
+
+
+void Binlog_redo_sync::thread_main()
+{
+  my_thread_init();
+  DBUG_ENTER("Binlog_redo_sync::thread_main");
+
+  mysql_mutex_lock(&lock);
+  for (;;)
+  {
+    while (!pending && !stop)
+      mysql_cond_wait(&cond, &lock);
+    if (!pending)
+      break;
+    mysql_mutex_unlock(&lock);
+    bool res= hton->flush_logs(hton);
+    mysql_mutex_lock(&lock);
+    error= res;
+    pending= false;
+    mysql_cond_broadcast(&cond);
+  }
+  mysql_mutex_unlock(&lock);
+
+  my_thread_end();
+
+  /* Signal that we are (almost) stopped. */
+  mysql_mutex_lock(&lock);
+  stop= false;
+  mysql_cond_broadcast(&cond);
+  mysql_mutex_unlock(&lock);
+  DBUG_VOID_RETURN;
+}
+
+
+pthread_handler_t binlog_redo_sync_thread(void *arg)
+{
+  ((Binlog_redo_sync *) arg)->thread_main();
+  return 0;
+}
+
+
+struct single_sync_engine_st
+{
+  handlerton *hton;
+  uint count;
+};
+
+static my_bool single_sync_engine_handlerton(THD *unused, plugin_ref plugin,
+                                             void *arg)
+{
+  handlerton *hton= plugin_hton(plugin);
+  single_sync_engine_st *info= (single_sync_engine_st *) arg;
+
+  if (hton != binlog_hton && hton->prepare)
+  {
+    info->hton= hton;
+    info->count++;
+  }
+  return FALSE;
+}
+
+
+/*
+  Check that binlog_single_sync_commit can be used, and start the redo
+  log sync thread.
+
+  The binlog must be the only other participant in two-phase commit
+  besides a single storage engine, which must be able to sync its redo log
+  on request and to tell how far in the binlog its commits are durable.
+
+  @retval false  ok
+  @retval true   binlog_single_sync_commit can't be used
+*/
+
+static bool binlog_single_sync_commit_init()
+{
+  single_sync_engine_st info= { NULL, 0 };
+
+#ifdef HAVE_REPLICATION
+  if (rpl_semi_sync_slave_enabled)
+  {
+    sql_print_warning("binlog_single_sync_commit can not be used together "
+                      "with rpl_semi_sync_slave_enabled; it is disabled");
+    return true;
+  }
+#endif
+  plugin_foreach(NULL, single_sync_engine_handlerton,
+                 MYSQL_STORAGE_ENGINE_PLUGIN, &info);
+  if (info.count != 1 || !info.hton->flush_logs ||
+      !info.hton->recovered_binlog_pos)
+  {
+    sql_print_warning("binlog_single_sync_commit needs exactly one "
+                      "transactional storage engine that supports it; "
+                      "it is disabled");
+    return true;
+  }
+  if (binlog_redo_sync.start(info.hton))
+  {
+    sql_print_warning("Could not start the binlog redo log sync thread; "
+                      "binlog_single_sync_commit is disabled");
+    return true;
+  }
+  return false;
+}
 #ifdef HAVE_REPLICATION
 class Recovery_context
 {
@@ -10844,6 +11950,22 @@ class Recovery_context
     Gets empited by reset_truncate_coord into gtid binlog state.
   */
   Dynamic_array<rpl_gtid> *gtid_maybe_to_truncate;
+  /*
+    When true, it's binlog_single_sync_commit recovery. The prepare of the
+    transactions in the last binlog group commit may then have been lost
+    by the storage engine. Those are found by the engine's durable binlog
+    position, and are removed from the binlog together with everything
+    logged behind the first of them.
+  */
+  bool check_lost;
+  char engine_binlog_file_name[FN_REFLEN];
+  ulonglong engine_binlog_pos;
+  /* The first lost transaction, and where its group starts */
+  rpl_gtid lost_gtid;
+  my_off_t lost_pos;
+  char lost_file_name[FN_REFLEN];
+  /* true when the current group is located behind lost_gtid */
+  bool last_gtid_behind_lost;
   Recovery_context();
   ~Recovery_context() { delete gtid_maybe_to_truncate; }
   /*
@@ -10852,7 +11974,9 @@ class Recovery_context
     in binlog, otherwise they are rolled back.
     In the semisync slave case the xids that are located in binlog in
     a truncated tail get rolled back, otherwise they are committed.
-    Both decisions are contingent on safety to truncate.
+    So are those behind a transaction lost by the engine with
+    binlog_single_sync_commit.
+    All decisions are contingent on safety to truncate.
   */
   bool complete(MYSQL_BIN_LOG *log, HASH &xids);
 
@@ -10896,18 +12020,37 @@ class Recovery_context
                            const char *binlog_checkpoint_name,
                            LOG_INFO *linfo, MYSQL_BIN_LOG *log);
   /*
-    Relates to the semisync recovery.
+    Relates to the semisync and binlog_single_sync_commit recovery.
     Returns true when truncated tail does not contain non-transactional
     group of events.
     Otherwise returns false.
   */
   bool is_safe_to_truncate()
   {
-    return !do_truncate ? true :
+    return !do_truncate ?
+      binlog_unsafe_gtid.seq_no == 0 :                 // nothing behind lost
       (truncate_gtid.seq_no == 0 ||                    // no truncate
        binlog_unsafe_coord < binlog_truncate_coord);   // or unsafe is earlier
   }
 
+  /*
+    Relates to the binlog_single_sync_commit recovery.
+    Returns true when the transaction of the current group, that the
+    engine does not have prepared, is not durably committed in the engine
+    either, that is, the group ends behind the engine's binlog position.
+  */
+  bool is_lost(LOG_INFO *linfo, my_off_t pos)
+  {
+    const char *name= linfo->log_file_name + dirname_length(linfo->log_file_name);
+    const char *engine_name= engine_binlog_file_name +
+      dirname_length(engine_binlog_file_name);
+    /*
+      Only the last binlog file can have lost transactions. If the engine
+      has no commit recorded in it, none of its transactions is committed.
+    */
+    return strcmp(name, engine_name) || pos > engine_binlog_pos;
+  }
+
   /*
     Relates to the semisync recovery.
     Is invoked when a standalone or non-2pc group is detected.
@@ -10951,7 +12094,7 @@ class Recovery_context
 
 bool Recovery_context::complete(MYSQL_BIN_LOG *log, HASH &xids)
 {
-  if (!do_truncate || is_safe_to_truncate())
+  if (is_safe_to_truncate())
   {
     uint count_in_prepare=
       ha_recover_complete(&xids,
@@ -10967,6 +12110,40 @@ bool Recovery_context::complete(MYSQL_BIN_LOG *log, HASH &xids)
     }
   }
 
+  if (lost_gtid.seq_no > 0)
+  {
+    char buf[21];
+    longlong10_to_str(lost_gtid.seq_no, buf, 10);
+    if (!is_safe_to_truncate())
+    {
+      sql_print_error("Transaction with GTID %u-%u-%s at file:%s pos:%llu "
+                      "was not prepared in the storage engine, but the "
+                      "binary log can not be truncated there as unsafe "
+                      "statement is found at file:%s pos:%llu which is "
+                      "beyond it; all transactions in doubt are left "
+                      "intact.",
+                      lost_gtid.domain_id, lost_gtid.server_id, buf,
+                      lost_file_name, (ulonglong) lost_pos,
+                      binlog_unsafe_file_name, binlog_unsafe_coord.second);
+      return true;
+    }
+    sql_print_warning("Transaction with GTID %u-%u-%s at file:%s pos:%llu "
+                      "was not prepared in the storage engine, which is "
+                      "possible with binlog_single_sync_commit. It and all "
+                      "transactions behind it are removed from the binary "
+                      "log.",
+                      lost_gtid.domain_id, lost_gtid.server_id, buf,
+                      lost_file_name, (ulonglong) lost_pos);
+    if (log->truncate_and_remove_binlogs(lost_file_name, lost_pos,
+                                         &lost_gtid))
+    {
+      sql_print_error("Failed to truncate the binary log to "
+                      "file:%s pos:%llu.", lost_file_name,
+                      (ulonglong) lost_pos);
+      return true;
+    }
+  }
+
   /* Truncation is not done when there's no transaction to roll back */
   if (do_truncate && truncate_gtid.seq_no > 0)
   {
@@ -11005,7 +12182,9 @@ Recovery_context::Recovery_context() :
   do_truncate(rpl_semi_sync_slave_enabled),
   truncate_validated(false), truncate_reset_done(false),
   truncate_set_in_1st(false), id_binlog(MAX_binlog_id),
-  checksum_alg(BINLOG_CHECKSUM_ALG_UNDEF), gtid_maybe_to_truncate(NULL)
+  checksum_alg(BINLOG_CHECKSUM_ALG_UNDEF), gtid_maybe_to_truncate(NULL),
+  check_lost(false), engine_binlog_pos(0), lost_pos(0),
+  last_gtid_behind_lost(false)
 {
   last_gtid_coord= Binlog_offset(0,0);
   binlog_truncate_coord=  binlog_truncate_coord_1st_round= Binlog_offset(0,0);
@@ -11015,6 +12194,17 @@ Recovery_context::Recovery_context() :
   binlog_unsafe_gtid= truncate_gtid= truncate_gtid_1st_round= rpl_gtid();
   if (do_truncate)
     gtid_maybe_to_truncate= new Dynamic_array<rpl_gtid>(16, 16);
+  lost_gtid= rpl_gtid();
+  engine_binlog_file_name[0]= 0;
+  lost_file_name[0]= 0;
+  if (opt_binlog_single_sync_commit && !do_truncate)
+  {
+    handlerton *hton= binlog_redo_sync.engine();
+    if (hton->recovered_binlog_pos(hton, engine_binlog_file_name,
+                                   &engine_binlog_pos))
+      engine_binlog_file_name[0]= 0;
+    check_lost= true;
+  }
 }
 
 bool Recovery_context::reset_truncate_coord(my_off_t pos)
@@ -11111,7 +12301,11 @@ bool Recovery_context::decide_or_assess(xid_recovery_member *member, int round,
     {
       if (!do_truncate) // "normal" recovery
       {
-        member->decided_to_commit= true;
+        /* Behind a lost transaction it is rolled back and removed */
+        if (last_gtid_behind_lost)
+          last_gtid_valid= false;
+        else
+          member->decided_to_commit= true;
       }
       else
       {
@@ -11165,6 +12359,18 @@ bool Recovery_context::decide_or_assess(xid_recovery_member *member, int round,
     if (!truncate_validated && reset_truncate_coord(pos))
       return true;
   }
+  else if (check_lost && round == 1 &&
+           (last_gtid_behind_lost || is_lost(linfo, pos)))
+  {
+    /* Neither prepared nor committed, so the engine lost the prepare */
+    if (lost_gtid.seq_no == 0)
+    {
+      lost_gtid= last_gtid;
+      lost_pos= last_gtid_coord.second;
+      strmake_buf(lost_file_name, linfo->log_file_name);
+    }
+    last_gtid_valid= false;
+  }
 
   return false;
 }
@@ -11172,7 +12378,21 @@ bool Recovery_context::decide_or_assess(xid_recovery_member *member, int round,
 void Recovery_context::update_binlog_unsafe_coord_if_needed(LOG_INFO *linfo)
 {
   if (!do_truncate)
+  {
+    /* As below, for the group behind a transaction lost by the engine */
+    if (last_gtid_behind_lost)
+    {
+      if (last_gtid_engines == 0)
+        last_gtid_valid= false;
+      else if (binlog_unsafe_gtid.seq_no == 0)
+      {
+        binlog_unsafe_gtid= last_gtid;
+        binlog_unsafe_coord= last_gtid_coord;
+        strmake_buf(binlog_unsafe_file_name, linfo->log_file_name);
+      }
+    }
     return;
+  }
 
   if (truncate_gtid.seq_no > 0 &&   // g1,U2, *not* G1,U2
       last_gtid_coord > binlog_truncate_coord)
@@ -11204,6 +12424,7 @@ void Recovery_context::process_gtid(int round, Gtid_log_event *gev,
   last_gtid_engines= gev->extra_engines != UCHAR_MAX ?
     gev->extra_engines + 1 : 0;
   last_gtid_coord= Binlog_offset(id_binlog, prev_event_pos);
+  last_gtid_behind_lost= (round == 1 && lost_gtid.seq_no > 0);
 
   DBUG_ASSERT(!last_gtid_valid);
   DBUG_ASSERT(last_gtid.seq_no != 0);
@@ -11215,7 +12436,7 @@ void Recovery_context::process_gtid(int round, Gtid_log_event *gev,
     last_gtid_no2pc= false;
     last_gtid_standalone=
       (gev->flags2 & Gtid_log_event::FL_STANDALONE) ? true : false;
-    if (do_truncate && last_gtid_standalone)
+    if ((do_truncate || last_gtid_behind_lost) && last_gtid_standalone)
       update_binlog_unsafe_coord_if_needed(linfo);
     /* Update the binlog state with any 'valid' GTID logged after Gtid_list. */
     last_gtid_valid= true;    // may flip at Xid when falls to truncate
@@ -11283,6 +12504,26 @@ int Recovery_context::next_binlog_or_round(int& round,
 }
 #endif
 
+/*
+  Check if the binary log has a range reserved for a large transaction that
+  was not written at POS, see MYSQL_BIN_LOG::reserve_cache_range(). Before
+  it is written, the range reads as zeros, and a complete event can not
+  start with a zero event length.
+*/
+
+static bool binlog_unwritten_range(IO_CACHE *log, my_off_t pos)
+{
+  uchar header[LOG_EVENT_HEADER_LEN];
+  my_b_seek(log, pos);
+  if (my_b_read(log, header, sizeof(header)))
+    return false;
+  for (uint i= 0; i < sizeof(header); i++)
+    if (header[i])
+      return false;
+  return true;
+}
+
+
 /*
   Execute recovery of the binary log
 
@@ -11292,11 +12533,17 @@ int Recovery_context::next_binlog_or_round(int& round,
                    used to disable entries in the ddl recovery log that
                    are found in the binary log (and thus already executed and
                    logged and thus don't have to be redone).
+  @param unwritten_pos
+         If not NULL, set to the end of the last complete event group in
+         the last binary log if a range reserved for a large transaction
+         was not written after it, or to 0. The binary log must be
+         truncated there, see binlog_unwritten_range().
 */
 
 int TC_LOG_BINLOG::recover(LOG_INFO *linfo, const char *last_log_name,
                            IO_CACHE *first_log,
-                           Format_description_log_event *fdle, bool do_xa)
+                           Format_description_log_event *fdle, bool do_xa,
+                           my_off_t *unwritten_pos)
 {
   Log_event *ev= NULL;
   HASH xids, ddl_log_ids;
@@ -11322,7 +12569,11 @@ int TC_LOG_BINLOG::recover(LOG_INFO *linfo, const char *last_log_name,
     binlog file is reached.
   */
   int round;
+  /* In the last binary log, the end of the last event and event group */
+  my_off_t event_end= my_b_tell(first_log), group_end= event_end;
 
+  if (unwritten_pos)
+    *unwritten_pos= 0;
   if (! fdle->is_valid() ||
       (my_hash_init(key_memory_binlog_recover_exec, &xids,
                     &my_charset_bin, TC_LOG_PAGE_SIZE/3, 0,
@@ -11475,10 +12726,22 @@ int TC_LOG_BINLOG::recover(LOG_INFO *linfo, const char *last_log_name,
       }
       ctx.prev_event_pos= ev->log_pos;
 #endif
+      if (round == 1)
+      {
+        event_end= my_b_tell(first_log);
+#ifdef HAVE_REPLICATION
+        if (!ctx.last_gtid_valid)
+#endif
+          group_end= event_end;
+      }
       delete ev;
       ev= NULL;
     } // end of while
 
+    if (round == 1 && unwritten_pos &&
+        binlog_unwritten_range(first_log, event_end))
+      *unwritten_pos= group_end;
+
     /*
       If the last binlog checkpoint event points to an older log, we have to
       scan all logs from there also, to get all possible XIDs to recover.
@@ -11591,6 +12854,7 @@ MYSQL_BIN_LOG::do_binlog_recovery(const char *opt_name, bool do_xa_recovery)
   Log_event  *ev= 0;
   Format_description_log_event fdle(BINLOG_VERSION);
   char        log_name[FN_REFLEN];
+  my_off_t    unwritten_pos= 0;
   int error;
 
   if (unlikely((error= find_log_pos(&log_info, NullS, 1))))
@@ -11646,7 +12910,8 @@ MYSQL_BIN_LOG::do_binlog_recovery(const char *opt_name, bool do_xa_recovery)
     {
       sql_print_information("Recovering after a crash using %s", opt_name);
       error= recover(&log_info, log_name, &log,
-                     (Format_description_log_event *)ev, do_xa_recovery);
+                     (Format_description_log_event *)ev, do_xa_recovery,
+                     &unwritten_pos);
     }
     else
     {
@@ -11681,6 +12946,50 @@ MYSQL_BIN_LOG::do_binlog_recovery(const char *opt_name, bool do_xa_recovery)
   end_io_cache(&log);
   mysql_file_close(file, MYF(MY_WME));
 
+  if (!error && unwritten_pos)
+    error= truncate_unwritten_range(log_name, unwritten_pos);
+  return error;
+}
+
+
+/*
+  Truncate the binary log that was in use at a crash at POS, the end of the
+  last complete event group before a range reserved for a large transaction
+  that was not written, see binlog_reserved_range_failed(). Events after
+  the range belong to transactions that recovery rolled back, and dump
+  threads and mysqlbinlog could not read past it.
+*/
+
+int MYSQL_BIN_LOG::truncate_unwritten_range(const char *log_name,
+                                            my_off_t pos)
+{
+  File file;
+  MY_STAT stat;
+  int error= 0;
+
+  if ((file= mysql_file_open(key_file_binlog, log_name,
+                             O_RDWR | O_BINARY, MYF(MY_WME))) < 0)
+    return 1;
+  /* Semi-sync recovery may have truncated it already */
+  if (my_fstat(file, &stat, MYF(MY_WME)))
+    error= 1;
+  else if ((my_off_t) stat.st_size > pos)
+  {
+    if ((error= (mysql_file_chsize(file, pos, 0, MYF(MY_WME)) ||
+                 mysql_file_sync(file, MYF(MY_WME | MY_SYNC_FILESIZE)))))
+      sql_print_error("Failed to truncate the binary log '%s' to %llu",
+                      log_name, (ulonglong) pos);
+    else
+    {
+      /* The GTID index of the file may point past the new end */
+      gtid_index_delete(log_name);
+      sql_print_warning("Truncated the binary log '%s' from %llu to %llu "
+                        "bytes, at a transaction that was not completely "
+                        "written to it",
+                        log_name, (ulonglong) stat.st_size, (ulonglong) pos);
+    }
+  }
+  mysql_file_close(file, MYF(MY_WME));
   return error;
 }
 
@@ -20,6 +20,7 @@
 #include "handler.h"                            /* my_xid */
 #include "wsrep_mysqld.h"
 #include "rpl_constants.h"
+#include "gtid_index.h"
 
 class Relay_log_info;
 
@@ -535,6 +536,13 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   */
   my_bool group_commit_queue_busy;
   mysql_cond_t COND_queue_busy;
+  /*
+    Set while a group commit writes large transaction caches into ranges of
+    the binlog that it reserved; see write_reserved_caches(). Protected by
+    LOCK_binlog_end_pos and signalled with COND_cache_fill.
+  */
+  bool cache_fill_pending;
+  mysql_cond_t COND_cache_fill;
   /* Total number of committed transactions. */
   ulonglong num_commits;
   /* Number of group commits done. */
@@ -552,6 +560,8 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   */
   uint *sync_period_ptr;
   uint sync_counter;
+  /* Sparse GTID index of the binlog file being written */
+  Gtid_index_writer gtid_index;
   bool state_file_deleted;
   bool binlog_state_recover_done;
 
@@ -721,8 +731,10 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   int unlog_xa_prepare(THD *thd, bool all);
   void commit_checkpoint_notify(void *cookie);
   int recover(LOG_INFO *linfo, const char *last_log_name, IO_CACHE *first_log,
-              Format_description_log_event *fdle, bool do_xa);
+              Format_description_log_event *fdle, bool do_xa,
+              my_off_t *unwritten_pos= NULL);
   int do_binlog_recovery(const char *opt_name, bool do_xa_recovery);
+  int truncate_unwritten_range(const char *log_name, my_off_t pos);
 #if !defined(MYSQL_CLIENT)
 
   int flush_and_set_pending_rows_event(THD *thd, Rows_log_event* event,
@@ -766,6 +778,17 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
     mysql_cond_broadcast(&COND_bin_log_updated);
     DBUG_VOID_RETURN;
   }
+  /*
+    Wait for the group commit that writes the binlog ranges it reserved
+    for large transaction caches after it released LOCK_log; the binlog
+    must not be read or rotated past them before that.
+  */
+  void wait_for_cache_fill()
+  {
+    mysql_mutex_assert_owner(&LOCK_binlog_end_pos);
+    while (unlikely(cache_fill_pending))
+      mysql_cond_wait(&COND_cache_fill, &LOCK_binlog_end_pos);
+  }
   void update_binlog_end_pos()
   {
     if (is_relay_log)
@@ -773,6 +796,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
     else
     {
       lock_binlog_end_pos();
+      wait_for_cache_fill();
       binlog_end_pos= my_b_safe_tell(&log_file);
       signal_bin_log_update();
       unlock_binlog_end_pos();
@@ -783,6 +807,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
     mysql_mutex_assert_owner(&LOCK_log);
     mysql_mutex_assert_not_owner(&LOCK_binlog_end_pos);
     lock_binlog_end_pos();
+    wait_for_cache_fill();
     /*
       Note: it would make more sense to assert(pos > binlog_end_pos)
       but there are two places triggered by mtr that has pos == binlog_end_pos
@@ -822,7 +847,13 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
   bool write_incident_already_locked(THD *thd);
   bool write_incident(THD *thd);
   void write_binlog_checkpoint_event_already_locked(const char *name, uint len);
-  int  write_cache(THD *thd, IO_CACHE *cache);
+  int  write_cache(THD *thd, IO_CACHE *cache) {
+    return write_cache(thd, cache, &log_file);
+  }
+  int  write_cache(THD *thd, IO_CACHE *cache, IO_CACHE *file);
+  int  write_payload_or_cache(THD *thd, binlog_cache_data *cache_data);
+  int  reserve_cache_range(THD *thd, binlog_cache_data *cache_data);
+  bool write_reserved_caches(group_commit_entry *queue, bool synced);
   void set_write_error(THD *thd, bool is_transactional);
   bool check_write_error(THD *thd);
 
@@ -860,6 +891,7 @@ class MYSQL_BIN_LOG: public TC_LOG, private MYSQL_LOG
      @retval other Failure
   */
   bool flush_and_sync(bool *synced);
+  bool flush_relay_log_append();
   int purge_logs(const char *to_log, bool included,
                  bool need_mutex, bool need_update_threads,
                  ulonglong *decrease_log_space);
@@ -1144,6 +1176,18 @@ enum enum_binlog_format {
   BINLOG_FORMAT_UNSPEC=3  ///< thd_binlog_format() returns it when binlog is closed
 };
 
+/* Values of binlog_transaction_dependency_tracking */
+enum enum_binlog_dependency_tracking {
+  BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER= 0, ///< commit_id from group commit
+  BINLOG_DEPENDENCY_TRACKING_WRITESET=     1  ///< commit_id from writesets
+};
+
+/*
+  Max number of unique key hashes collected for one transaction; larger
+  transactions are treated as conflicting with everything.
+*/
+#define BINLOG_WRITESET_MAX_KEYS 4096
+
 int query_error_code(THD *thd, bool not_killed);
 uint purge_log_get_error_code(int res);
 
@@ -1177,6 +1221,9 @@ File open_binlog(IO_CACHE *log, const char *log_file_name,
 void make_default_log_name(char **out, const char* log_ext, bool once);
 void binlog_reset_cache(THD *thd);
 bool write_annotated_row(THD *thd);
+void binlog_add_writeset(THD *thd, bool is_trans, TABLE *table,
+                         const uchar *record, const MY_BITMAP *cols,
+                         const MY_BITMAP *changed_cols);
 
 extern MYSQL_PLUGIN_IMPORT MYSQL_BIN_LOG mysql_bin_log;
 extern handlerton *binlog_hton;
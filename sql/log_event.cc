@@ -52,6 +52,9 @@
 #include "rpl_constants.h"
 #include "sql_digest.h"
 #include "zlib.h"
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include "myisampack.h"
 #include <algorithm>
 
@@ -698,6 +701,7 @@ const char* Log_event::get_type_str(Log_event_type type)
   case WRITE_ROWS_COMPRESSED_EVENT_V1: return "Write_rows_compressed_v1";
   case UPDATE_ROWS_COMPRESSED_EVENT_V1: return "Update_rows_compressed_v1";
   case DELETE_ROWS_COMPRESSED_EVENT_V1: return "Delete_rows_compressed_v1";
+  case TRANSACTION_PAYLOAD_EVENT: return "Transaction_payload";
 
   default: return "Unknown";				/* impossible */
   }
@@ -1065,8 +1069,14 @@ Log_event* Log_event::read_log_event(const uchar *buf, uint event_len,
 #endif
   }
 
+  /*
+    Transaction payload events are not in the post-header table
+    (see LOG_EVENT_TYPES).
+  */
   if (event_type > fdle->number_of_event_types &&
-      event_type != FORMAT_DESCRIPTION_EVENT)
+      event_type != FORMAT_DESCRIPTION_EVENT &&
+      (event_type != TRANSACTION_PAYLOAD_EVENT ||
+       fdle->event_type_permutation))
   {
     /*
       It is unsafe to use the fdle if its post_header_len
@@ -1238,6 +1248,9 @@ Log_event* Log_event::read_log_event(const uchar *buf, uint event_len,
     case INCIDENT_EVENT:
       ev= new Incident_log_event(buf, event_len, fdle);
       break;
+    case TRANSACTION_PAYLOAD_EVENT:
+      ev= new Transaction_payload_log_event(buf, event_len, fdle);
+      break;
     case ANNOTATE_ROWS_EVENT:
       ev= new Annotate_rows_log_event(buf, event_len, fdle);
       break;
@@ -2569,6 +2582,126 @@ Binlog_checkpoint_log_event::Binlog_checkpoint_log_event(
 }
 
 
+/**************************************************************************
+  Transaction_payload_log_event methods
+**************************************************************************/
+
+Transaction_payload_log_event::Transaction_payload_log_event(
+       const uchar *buf, uint event_len,
+       const Format_description_log_event *description_event)
+  :Log_event(buf, description_event), compression_type(0),
+   uncompressed_size(0), payload(0), payload_size(0)
+{
+  uint8 header_size= description_event->common_header_len;
+  if (event_len < (uint) header_size + TRANSACTION_PAYLOAD_HEADER_LEN)
+    return;
+  buf+= header_size;
+  compression_type= buf[0];
+  uncompressed_size= uint4korr(buf + 1);
+  payload= buf + TRANSACTION_PAYLOAD_HEADER_LEN;
+  payload_size= event_len - header_size - TRANSACTION_PAYLOAD_HEADER_LEN;
+}
+
+
+/**
+  Uncompress the events of a payload event, to be returned by read_event().
+
+  @return false on success, true on error with *error set
+*/
+
+bool Transaction_payload_reader::load(Transaction_payload_log_event *ev,
+                                      const char **error)
+{
+  reset();
+  if (ev->compression_type != Transaction_payload_log_event::COMPRESSION_ZSTD ||
+      ev->uncompressed_size > MAX_MAX_ALLOWED_PACKET)
+  {
+    *error= "Invalid transaction payload event";
+    return true;
+  }
+#ifdef HAVE_ZSTD
+  if (buf_size < ev->uncompressed_size)
+  {
+    uchar *new_buf= (uchar *) my_realloc(PSI_INSTRUMENT_ME, buf,
+                                         ev->uncompressed_size,
+                                         MYF(MY_ALLOW_ZERO_PTR | MY_WME));
+    if (!new_buf)
+    {
+      *error= "Out of memory";
+      return true;
+    }
+    buf= new_buf;
+    buf_size= ev->uncompressed_size;
+  }
+  size_t len= ZSTD_decompress(buf, ev->uncompressed_size,
+                              ev->payload, ev->payload_size);
+  if (ZSTD_isError(len) || len != ev->uncompressed_size)
+  {
+    *error= "Transaction payload uncompress failed";
+    return true;
+  }
+  cur= buf;
+  end= buf + len;
+  log_pos= ev->log_pos;
+  return false;
+#else
+  *error= "Transaction payload events need a build with zstd";
+  return true;
+#endif
+}
+
+
+/**
+  Return the next event of the payload loaded. The event owns its buffer,
+  and gets the end_log_pos of the payload event.
+
+  @return the event, or NULL on error with *error set
+*/
+
+Log_event *
+Transaction_payload_reader::read_event(const Format_description_log_event *fdle,
+                                       my_bool crc_check, const char **error)
+{
+  Log_event *ev;
+  uchar *event_buf;
+  uint event_len;
+  DBUG_ASSERT(has_events());
+
+  if ((size_t) (end - cur) < LOG_EVENT_MINIMAL_HEADER_LEN ||
+      (event_len= uint4korr(cur + EVENT_LEN_OFFSET)) <
+      LOG_EVENT_MINIMAL_HEADER_LEN ||
+      event_len > (size_t) (end - cur))
+  {
+    *error= "Event truncated";
+    reset();
+    return NULL;
+  }
+  if (!(event_buf= (uchar *) my_malloc(PSI_INSTRUMENT_ME, event_len,
+                                       MYF(MY_WME))))
+  {
+    *error= "Out of memory";
+    reset();
+    return NULL;
+  }
+  memcpy(event_buf, cur, event_len);
+  cur+= event_len;
+
+  *error= NULL;
+  if (!(ev= Log_event::read_log_event(event_buf, event_len, error, fdle,
+                                      crc_check)))
+  {
+    my_free(event_buf);
+    if (!*error)
+      *error= "Found invalid event in transaction payload";
+    reset();
+    return NULL;
+  }
+  ev->register_temp_buf(event_buf, true);
+  ev->log_pos= log_pos;
+  return ev;
+}
+
+
 /**************************************************************************
         Global transaction ID stuff
 **************************************************************************/
@@ -3245,7 +3378,7 @@ Rows_log_event::Rows_log_event(const uchar *buf, uint event_len,
     m_extra_row_data(0)
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
     , m_curr_row(NULL), m_curr_row_end(NULL),
-    m_key(NULL), m_key_info(NULL), m_key_nr(0),
+    m_key(NULL), m_key_info(NULL), m_key_nr(0), m_hash_scan(NULL),
     master_had_triggers(0)
 #endif
 {
@@ -223,6 +223,7 @@ class String;
 #define GTID_LIST_HEADER_LEN   4
 #define START_ENCRYPTION_HEADER_LEN 0
 #define XA_PREPARE_HEADER_LEN 0
+#define TRANSACTION_PAYLOAD_HEADER_LEN 5
 
 /* 
   Max number of possible extra bytes in a replication event compared to a
@@ -739,6 +740,14 @@ enum Log_event_type
   UPDATE_ROWS_COMPRESSED_EVENT = 170,
   DELETE_ROWS_COMPRESSED_EVENT = 171,
 
+  /*
+    The events of a transaction, compressed together into one block
+    (binlog_transaction_compression). The event group is still started by
+    its Gtid event and ended by its XID or COMMIT event, which are not part
+    of the payload.
+  */
+  TRANSACTION_PAYLOAD_EVENT = 172,
+
   /* Add new MariaDB events here - right above this comment!  */
 
   ENUM_END_EVENT /* end marker */
@@ -811,8 +820,12 @@ static inline bool LOG_EVENT_IS_ROW_V2(enum Log_event_type type)
    The number of types we handle in Format_description_log_event (UNKNOWN_EVENT
    is not to be handled, it does not exist in binlogs, it does not have a
    format).
+
+   TRANSACTION_PAYLOAD_EVENT is not in the post-header table, so that the
+   format description event keeps its size; its post-header length is
+   always TRANSACTION_PAYLOAD_HEADER_LEN.
 */
-#define LOG_EVENT_TYPES (ENUM_END_EVENT-1)
+#define LOG_EVENT_TYPES (TRANSACTION_PAYLOAD_EVENT-1)
 
 enum Int_event_type
 {
@@ -828,6 +841,7 @@ class THD;
 class Format_description_log_event;
 class Relay_log_info;
 class binlog_cache_data;
+class Rows_hash_scan;
 
 bool copy_event_cache_to_file_and_reinit(IO_CACHE *cache, FILE *file);
 
@@ -1610,6 +1624,7 @@ class Log_event
     case USER_VAR_EVENT:
     case TABLE_MAP_EVENT:
     case ANNOTATE_ROWS_EVENT:
+    case TRANSACTION_PAYLOAD_EVENT:
       return true;
     case DELETE_ROWS_EVENT:
     case UPDATE_ROWS_EVENT:
@@ -3597,6 +3612,97 @@ class Binlog_checkpoint_log_event: public Log_event
 };
 
 
+/**
+  @class Transaction_payload_log_event
+
+  The events of a binlog cache (a transaction or a statement), compressed
+  together into one block. It is written with binlog_transaction_compression
+  between the Gtid event and the XID or COMMIT event of the event group.
+
+  The events in the payload are stored as they would have been written to
+  the binlog, with the checksums of the binlog they are in, except that their
+  end_log_pos is 0. When they are read back (Transaction_payload_reader), they
+  get the end_log_pos of the payload event.
+
+  @section Transaction_payload_log_event_binary_format Binary Format
+
+  Post-header:
+    1 byte   compression algorithm (COMPRESSION_ZSTD)
+    4 bytes  size of the events when uncompressed
+
+  Body:
+    the compressed events, extending to the end of the event
+*/
+
+class Transaction_payload_log_event: public Log_event
+{
+public:
+  enum { COMPRESSION_ZSTD= 1 };
+
+  uint8 compression_type;
+  uint32 uncompressed_size;
+  /* Points into the event buffer, or to the caller's buffer when writing */
+  const uchar *payload;
+  uint32 payload_size;
+
+#ifdef MYSQL_SERVER
+  Transaction_payload_log_event(THD *thd_arg, const uchar *payload_arg,
+                                uint32 payload_size_arg,
+                                uint32 uncompressed_size_arg);
+#ifdef HAVE_REPLICATION
+  void pack_info(Protocol *protocol);
+#endif
+#else
+  bool print(FILE *file, PRINT_EVENT_INFO *print_event_info);
+#endif
+  Transaction_payload_log_event(const uchar *buf, uint event_len,
+                                const Format_description_log_event
+                                *description_event);
+  Log_event_type get_type_code() { return TRANSACTION_PAYLOAD_EVENT; }
+  int get_data_size() { return TRANSACTION_PAYLOAD_HEADER_LEN + payload_size; }
+  bool is_valid() const { return payload != 0; }
+#ifdef MYSQL_SERVER
+  bool write();
+#if defined(HAVE_REPLICATION)
+  virtual int do_apply_event(rpl_group_info *rgi);
+#endif
+#endif
+};
+
+
+/**
+  Returns the events of a Transaction_payload_log_event one at a time.
+
+  The slave SQL thread, the retry of an event group in parallel replication
+  and mysqlbinlog use this to process the events of a payload as if they
+  had been read from the log one after another.
+*/
+
+class Transaction_payload_reader
+{
+public:
+  Transaction_payload_reader()
+    : buf(0), buf_size(0), cur(0), end(0), log_pos(0)
+  {}
+  ~Transaction_payload_reader() { my_free(buf); }
+
+  /* True if there are events left from the last payload loaded */
+  bool has_events() const { return cur < end; }
+  /* Forget the events left, if any */
+  void reset() { cur= end= 0; }
+  bool load(Transaction_payload_log_event *ev, const char **error);
+  Log_event *read_event(const Format_description_log_event *fdle,
+                        my_bool crc_check, const char **error);
+
+private:
+  uchar *buf;
+  size_t buf_size;
+  /* The next event to return, and the end of the uncompressed events */
+  uchar *cur, *end;
+  my_off_t log_pos;
+};
+
+
 /**
   @class Gtid_log_event
 
@@ -5278,10 +5384,13 @@ class Rows_log_event : public Log_event
   uchar    *m_key;      /* Buffer to keep key value during searches */
   KEY      *m_key_info; /* Pointer to KEY info for m_key_nr */
   uint      m_key_nr;   /* Key number */
+  Rows_hash_scan *m_hash_scan; /* Rows located by hash_scan_table() */
   bool master_had_triggers;     /* set after tables opening */
 
   int find_key(); // Find a best key to use in find_row()
   int find_row(rpl_group_info *);
+  int hash_scan_table(rpl_group_info *);
+  void free_hash_scan();
   int write_row(rpl_group_info *, const bool);
   int update_sequence();
 
@@ -3559,6 +3559,57 @@ bool Binlog_checkpoint_log_event::write()
 }
 
 
+/**************************************************************************
+  Transaction_payload_log_event methods
+**************************************************************************/
+
+Transaction_payload_log_event::Transaction_payload_log_event(
+        THD *thd_arg, const uchar *payload_arg, uint32 payload_size_arg,
+        uint32 uncompressed_size_arg)
+  :Log_event(thd_arg, 0, true), compression_type(COMPRESSION_ZSTD),
+   uncompressed_size(uncompressed_size_arg), payload(payload_arg),
+   payload_size(payload_size_arg)
+{
+  cache_type= EVENT_NO_CACHE;
+}
+
+
+bool Transaction_payload_log_event::write()
+{
+  uchar buf[TRANSACTION_PAYLOAD_HEADER_LEN];
+  buf[0]= compression_type;
+  int4store(buf + 1, uncompressed_size);
+  return write_header(TRANSACTION_PAYLOAD_HEADER_LEN + payload_size) ||
+         write_data(buf, TRANSACTION_PAYLOAD_HEADER_LEN) ||
+         write_data(payload, payload_size) ||
+         write_footer();
+}
+
+
+#if defined(HAVE_REPLICATION)
+void Transaction_payload_log_event::pack_info(Protocol *protocol)
+{
+  char buf[64];
+  size_t len= my_snprintf(buf, sizeof(buf), "zstd, %u bytes, %u uncompressed",
+                          payload_size, uncompressed_size);
+  protocol->store(buf, len, &my_charset_bin);
+}
+
+
+/*
+  The slave applies the events in the payload (see Transaction_payload_reader)
+  instead of the payload event. Getting here means that something, like a
+  BINLOG statement, tried to apply the payload as one event.
+*/
+int Transaction_payload_log_event::do_apply_event(rpl_group_info *rgi)
+{
+  rgi->rli->report(ERROR_LEVEL, ER_BINLOG_UNCOMPRESS_ERROR, rgi->gtid_info(),
+                   "%s", ER_THD(thd, ER_BINLOG_UNCOMPRESS_ERROR));
+  return 1;
+}
+#endif
+
+
 /**************************************************************************
         Global transaction ID stuff
 **************************************************************************/
@@ -5545,7 +5596,7 @@ Rows_log_event::Rows_log_event(THD *thd_arg, TABLE *tbl_arg, ulong tid,
     m_type(event_type), m_extra_row_data(0)
 #ifdef HAVE_REPLICATION
     , m_curr_row(NULL), m_curr_row_end(NULL),
-    m_key(NULL), m_key_info(NULL), m_key_nr(0),
+    m_key(NULL), m_key_info(NULL), m_key_nr(0), m_hash_scan(NULL),
     master_had_triggers(0)
 #endif
 {
@@ -8127,6 +8178,241 @@ static int row_not_found_error(rpl_group_info *rgi)
          ? HA_ERR_KEY_NOT_FOUND : HA_ERR_RECORD_CHANGED;
 }
 
+/*
+  The before images of an Update/Delete rows event, located in a table
+  without a usable key with one table scan. Without it find_row() would
+  scan the whole table for every row of the event.
+*/
+
+class Rows_hash_scan
+{
+public:
+  struct Row
+  {
+    const uchar *row;        /* Start of the before image in the event */
+    ulong hash;              /* row_hash() of the before image */
+    bool found;              /* An equal row was found in the table */
+  };
+
+  Rows_hash_scan()
+    : rows(PSI_INSTRUMENT_MEM, 64, 64), by_hash(PSI_INSTRUMENT_MEM, 64, 64),
+      refs(NULL), ref_length(0)
+  {}
+  ~Rows_hash_scan() { my_free(refs); }
+
+  /* Find the before image starting at row_start */
+  Row *find(const uchar *row_start)
+  {
+    size_t low= 0, high= rows.elements();
+    while (low < high)
+    {
+      size_t mid= (low + high) / 2;
+      if (rows.at(mid).row < row_start)
+        low= mid + 1;
+      else
+        high= mid;
+    }
+    if (low < rows.elements() && rows.at(low).row == row_start)
+      return &rows.at(low);
+    return NULL;
+  }
+
+  /* First position in by_hash with a hash not less than the given one */
+  size_t lower_bound(ulong hash)
+  {
+    size_t low= 0, high= by_hash.elements();
+    while (low < high)
+    {
+      size_t mid= (low + high) / 2;
+      if (by_hash.at(mid)->hash < hash)
+        low= mid + 1;
+      else
+        high= mid;
+    }
+    return low;
+  }
+
+  /* handler::position() of the table row found for a before image */
+  uchar *ref(const Row *row)
+  {
+    return refs + (row - rows.front()) * ref_length;
+  }
+
+  Dynamic_array<Row> rows;       /* In event order */
+  Dynamic_array<Row*> by_hash;   /* Sorted on hash */
+  uchar *refs;
+  uint ref_length;
+};
+
+
+static int cmp_hash_scan_row(Rows_hash_scan::Row *const *a,
+                             Rows_hash_scan::Row *const *b)
+{
+  return (*a)->hash < (*b)->hash ? -1 : (*a)->hash > (*b)->hash ? 1 : 0;
+}
+
+
+/*
+  Hash of table->record[0]. Rows that record_compare() considers equal
+  have the same hash.
+*/
+
+static ulong row_hash(TABLE *table)
+{
+  ulong nr1= 1, nr2= 4;
+  for (Field **ptr= table->field; *ptr; ptr++)
+  {
+    /* Field::hash() does not look at blob data, record_compare() does */
+    if (((*ptr)->flags & BLOB_FLAG) ||
+        (table->versioned() && (*ptr)->vers_sys_field()))
+      continue;
+    (*ptr)->hash(&nr1, &nr2);
+  }
+  return nr1;
+}
+
+
+/**
+  Locate the before images from the current row to the end of the event
+  with one scan of the table.
+
+  All before images are unpacked and hashed, then every table row is
+  compared with the not yet found before images with the same hash. Each
+  before image is matched to a different table row, whose position is
+  saved in m_hash_scan for find_row() to read with rnd_pos().
+
+  @returns Error code on failure, 0 on success.
+
+  @post m_curr_row and m_curr_row_end are unchanged; record[0] and
+  record[1] are overwritten.
+*/
+
+int Rows_log_event::hash_scan_table(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  const uchar *saved_row= m_curr_row, *saved_row_end= m_curr_row_end;
+  const bool is_update= get_general_type_code() == UPDATE_ROWS_EVENT;
+  size_t remaining;
+  int error= 0, unpack_error= 0;
+  DBUG_ENTER("Rows_log_event::hash_scan_table");
+
+  free_hash_scan();
+  if (!(m_hash_scan= new Rows_hash_scan()))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+
+  while (m_curr_row < m_rows_end)
+  {
+    Rows_hash_scan::Row row;
+    prepare_record(table, m_width, FALSE);
+    if ((unpack_error= unpack_current_row(rgi)))
+      break;
+    row.row= m_curr_row;
+    row.hash= row_hash(table);
+    row.found= false;
+    if (m_hash_scan->rows.append(row))
+    {
+      error= HA_ERR_OUT_OF_MEM;
+      goto end;
+    }
+    m_curr_row= m_curr_row_end;
+    if (is_update)
+    {
+      /* Skip the after image */
+      if ((unpack_error= unpack_current_row(rgi, &m_cols_ai)))
+        break;
+      m_curr_row= m_curr_row_end;
+    }
+  }
+
+  /*
+    A row that can not be unpacked ends the scan; find_row() will get the
+    error when it comes to that row.
+  */
+  if (!(remaining= m_hash_scan->rows.elements()))
+  {
+    error= unpack_error ? unpack_error : HA_ERR_END_OF_FILE;
+    goto end;
+  }
+
+  for (size_t i= 0; i < remaining; i++)
+    m_hash_scan->by_hash.append(&m_hash_scan->rows.at(i));
+  m_hash_scan->by_hash.sort(cmp_hash_scan_row);
+  m_hash_scan->ref_length= table->file->ref_length;
+  if (m_hash_scan->by_hash.elements() != remaining ||
+      !(m_hash_scan->refs= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                              remaining *
+                                              m_hash_scan->ref_length,
+                                              MYF(MY_WME))))
+  {
+    error= HA_ERR_OUT_OF_MEM;
+    goto end;
+  }
+
+  DBUG_PRINT("info",("locating %zu records using hash scan", remaining));
+  /* We use this to test that the correct key is used in test cases. */
+  DBUG_EXECUTE_IF("slave_crash_if_table_scan", abort(););
+
+  if (unlikely((error= table->file->ha_rnd_init_with_error(1))))
+    goto end;
+
+  while (remaining &&
+         !(error= table->file->ha_rnd_next(table->record[0])))
+  {
+    ulong hash= row_hash(table);
+    bool positioned= false;
+    for (size_t i= m_hash_scan->lower_bound(hash);
+         i < m_hash_scan->by_hash.elements() &&
+         m_hash_scan->by_hash.at(i)->hash == hash;
+         i++)
+    {
+      Rows_hash_scan::Row *row= m_hash_scan->by_hash.at(i);
+      if (row->found)
+        continue;
+      if (!positioned)
+      {
+        table->file->position(table->record[0]);
+        store_record(table, record[1]);
+        positioned= true;
+      }
+      m_curr_row= row->row;
+      prepare_record(table, m_width, FALSE);
+      if (unpack_current_row(rgi))
+        continue;
+      if (table->versioned() && table->vers_end_field()->val_int() == 0)
+        table->vers_end_field()->set_max();
+      if (!record_compare(table))
+      {
+        row->found= true;
+        memcpy(m_hash_scan->ref(row), table->file->ref,
+               m_hash_scan->ref_length);
+        remaining--;
+        break;
+      }
+    }
+  }
+  table->file->ha_rnd_end();
+
+  if (error == HA_ERR_END_OF_FILE)
+    error= 0;
+  else if (unlikely(error))
+    table->file->print_error(error, MYF(0));
+
+end:
+  m_curr_row= saved_row;
+  m_curr_row_end= saved_row_end;
+  if (unlikely(error))
+    free_hash_scan();
+  DBUG_RETURN(error);
+}
+
+
+void Rows_log_event::free_hash_scan()
+{
+  delete m_hash_scan;
+  m_hash_scan= NULL;
+}
+
+
 /**
   Locate the current row in event's table.
 
@@ -8380,6 +8666,38 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
       }
     }
   }
+  else if (!(table->file->ha_table_flags() & HA_SLOW_RND_POS))
+  {
+    Rows_hash_scan::Row *row;
+    if (!m_hash_scan || !(row= m_hash_scan->find(m_curr_row)))
+    {
+      if (unlikely((error= hash_scan_table(rgi))))
+        goto end;
+      row= m_hash_scan->find(m_curr_row);
+    }
+    DBUG_ASSERT(row);
+
+    is_table_scan= true;
+
+    if (!row->found)
+    {
+      DBUG_PRINT("info", ("Record not found"));
+      error= HA_ERR_END_OF_FILE;
+      goto end;
+    }
+
+    DBUG_PRINT("info",("locating record found by hash scan (rnd_pos)"));
+    if (unlikely((error= table->file->ha_rnd_init_with_error(0))))
+      goto end;
+    if (unlikely((error= table->file->ha_rnd_pos(table->record[0],
+                                                 m_hash_scan->ref(row)))))
+    {
+      DBUG_PRINT("info",("rnd_pos returns error %d",error));
+      table->file->print_error(error, MYF(0));
+      table->file->ha_rnd_end();
+      goto end;
+    }
+  }
   else
   {
     DBUG_PRINT("info",("locating record using table scan (rnd_next)"));
@@ -8500,6 +8818,7 @@ Delete_rows_log_event::do_after_row_operations(const Slave_reporting_capability
   my_free(m_key);
   m_key= NULL;
   m_key_info= NULL;
+  free_hash_scan();
 
   return error;
 }
@@ -8661,6 +8980,7 @@ Update_rows_log_event::do_after_row_operations(const Slave_reporting_capability
   my_free(m_key); // Free for multi_malloc
   m_key= NULL;
   m_key_info= NULL;
+  free_hash_scan();
 
   return error;
 }
@@ -0,0 +1,128 @@
+/*
+   Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*************************************************************************
+  Asynchronous read-ahead of IO_CACHEs opened with MY_READ_AHEAD
+
+  mysys cannot use tpool, so the server provides the reads to mysys
+  through _my_b_aio_read. They are done by a thread pool of their own,
+  with io_uring if it is available, or with pread() in the pool threads
+  otherwise. Native aio is not used on Windows, as the files of IO_CACHEs
+  are not opened for overlapped IO.
+*/
+
+#include "../mysys/mysys_priv.h"
+#include "log.h"
+#include "mysqld.h"
+#include <tpool.h>
+#include <new>
+
+static tpool::thread_pool *io_cache_pool;
+
+/* Maximum number of read-aheads in flight, for the io_uring queue */
+static const int IO_CACHE_AIO_MAX_IO= 256;
+
+static void io_cache_aio_complete(void *arg)
+{
+  tpool::aiocb *cb= static_cast<tpool::aiocb*>(arg);
+  IO_CACHE_AIO *aio;
+  memcpy(&aio, cb->m_userdata, sizeof aio);
+  /* A partial read is finished synchronously, which moves m_buffer */
+  size_t length= (uchar*) cb->m_buffer + cb->m_ret_len - aio->buffer;
+  my_b_aio_read_done(aio, cb->m_err ? (size_t) -1 : length, cb->m_err);
+  delete cb;
+}
+
+
+static int io_cache_aio_read(IO_CACHE_AIO *aio)
+{
+  if (aio->length > UINT_MAX32)
+    return 1;
+  tpool::aiocb *cb= new (std::nothrow) tpool::aiocb();
+  if (!cb)
+    return 1;
+#ifdef _WIN32
+  cb->m_fh= tpool::native_file_handle(my_get_osfhandle(aio->file));
+#else
+  cb->m_fh= aio->file;
+#endif
+  cb->m_opcode= tpool::aio_opcode::AIO_PREAD;
+  cb->m_offset= aio->pos_in_file;
+  cb->m_buffer= aio->buffer;
+  cb->m_len= (unsigned int) aio->length;
+  cb->m_callback= io_cache_aio_complete;
+  memcpy(cb->m_userdata, &aio, sizeof aio);
+  if (io_cache_pool->submit_io(cb))
+  {
+    delete cb;
+    return 1;
+  }
+  return 0;
+}
+
+
+static void io_cache_aio_thread_init()
+{
+  my_thread_init();
+}
+
+static void io_cache_aio_thread_end()
+{
+  my_thread_end();
+}
+
+
+/*
+  Start the thread pool for the read-ahead of IO_CACHEs
+
+  Failure is not fatal, the IO_CACHEs then read synchronously.
+*/
+void init_io_cache_aio()
+{
+  int err= 1;
+  DBUG_ASSERT(!io_cache_pool);
+  if (!(io_cache_pool= tpool::create_thread_pool_generic()))
+    return;
+  io_cache_pool->set_thread_callbacks(io_cache_aio_thread_init,
+                                      io_cache_aio_thread_end);
+#ifdef HAVE_URING
+  err= io_cache_pool->configure_aio(true, IO_CACHE_AIO_MAX_IO);
+#endif
+  if (err && io_cache_pool->configure_aio(false, IO_CACHE_AIO_MAX_IO))
+  {
+    sql_print_warning("Could not start the asynchronous read-ahead of "
+                      "IO caches");
+    delete io_cache_pool;
+    io_cache_pool= NULL;
+    return;
+  }
+  _my_b_aio_read= io_cache_aio_read;
+}
+
+
+/*
+  Stop the read-ahead. No IO_CACHE may be in use any more.
+*/
+void end_io_cache_aio()
+{
+  _my_b_aio_read= 0;
+  if (io_cache_pool)
+  {
+    io_cache_pool->disable_aio();
+    delete io_cache_pool;
+    io_cache_pool= NULL;
+  }
+}
@@ -276,6 +276,8 @@ extern "C" sig_handler handle_fatal_signal(int sig);
 #endif
 
 int init_io_cache_encryption();
+void init_io_cache_aio();
+void end_io_cache_aio();
 
 /* Constants */
 
@@ -327,7 +329,8 @@ static bool volatile select_thread_in_use, signal_thread_in_use;
 static my_bool opt_debugging= 0, opt_external_locking= 0, opt_console= 0;
 static my_bool opt_short_log_format= 0, opt_silent_startup= 0;
 
-ulong max_used_connections;
+/* Updated by all acceptor threads */
+std::atomic<ulong> max_used_connections;
 static const char *mysqld_user, *mysqld_chroot;
 static char *default_character_set_name;
 static char *character_set_filesystem_name;
@@ -341,6 +344,7 @@ char *gtid_pos_auto_engines;
 plugin_ref *opt_gtid_pos_auto_plugins;
 static char compiled_default_collation_name[]= MYSQL_DEFAULT_COLLATION_NAME;
 Thread_cache thread_cache;
+THD_cache thd_cache;
 static bool binlog_format_used= false;
 LEX_STRING opt_init_connect, opt_init_slave;
 static DYNAMIC_ARRAY all_options;
@@ -351,6 +355,7 @@ static longlong start_memory_used;
 bool opt_bin_log, opt_bin_log_used=0, opt_ignore_builtin_innodb= 0;
 bool opt_bin_log_compress;
 uint opt_bin_log_compress_min_len;
+uint opt_binlog_transaction_compression_level;
 my_bool opt_log, debug_assert_if_crashed_table= 0, opt_help= 0;
 my_bool debug_assert_on_not_freed_memory= 0;
 my_bool disable_log_notes, opt_support_flashback= 0;
@@ -404,6 +409,7 @@ handlerton *partition_hton;
 my_bool read_only= 0, opt_readonly= 0;
 my_bool use_temp_pool, relay_log_purge;
 my_bool relay_log_recovery;
+ulong relay_log_buffer_size;
 my_bool opt_sync_frm, opt_allow_suspicious_udfs;
 my_bool opt_secure_auth= 0;
 my_bool opt_require_secure_transport= 0;
@@ -434,9 +440,11 @@ my_bool opt_master_verify_checksum= 0;
 my_bool opt_slave_sql_verify_checksum= 1;
 const char *binlog_format_names[]= {"MIXED", "STATEMENT", "ROW", NullS};
 volatile sig_atomic_t calling_initgroups= 0; /**< Used in SIGSEGV handler. */
-uint mysqld_port, select_errors, dropping_tables, ha_open_options;
+uint mysqld_port, dropping_tables, ha_open_options;
+Atomic_counter<uint> select_errors;
 uint mysqld_extra_port;
 uint mysqld_port_timeout;
+uint opt_acceptor_threads;
 ulong delay_key_write_options;
 uint protocol_version;
 uint lower_case_table_names;
@@ -459,6 +467,11 @@ ulonglong slave_type_conversions_options;
 ulong thread_cache_size=0;
 ulonglong binlog_cache_size=0;
 ulonglong binlog_file_cache_size=0;
+ulonglong binlog_tail_cache_size=0;
+my_bool opt_binlog_gtid_index= 0;
+ulong opt_binlog_gtid_index_span;
+my_bool opt_binlog_single_sync_commit= 0;
+ulonglong opt_binlog_large_commit_threshold= 0;
 ulonglong max_binlog_cache_size=0;
 ulong slave_max_allowed_packet= 0;
 ulonglong binlog_stmt_cache_size=0;
@@ -528,6 +541,7 @@ ulong opt_slave_domain_parallel_threads= 0;
 ulong opt_slave_parallel_mode;
 ulong opt_binlog_commit_wait_count= 0;
 ulong opt_binlog_commit_wait_usec= 0;
+ulong opt_binlog_dependency_tracking= 0;
 ulong opt_slave_parallel_max_queued= 131072;
 my_bool opt_gtid_ignore_duplicates= FALSE;
 uint opt_gtid_cleanup_batch_size= 64;
@@ -884,7 +898,7 @@ PSI_file_key key_file_binlog,  key_file_binlog_cache, key_file_binlog_index,
 PSI_file_key key_file_query_log, key_file_slow_log;
 PSI_file_key key_file_relaylog, key_file_relaylog_index,
              key_file_relaylog_cache, key_file_relaylog_index_cache;
-PSI_file_key key_file_binlog_state;
+PSI_file_key key_file_binlog_state, key_file_binlog_gtid_index;
 
 #ifdef HAVE_PSI_INTERFACE
 #ifdef HAVE_MMAP
@@ -906,7 +920,7 @@ PSI_mutex_key key_BINLOG_LOCK_index, key_BINLOG_LOCK_xid_list,
   key_LOCK_manager, key_LOCK_backup_log,
   key_LOCK_prepared_stmt_count,
   key_LOCK_rpl_status, key_LOCK_server_started,
-  key_LOCK_status, key_LOCK_temp_pool,
+  key_LOCK_status, key_LOCK_status_shard, key_LOCK_temp_pool,
   key_LOCK_system_variables_hash, key_LOCK_thd_data, key_LOCK_thd_kill,
   key_LOCK_user_conn, key_LOCK_uuid_short_generator, key_LOG_LOCK_log,
   key_master_info_data_lock, key_master_info_run_lock,
@@ -924,7 +938,8 @@ PSI_mutex_key key_RELAYLOG_LOCK_index;
 PSI_mutex_key key_LOCK_relaylog_end_pos;
 PSI_mutex_key key_LOCK_thread_id;
 PSI_mutex_key key_LOCK_slave_state, key_LOCK_binlog_state,
-  key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry;
+  key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry,
+  key_LOCK_retried_tables;
 PSI_mutex_key key_LOCK_rpl_semi_sync_master_enabled;
 PSI_mutex_key key_LOCK_binlog;
 
@@ -980,6 +995,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_rpl_status, "LOCK_rpl_status", PSI_FLAG_GLOBAL},
   { &key_LOCK_server_started, "LOCK_server_started", PSI_FLAG_GLOBAL},
   { &key_LOCK_status, "LOCK_status", PSI_FLAG_GLOBAL},
+  { &key_LOCK_status_shard, "Status_shards::lock", 0},
   { &key_LOCK_system_variables_hash, "LOCK_system_variables_hash", PSI_FLAG_GLOBAL},
   { &key_LOCK_stats, "LOCK_stats", PSI_FLAG_GLOBAL},
   { &key_LOCK_global_user_client_stats, "LOCK_global_user_client_stats", PSI_FLAG_GLOBAL},
@@ -1018,6 +1034,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_binlog_state, "LOCK_binlog_state", 0},
   { &key_LOCK_rpl_thread, "LOCK_rpl_thread", 0},
   { &key_LOCK_rpl_thread_pool, "LOCK_rpl_thread_pool", 0},
+  { &key_LOCK_retried_tables, "LOCK_retried_tables", 0},
   { &key_LOCK_parallel_entry, "LOCK_parallel_entry", 0},
   { &key_LOCK_ack_receiver, "Ack_receiver::mutex", 0},
   { &key_LOCK_rpl_semi_sync_master_enabled, "LOCK_rpl_semi_sync_master_enabled", 0},
@@ -1031,7 +1048,8 @@ PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
   key_rwlock_LOCK_vers_stats, key_rwlock_LOCK_stat_serial,
   key_rwlock_LOCK_ssl_refresh,
   key_rwlock_THD_list,
-  key_rwlock_LOCK_all_status_vars;
+  key_rwlock_LOCK_all_status_vars,
+  key_rwlock_binlog_tail_cache;
 
 static PSI_rwlock_info all_server_rwlocks[]=
 {
@@ -1049,7 +1067,8 @@ static PSI_rwlock_info all_server_rwlocks[]=
   { &key_rwlock_LOCK_stat_serial, "TABLE_SHARE::LOCK_stat_serial", 0},
   { &key_rwlock_LOCK_ssl_refresh, "LOCK_ssl_refresh", PSI_FLAG_GLOBAL },
   { &key_rwlock_THD_list, "THD_list::lock", PSI_FLAG_GLOBAL },
-  { &key_rwlock_LOCK_all_status_vars, "LOCK_all_status_vars", PSI_FLAG_GLOBAL }
+  { &key_rwlock_LOCK_all_status_vars, "LOCK_all_status_vars", PSI_FLAG_GLOBAL },
+  { &key_rwlock_binlog_tail_cache, "Binlog_tail_cache::lock", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -1071,7 +1090,7 @@ PSI_cond_key key_BINLOG_COND_xid_list,
   key_rpl_group_info_sleep_cond,
   key_TABLE_SHARE_cond, key_user_level_lock_cond,
   key_COND_start_thread, key_COND_binlog_send,
-  key_BINLOG_COND_queue_busy;
+  key_BINLOG_COND_queue_busy, key_BINLOG_COND_cache_fill;
 PSI_cond_key key_RELAYLOG_COND_relay_log_updated,
   key_RELAYLOG_COND_bin_log_updated, key_COND_wakeup_ready,
   key_COND_wait_commit;
@@ -1097,6 +1116,7 @@ static PSI_cond_info all_server_conds[]=
   { &key_BINLOG_COND_binlog_background_thread, "MYSQL_BIN_LOG::COND_binlog_background_thread", 0},
   { &key_BINLOG_COND_binlog_background_thread_end, "MYSQL_BIN_LOG::COND_binlog_background_thread_end", 0},
   { &key_BINLOG_COND_queue_busy, "MYSQL_BIN_LOG::COND_queue_busy", 0},
+  { &key_BINLOG_COND_cache_fill, "MYSQL_BIN_LOG::COND_cache_fill", 0},
   { &key_RELAYLOG_COND_relay_log_updated, "MYSQL_RELAY_LOG::COND_relay_log_updated", 0},
   { &key_RELAYLOG_COND_bin_log_updated, "MYSQL_RELAY_LOG::COND_bin_log_updated", 0},
   { &key_RELAYLOG_COND_queue_busy, "MYSQL_RELAY_LOG::COND_queue_busy", 0},
@@ -1138,7 +1158,7 @@ PSI_thread_key key_thread_delayed_insert,
   key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
   key_thread_slave_background, key_rpl_parallel_thread;
-PSI_thread_key key_thread_ack_receiver;
+PSI_thread_key key_thread_ack_receiver, key_thread_acceptor;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -1149,6 +1169,7 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_background, "slave_background", PSI_FLAG_GLOBAL},
   { &key_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL},
+  { &key_thread_acceptor, "acceptor", PSI_FLAG_GLOBAL},
   { &key_rpl_parallel_thread, "rpl_parallel_thread", 0}
 };
 
@@ -1375,6 +1396,12 @@ struct my_rnd_struct sql_rand; ///< used by sql_class.cc:THD::THD()
 #ifndef EMBEDDED_LIBRARY
 
 Dynamic_array<MYSQL_SOCKET> listen_sockets(PSI_INSTRUMENT_MEM, 0);
+/*
+  Positions in listen_sockets where the SO_REUSEPORT sockets of each
+  additional acceptor thread start (see --acceptor-threads). Sockets
+  before the first position are served by the main thread.
+*/
+static Dynamic_array<size_t> acceptor_sockets_start(PSI_INSTRUMENT_MEM, 0);
 bool unix_sock_is_online= false;
 static int systemd_sock_activation; /* systemd socket activation */
 
@@ -1724,6 +1751,7 @@ static void close_connections(void)
 
   /* Clear thread cache */
   thread_cache.final_flush();
+  thd_cache.final_flush();
 
   /* Abort listening to new connections */
   DBUG_PRINT("quit",("Closing sockets"));
@@ -1739,6 +1767,7 @@ static void close_connections(void)
     }
   }
   listen_sockets.free_memory();
+  acceptor_sockets_start.free_memory();
   mysql_mutex_unlock(&LOCK_start_thread);
 
   end_thr_alarm(0);			 // Abort old alarms.
@@ -1955,6 +1984,7 @@ static void clean_up(bool print_message)
   tdc_start_shutdown();
 #ifdef HAVE_REPLICATION
   semi_sync_master_deinit();
+  binlog_tail_cache_free();
 #endif
   plugin_shutdown();
   udf_free();
@@ -1972,6 +2002,7 @@ static void clean_up(bool print_message)
   free_status_vars();
   end_thr_alarm(1);			/* Free allocated memory */
   end_thr_timer();
+  end_io_cache_aio();
   my_free_open_file_info();
   if (defaults_argv)
     free_defaults(defaults_argv);
@@ -2060,9 +2091,11 @@ static void clean_up_mutexes()
   DBUG_ENTER("clean_up_mutexes");
   server_threads.destroy();
   thread_cache.destroy();
+  thd_cache.destroy();
   mysql_rwlock_destroy(&LOCK_grant);
   mysql_mutex_destroy(&LOCK_start_thread);
   mysql_mutex_destroy(&LOCK_status);
+  status_shards.destroy();
   mysql_rwlock_destroy(&LOCK_all_status_vars);
   mysql_mutex_destroy(&LOCK_delayed_insert);
   mysql_mutex_destroy(&LOCK_delayed_status);
@@ -2243,11 +2276,20 @@ static void set_root(const char *path)
 
 /**
    Activate usage of a tcp port
+
+   @param port           TCP port to listen on
+   @param sockets        Array to add the listening sockets to
+   @param is_extra_port  The sockets are for --extra-port
+   @param acceptor       Number of the acceptor thread the sockets are
+                         created for. All acceptors bind the same
+                         addresses with SO_REUSEPORT, so that the kernel
+                         spreads new connections between them.
 */
 
 static void activate_tcp_port(uint port,
                               Dynamic_array<MYSQL_SOCKET> *sockets,
-                              bool is_extra_port= false)
+                              bool is_extra_port= false,
+                              uint acceptor= 0)
 {
   struct addrinfo *ai, *a;
   struct addrinfo hints;
@@ -2302,8 +2344,9 @@ static void activate_tcp_port(uint port,
     else 
     {
       ip_sock.address_family= a->ai_family;
-      sql_print_information("Server socket created on IP: '%s'.",
-                          (const char *) ip_addr);
+      if (!acceptor)
+        sql_print_information("Server socket created on IP: '%s'.",
+                              (const char *) ip_addr);
 
       if (mysql_socket_getfd(ip_sock) == INVALID_SOCKET)
       {
@@ -2343,6 +2386,22 @@ static void activate_tcp_port(uint port,
       arg= 1;
       (void) mysql_socket_setsockopt(ip_sock, IPPROTO_IP, IP_FREEBIND,
                                      (char*) &arg, sizeof(arg));
+#endif
+#ifdef SO_REUSEPORT
+      /*
+        With several acceptor threads each of them listens on its own
+        socket bound to the same address; the kernel load balances
+        incoming connections between the sockets. The socket of the main
+        acceptor is bound without SO_REUSEPORT, so that the bind fails
+        if another server already listens on the port, and gets it set
+        before listen() below.
+      */
+      if (acceptor > 0)
+      {
+        arg= 1;
+        (void) mysql_socket_setsockopt(ip_sock, SOL_SOCKET, SO_REUSEPORT,
+                                       (char*) &arg, sizeof(arg));
+      }
 #endif
       /*
         Sometimes the port is not released fast enough when stopping and
@@ -2375,6 +2434,20 @@ static void activate_tcp_port(uint port,
                         "port: %u ?", port);
         unireg_abort(1);
       }
+#ifdef SO_REUSEPORT
+      if (acceptor == 0 && opt_acceptor_threads > 1 && !is_extra_port)
+      {
+        arg= 1;
+        if (mysql_socket_setsockopt(ip_sock, SOL_SOCKET, SO_REUSEPORT,
+                                    (char*) &arg, sizeof(arg)))
+        {
+          sql_print_warning("Failed to set SO_REUSEPORT on TCP/IP port %u: "
+                            "errno: %d; using a single acceptor thread",
+                            port, (int) socket_errno);
+          opt_acceptor_threads= 1;
+        }
+      }
+#endif
       if (mysql_socket_listen(ip_sock,(int) back_log) < 0)
       {
         sql_perror("Can't start server: listen() on TCP/IP port");
@@ -2567,6 +2640,20 @@ static void network_init(void)
   if (!opt_disable_networking)
     DBUG_ASSERT(report_port != 0);
 #endif
+#if !defined(HAVE_POLL) || !defined(SO_REUSEPORT)
+  if (opt_acceptor_threads > 1)
+  {
+    sql_print_warning("--acceptor-threads=%u is not supported on this "
+                      "platform, using a single acceptor thread",
+                      opt_acceptor_threads);
+    opt_acceptor_threads= 1;
+  }
+#endif
+  if (opt_acceptor_threads > 1 &&
+      (systemd_sock_activation || opt_disable_networking ||
+       opt_bootstrap || !mysqld_port))
+    opt_acceptor_threads= 1;
+
   if (!opt_disable_networking && !opt_bootstrap && !systemd_sock_activation)
   {
     if (mysqld_port)
@@ -2646,6 +2733,18 @@ static void network_init(void)
   }
 #endif
 
+  /*
+    Additional acceptor threads get their own SO_REUSEPORT sockets for
+    the main port, appended after the sockets of the main thread.
+  */
+  for (uint acceptor= 1; acceptor < opt_acceptor_threads; acceptor++)
+  {
+    size_t start= listen_sockets.size();
+    acceptor_sockets_start.push(start);
+    activate_tcp_port(mysqld_port, &listen_sockets,
+                      /* is_extra_port= */ false, acceptor);
+  }
+
 #ifdef _WIN32
   network_init_win();
 #endif
@@ -4361,6 +4460,7 @@ static int init_thread_environment()
   server_threads.init();
   mysql_mutex_init(key_LOCK_start_thread, &LOCK_start_thread, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_status, &LOCK_status, MY_MUTEX_INIT_FAST);
+  status_shards.init();
   mysql_mutex_init(key_LOCK_delayed_insert,
                    &LOCK_delayed_insert, MY_MUTEX_INIT_FAST);
   mysql_mutex_init(key_LOCK_delayed_status,
@@ -5111,6 +5211,11 @@ static int init_server_components()
     sql_print_error("Could not initialize semisync.");
     unireg_abort(1);
   }
+  if (binlog_tail_cache_init())
+  {
+    sql_print_error("Could not allocate binlog_tail_cache_size bytes.");
+    unireg_abort(1);
+  }
 #endif
 
 #ifndef EMBEDDED_LIBRARY
@@ -5242,6 +5347,7 @@ static int init_server_components()
 
   if (init_io_cache_encryption())
     unireg_abort(1);
+  init_io_cache_aio();
 
   /* if the errmsg.sys is not loaded, terminate to maintain behaviour */
   if (!DEFAULT_ERRMSGS[0][0])
@@ -5820,6 +5926,8 @@ int mysqld_main(int argc, char **argv)
     unireg_abort(1);
   }
 
+  tdc_start_preload();
+
   if (opt_init_file && *opt_init_file)
   {
     if (read_init_file(opt_init_file))
@@ -6026,9 +6134,12 @@ void create_new_thread(CONNECT *connect)
     DBUG_VOID_RETURN;
   }
 
-  uint sum= connection_count + extra_connection_count;
-  if (sum > max_used_connections)
-    max_used_connections= sum;
+  ulong sum= connection_count + extra_connection_count;
+  ulong max_used= max_used_connections.load(std::memory_order_relaxed);
+  while (sum > max_used &&
+         !max_used_connections.compare_exchange_weak(max_used, sum,
+                                                     std::memory_order_relaxed))
+  {}
 
   /*
     The initialization of thread_id is done in create_embedded_thd() for
@@ -6125,7 +6236,17 @@ static void set_non_blocking_if_supported(MYSQL_SOCKET sock)
 }
 
 
-void handle_connections_sockets()
+/**
+  Wait for and accept new connections on listen_sockets[first..last)
+  until shutdown.
+
+  @param first      First listening socket to serve
+  @param last       One past the last listening socket to serve
+  @param wakeup_fd  Descriptor that becomes readable when the loop must
+                    stop, or -1 if the caller is woken by a signal
+*/
+
+static void accept_connections(size_t first, size_t last, int wakeup_fd)
 {
   MYSQL_SOCKET sock= mysql_socket_invalid();
   uint error_count=0;
@@ -6138,10 +6259,10 @@ void handle_connections_sockets()
   fd_set readFDs,clientFDs;
 #endif
 
-  DBUG_ENTER("handle_connections_sockets");
+  DBUG_ENTER("accept_connections");
 
 #ifdef HAVE_POLL
-  for (size_t i= 0; i < listen_sockets.size(); i++)
+  for (size_t i= first; i < last; i++)
   {
     struct pollfd local_fds;
     mysql_socket_set_thread_owner(listen_sockets.at(i));
@@ -6150,9 +6271,17 @@ void handle_connections_sockets()
     fds.push(local_fds);
     set_non_blocking_if_supported(listen_sockets.at(i));
   }
+  if (wakeup_fd >= 0)
+  {
+    struct pollfd local_fds;
+    local_fds.fd= wakeup_fd;
+    local_fds.events= POLLIN;
+    fds.push(local_fds);
+  }
 #else
+  DBUG_ASSERT(wakeup_fd < 0);
   FD_ZERO(&clientFDs);
-  for (size_t i= 0; i < listen_sockets.size(); i++)
+  for (size_t i= first; i < last; i++)
   {
     int fd= mysql_socket_getfd(listen_sockets.at(i));
     FD_SET(fd, &clientFDs);
@@ -6160,9 +6289,6 @@ void handle_connections_sockets()
   }
 #endif
 
-  sd_notify(0, "READY=1\n"
-            "STATUS=Taking your SQL requests now...\n");
-
   DBUG_PRINT("general",("Waiting for connections."));
   while (!abort_loop)
   {
@@ -6194,16 +6320,16 @@ void handle_connections_sockets()
 
     /* Is this a new connection request ? */
 #ifdef HAVE_POLL
-    for (size_t i= 0; i < fds.size(); ++i)
+    for (size_t i= 0; i < last - first; ++i)
     {
       if (fds.at(i).revents & POLLIN)
       {
-        sock= listen_sockets.at(i);
+        sock= listen_sockets.at(first + i);
         break;
       }
     }
 #else  // HAVE_POLL
-    for (size_t i=0; i < listen_sockets.size(); i++)
+    for (size_t i= first; i < last; i++)
     {
       if (FD_ISSET(mysql_socket_getfd(listen_sockets.at(i)), &readFDs))
       {
@@ -6239,6 +6365,90 @@ void handle_connections_sockets()
       }
     }
   }
+  DBUG_VOID_RETURN;
+}
+
+
+#if defined(HAVE_POLL) && defined(SO_REUSEPORT)
+/* Written to on shutdown to stop the additional acceptor threads */
+static int acceptor_wakeup_pipe[2];
+
+/**
+  Additional acceptor thread, serving its own SO_REUSEPORT sockets.
+
+  @param arg  Index in acceptor_sockets_start
+*/
+
+static void *acceptor_thread(void *arg)
+{
+  size_t acceptor= (size_t) arg;
+  size_t first= acceptor_sockets_start.at(acceptor);
+  size_t last= acceptor + 1 < acceptor_sockets_start.size() ?
+               acceptor_sockets_start.at(acceptor + 1) : listen_sockets.size();
+  my_thread_init();
+  accept_connections(first, last, acceptor_wakeup_pipe[0]);
+  my_thread_end();
+  return 0;
+}
+#endif
+
+
+void handle_connections_sockets()
+{
+  size_t main_sockets= listen_sockets.size();
+  size_t acceptor_count= acceptor_sockets_start.size();
+#if defined(HAVE_POLL) && defined(SO_REUSEPORT)
+  pthread_t *acceptors= NULL;
+#endif
+  DBUG_ENTER("handle_connections_sockets");
+
+#if defined(HAVE_POLL) && defined(SO_REUSEPORT)
+  if (acceptor_count)
+  {
+    main_sockets= acceptor_sockets_start.at(0);
+    if (pipe(acceptor_wakeup_pipe) ||
+        !(acceptors= (pthread_t*) my_malloc(PSI_INSTRUMENT_ME,
+                                            acceptor_count * sizeof(pthread_t),
+                                            MYF(MY_WME))))
+    {
+      sql_print_error("Can't start acceptor threads (errno= %d)", errno);
+      unireg_abort(1);
+    }
+    for (size_t i= 0; i < acceptor_count; i++)
+    {
+      if (int error= mysql_thread_create(key_thread_acceptor, &acceptors[i],
+                                         &connection_attrib, acceptor_thread,
+                                         (void*) i))
+      {
+        sql_print_error("Can't create acceptor thread (errno= %d)", error);
+        unireg_abort(1);
+      }
+    }
+  }
+#else
+  DBUG_ASSERT(!acceptor_count);
+#endif
+
+  sd_notify(0, "READY=1\n"
+            "STATUS=Taking your SQL requests now...\n");
+
+  accept_connections(0, main_sockets, -1);
+
+#if defined(HAVE_POLL) && defined(SO_REUSEPORT)
+  if (acceptor_count)
+  {
+    /* abort_loop is set, wake up the other acceptors and wait for them */
+    if (write(acceptor_wakeup_pipe[1], "", 1) != 1)
+      sql_print_warning("Failed to wake up acceptor threads (errno= %d)",
+                        errno);
+    for (size_t i= 0; i < acceptor_count; i++)
+      pthread_join(acceptors[i], NULL);
+    my_free(acceptors);
+    close(acceptor_wakeup_pipe[0]);
+    close(acceptor_wakeup_pipe[1]);
+  }
+#endif
+
   sd_notify(0, "STOPPING=1\n"
             "STATUS=Shutdown in progress\n");
   DBUG_VOID_RETURN;
@@ -7347,6 +7557,8 @@ SHOW_VAR status_vars[]= {
   {"Master_gtid_wait_timeouts", (char*) offsetof(STATUS_VAR, master_gtid_wait_timeouts), SHOW_LONG_STATUS},
   {"Master_gtid_wait_time",    (char*) offsetof(STATUS_VAR, master_gtid_wait_time), SHOW_LONG_STATUS},
   {"Max_used_connections",     (char*) &max_used_connections,  SHOW_LONG},
+  {"Mem_root_blocks_allocated", (char*) offsetof(STATUS_VAR, mem_root_blocks_allocated), SHOW_LONG_STATUS},
+  {"Mem_root_blocks_reused",   (char*) offsetof(STATUS_VAR, mem_root_blocks_reused), SHOW_LONG_STATUS},
   {"Memory_used",              (char*) &show_memory_used, SHOW_SIMPLE_FUNC},
   {"Memory_used_initial",      (char*) &start_memory_used, SHOW_LONGLONG},
   {"Resultset_metadata_skipped", (char *) offsetof(STATUS_VAR, skip_metadata_count),SHOW_LONG_STATUS},
@@ -7670,7 +7882,8 @@ static int mysql_init_variables(void)
   disable_log_notes= 0;
   mqh_used= 0;
   cleanup_done= 0;
-  select_errors= dropping_tables= ha_open_options=0;
+  select_errors= 0;
+  dropping_tables= ha_open_options=0;
   THD_count::count= CONNECT::count= 0;
   slave_open_temp_tables= 0;
   opt_endinfo= using_udf_functions= 0;
@@ -7717,6 +7930,7 @@ static int mysql_init_variables(void)
   global_thread_id= 0;
   strnmov(server_version, MYSQL_SERVER_VERSION, sizeof(server_version)-1);
   thread_cache.init();
+  thd_cache.init();
   key_caches.empty();
   if (!(dflt_key_cache= get_or_create_key_cache(default_key_cache_base.str,
                                                 default_key_cache_base.length)))
@@ -9000,6 +9214,7 @@ void refresh_status(THD *thd)
 #endif
 
   /* Add thread's status variabes to global status */
+  thd->remove_status_from_shard();
   add_to_status(&global_status_var, &thd->status_var);
 
   /* Reset thread's status variables */
@@ -9069,7 +9284,8 @@ static PSI_file_info all_server_files[]=
   { &key_file_trg, "trigger_name", 0},
   { &key_file_trn, "trigger", 0},
   { &key_file_init, "init", 0},
-  { &key_file_binlog_state, "binlog_state", 0}
+  { &key_file_binlog_state, "binlog_state", 0},
+  { &key_file_binlog_gtid_index, "binlog_gtid_index", 0}
 };
 #endif /* HAVE_PSI_INTERFACE */
 
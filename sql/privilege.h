@@ -347,6 +347,9 @@ constexpr privilege_t PRIV_SET_SYSTEM_VAR_SQL_LOG_BIN=
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_CACHE_SIZE=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
+constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_LARGE_COMMIT_THRESHOLD=
+  SUPER_ACL | BINLOG_ADMIN_ACL;
+
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_FILE_CACHE_SIZE=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
@@ -359,6 +362,10 @@ constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_COMMIT_WAIT_COUNT=
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_COMMIT_WAIT_USEC=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
+constexpr privilege_t
+  PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_DEPENDENCY_TRACKING=
+  SUPER_ACL | BINLOG_ADMIN_ACL;
+
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_ROW_METADATA=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
@@ -371,6 +378,13 @@ constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS=
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS_MIN_LEN=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
+constexpr privilege_t PRIV_SET_SYSTEM_VAR_BINLOG_TRANSACTION_COMPRESSION=
+  SUPER_ACL | BINLOG_ADMIN_ACL;
+
+constexpr privilege_t
+  PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_COMPRESSION_LEVEL=
+  SUPER_ACL | BINLOG_ADMIN_ACL;
+
 constexpr privilege_t PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_TRUST_FUNCTION_CREATORS=
   SUPER_ACL | BINLOG_ADMIN_ACL;
 
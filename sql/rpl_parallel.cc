@@ -365,6 +365,7 @@ do_gco_wait(rpl_group_info *rgi, group_commit_orderer *gco,
                     old_stage);
     *did_enter_cond= true;
     thd->set_time_for_next_stage();
+    ulonglong wait_start= microsecond_interval_timer();
     do
     {
       if (!rgi->worker_error && unlikely(thd->check_killed(1)))
@@ -386,6 +387,8 @@ do_gco_wait(rpl_group_info *rgi, group_commit_orderer *gco,
       mysql_cond_wait(&gco->COND_group_commit_orderer,
                       &entry->LOCK_parallel_entry);
     } while (wait_count > entry->count_committing_event_groups);
+    rgi->rpt->stats.add_wait(rpl_parallel_thread_stats::WAIT_FOR_GCO,
+                             wait_start);
   }
 
   if (entry->force_abort && wait_count > entry->stop_count)
@@ -458,7 +461,7 @@ do_ftwrl_wait(rpl_group_info *rgi,
 }
 
 
-static int
+int
 pool_mark_busy(rpl_parallel_thread_pool *pool, THD *thd)
 {
   PSI_stage_info old_stage;
@@ -505,7 +508,7 @@ pool_mark_busy(rpl_parallel_thread_pool *pool, THD *thd)
 }
 
 
-static void
+void
 pool_mark_not_busy(rpl_parallel_thread_pool *pool)
 {
   mysql_mutex_lock(&pool->LOCK_rpl_thread_pool);
@@ -761,11 +764,15 @@ retry_event_group(rpl_group_info *rgi, rpl_parallel_thread *rpt,
   rpl_parallel_entry *entry= rgi->parallel_entry;
   ulong retries= 0;
   Format_description_log_event *description_event= NULL;
+  Transaction_payload_reader payload_reader;
+  ulonglong retry_id;
 
 do_retry:
   event_count= 0;
   err= 0;
   errmsg= NULL;
+  payload_reader.reset();
+  retry_id= 0;
 
   /*
     If we already started committing before getting the deadlock (or other
@@ -932,6 +939,16 @@ retry_event_group(rpl_group_info *rgi, rpl_parallel_thread *rpt,
     for (;;)
     {
       old_offset= cur_offset;
+      if (payload_reader.has_events())
+      {
+        /* The next event of the transaction payload read last */
+        if ((ev= payload_reader.read_event(description_event,
+                                           opt_slave_sql_verify_checksum,
+                                           &errmsg)))
+          break;
+        err= 1;
+        goto err;
+      }
       ev= Log_event::read_log_event(&rlog, description_event,
                                     opt_slave_sql_verify_checksum);
       cur_offset= my_b_tell(&rlog);
@@ -1008,11 +1025,29 @@ retry_event_group(rpl_group_info *rgi, rpl_parallel_thread *rpt,
       delete ev;
       continue;
     }
+    else if (event_type == TRANSACTION_PAYLOAD_EVENT)
+    {
+      bool failed= payload_reader.load((Transaction_payload_log_event *) ev,
+                                       &errmsg);
+      delete ev;
+      if (failed)
+      {
+        err= 1;
+        goto err;
+      }
+      continue;
+    }
     else if (!Log_event::is_group_event(event_type))
     {
       delete ev;
       continue;
     }
+    else if (event_type == TABLE_MAP_EVENT)
+    {
+      Table_map_log_event *map_ev= static_cast<Table_map_log_event *>(ev);
+      rpt->pool->count_retried_table(&retry_id, map_ev->get_db_name(),
+                                     map_ev->get_table_name());
+    }
     ev->thd= thd;
 
     mysql_mutex_lock(&rpt->LOCK_rpl_thread);
@@ -1155,6 +1190,7 @@ handle_rpl_parallel_thread(void *arg)
   while (!rpt->stop)
   {
     uint wait_count= 0;
+    ulonglong wait_start= 0;
     rpl_parallel_thread::queued_event *qev, *next_qev;
 
     rpt->start_time_tracker();
@@ -1176,12 +1212,18 @@ handle_rpl_parallel_thread(void *arg)
               rpt->stop))
     {
       if (!wait_count++)
+      {
         thd->set_time_for_next_stage();
+        wait_start= microsecond_interval_timer();
+      }
       mysql_cond_wait(&rpt->COND_rpl_thread, &rpt->LOCK_rpl_thread);
     }
     rpt->dequeue1(events);
     thd->EXIT_COND(&old_stage);
     rpt->add_to_worker_idle_time_and_reset();
+    if (wait_count)
+      rpt->stats.add_wait(rpl_parallel_thread_stats::WAIT_FOR_QUEUE,
+                          wait_start);
 
   more_events:
     for (qev= events; qev; qev= next_qev)
@@ -1302,6 +1344,7 @@ handle_rpl_parallel_thread(void *arg)
         unlock_or_exit_cond(thd, &entry->LOCK_parallel_entry,
                             &did_enter_cond, &old_stage);
 
+        rpt->stats.group_start= microsecond_interval_timer();
         thd->wait_for_commit_ptr= &rgi->commit_orderer;
 
         if (opt_gtid_ignore_duplicates &&
@@ -1415,7 +1458,12 @@ handle_rpl_parallel_thread(void *arg)
         {
           convert_kill_to_deadlock_error(rgi);
           if (has_temporary_error(thd) && slave_trans_retries > 0)
+          {
+            ulonglong retry_start= microsecond_interval_timer();
             err= retry_event_group(rgi, rpt, qev);
+            rpt->stats.add_wait(rpl_parallel_thread_stats::WAIT_FOR_RETRY,
+                                retry_start);
+          }
         }
       }
       else
@@ -1446,6 +1494,8 @@ handle_rpl_parallel_thread(void *arg)
       {
         in_event_group= false;
         finish_event_group(rpt, event_gtid_sub_id, entry, rgi);
+        if (rpt->stats.group_start)
+          rpt->stats.end_group();
         rpt->loc_free_rgi(rgi);
         thd->rgi_slave= group_rgi= rgi= NULL;
         skip_event_group= false;
@@ -2090,6 +2140,30 @@ rpl_parallel_thread::rpl_parallel_thread()
   : channel_name_length(0), last_error_number(0), last_error_timestamp(0),
     worker_idle_time(0), last_trans_retry_count(0), start_time(0)
 {
+  stats.reset();
+}
+
+
+/*
+  Count a wait for prior commits in the statistics of the parallel
+  replication worker, if THD is one.
+*/
+void
+rpl_count_prior_commit_wait(THD *thd, ulonglong wait_start)
+{
+  if (thd->rgi_slave && thd->rgi_slave->rpt)
+    thd->rgi_slave->rpt->stats.add_wait(
+      rpl_parallel_thread_stats::WAIT_FOR_PRIOR_COMMIT, wait_start);
+}
+
+
+static uchar *
+get_retried_table_key(const uchar *ptr, size_t *length,
+                      my_bool not_used __attribute__((unused)))
+{
+  rpl_retried_table *entry= (rpl_retried_table *) ptr;
+  *length= entry->key_length;
+  return (uchar *) entry->key;
 }
 
 
@@ -2111,6 +2185,11 @@ rpl_parallel_thread_pool::init(uint32 size)
   mysql_mutex_init(key_LOCK_rpl_thread_pool, &LOCK_rpl_thread_pool,
                    MY_MUTEX_INIT_SLOW);
   mysql_cond_init(key_COND_rpl_thread_pool, &COND_rpl_thread_pool, NULL);
+  mysql_mutex_init(key_LOCK_retried_tables, &LOCK_retried_tables,
+                   MY_MUTEX_INIT_SLOW);
+  my_hash_init(PSI_INSTRUMENT_ME, &retried_tables, &my_charset_bin, 16, 0, 0,
+               get_retried_table_key, my_free, HASH_UNIQUE);
+  last_retry_id= 0;
   inited= true;
 
   /*
@@ -2145,10 +2224,58 @@ rpl_parallel_thread_pool::destroy_cond_mutex()
     return;
   mysql_mutex_destroy(&LOCK_rpl_thread_pool);
   mysql_cond_destroy(&COND_rpl_thread_pool);
+  my_hash_free(&retried_tables);
+  mysql_mutex_destroy(&LOCK_retried_tables);
   inited= false;
 }
 
 
+/*
+  Count a retry of an event group in the statistics of a table that it maps.
+  *RETRY_ID identifies the retry, so that a table mapped more than once by
+  the same event group is counted once; it is assigned here when 0.
+*/
+void
+rpl_parallel_thread_pool::count_retried_table(ulonglong *retry_id,
+                                              const char *db,
+                                              const char *table)
+{
+  char key[NAME_LEN * 2 + 2];
+  size_t key_length= strmake(strmake(key, db, NAME_LEN) + 1, table,
+                             NAME_LEN) - key;
+  rpl_retried_table *entry;
+
+  mysql_mutex_lock(&LOCK_retried_tables);
+  if (!*retry_id)
+    *retry_id= ++last_retry_id;
+  if (!(entry= (rpl_retried_table *) my_hash_search(&retried_tables,
+                                                    (uchar *) key,
+                                                    key_length)))
+  {
+    if (!(entry= (rpl_retried_table *)
+          my_malloc(PSI_INSTRUMENT_ME,
+                    sizeof(rpl_retried_table) + key_length, MYF(MY_WME))))
+      goto end;
+    entry->retries= 0;
+    entry->last_retry_id= 0;
+    entry->key_length= key_length;
+    memcpy(entry->key, key, key_length);
+    if (my_hash_insert(&retried_tables, (uchar *) entry))
+    {
+      my_free(entry);
+      goto end;
+    }
+  }
+  if (entry->last_retry_id != *retry_id)
+  {
+    entry->last_retry_id= *retry_id;
+    entry->retries++;
+  }
+end:
+  mysql_mutex_unlock(&LOCK_retried_tables);
+}
+
+
 /*
   Wait for a worker thread to become idle. When one does, grab the thread for
   our use and return it.
@@ -2223,6 +2350,7 @@ rpl_parallel_thread_pool::copy_pool_for_pfs(Relay_log_info *rli)
       pfs_rpt->running= false;
       pfs_rpt->worker_idle_time= rpt->get_worker_idle_time();
       pfs_rpt->last_trans_retry_count= rpt->last_trans_retry_count;
+      pfs_rpt->stats= rpt->stats;
     }
   }
 }
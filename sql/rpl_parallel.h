@@ -94,6 +94,63 @@ struct group_commit_orderer {
 };
 
 
+/*
+  Cumulative statistics of a worker thread, for
+  INFORMATION_SCHEMA.SLAVE_WORKER_STATS. They are only updated by the worker
+  thread itself, without locking, so readers may see slightly stale values.
+  All times are in microseconds.
+*/
+struct rpl_parallel_thread_stats {
+  enum wait_class
+  {
+    /* For the SQL driver thread to queue events to the worker */
+    WAIT_FOR_QUEUE,
+    /* For prior event groups to start committing (group_commit_orderer) */
+    WAIT_FOR_GCO,
+    /* In wait_for_prior_commit(), for prior event groups to commit */
+    WAIT_FOR_PRIOR_COMMIT,
+    /* For row and table locks in the storage engine */
+    WAIT_FOR_LOCK,
+    /* Retrying event groups after a temporary error, like a deadlock */
+    WAIT_FOR_RETRY,
+    WAIT_CLASSES
+  };
+  /*
+    The apply time histogram has buckets for below 100us, 1ms, 10ms, 100ms,
+    1s and 10s, and one for 10s and more.
+  */
+  static const uint APPLY_TIME_BUCKETS= 7;
+
+  ulonglong waits[WAIT_CLASSES];
+  ulonglong wait_time[WAIT_CLASSES];
+  ulonglong event_groups;
+  ulonglong apply_time;
+  ulonglong apply_time_histogram[APPLY_TIME_BUCKETS];
+  /* Start of the current event group and lock wait, 0 if none */
+  ulonglong group_start;
+  ulonglong lock_wait_start;
+
+  void reset() { bzero((void*) this, sizeof(*this)); }
+  void add_wait(wait_class w, ulonglong start)
+  {
+    waits[w]++;
+    wait_time[w]+= microsecond_interval_timer() - start;
+  }
+  void end_group()
+  {
+    ulonglong time= microsecond_interval_timer() - group_start;
+    uint bucket= 0;
+    for (ulonglong limit= 100; bucket < APPLY_TIME_BUCKETS - 1 && time >= limit;
+         limit*= 10)
+      bucket++;
+    event_groups++;
+    apply_time+= time;
+    apply_time_histogram[bucket]++;
+    group_start= 0;
+  }
+};
+
+
 struct rpl_parallel_thread {
   bool delay_start;
   bool running;
@@ -182,6 +239,7 @@ struct rpl_parallel_thread {
   ulonglong last_error_timestamp;
   ulonglong worker_idle_time;
   ulong last_trans_retry_count;
+  rpl_parallel_thread_stats stats;
   ulonglong start_time;
   void start_time_tracker()
   {
@@ -302,6 +360,15 @@ struct pool_bkp_for_pfs{
   }
 };
 
+/* An element of rpl_parallel_thread_pool::retried_tables */
+struct rpl_retried_table {
+  ulonglong retries;
+  ulonglong last_retry_id;
+  size_t key_length;
+  /* The database and table name, separated by a '\0' */
+  char key[1];
+};
+
 struct rpl_parallel_thread_pool {
   struct rpl_parallel_thread **threads;
   struct rpl_parallel_thread *free_list;
@@ -322,6 +389,14 @@ struct rpl_parallel_thread_pool {
   */
   bool busy;
   struct pool_bkp_for_pfs pfs_bkp;
+  /*
+    Number of event group retries per table mapped by the retried event
+    groups, for INFORMATION_SCHEMA.SLAVE_WORKER_RETRIED_TABLES.
+    Protected by LOCK_retried_tables.
+  */
+  HASH retried_tables;
+  mysql_mutex_t LOCK_retried_tables;
+  ulonglong last_retry_id;
 
   rpl_parallel_thread_pool();
   void copy_pool_for_pfs(Relay_log_info *rli);
@@ -332,6 +407,8 @@ struct rpl_parallel_thread_pool {
   struct rpl_parallel_thread *get_thread(rpl_parallel_thread **owner,
                                          rpl_parallel_entry *entry);
   void release_thread(rpl_parallel_thread *rpt);
+  void count_retried_table(ulonglong *retry_id, const char *db,
+                           const char *table);
 };
 
 
@@ -465,6 +542,9 @@ extern int rpl_parallel_resize_pool_if_no_slaves(void);
 extern int rpl_parallel_activate_pool(rpl_parallel_thread_pool *pool);
 extern int rpl_parallel_inactivate_pool(rpl_parallel_thread_pool *pool);
 extern bool process_gtid_for_restart_pos(Relay_log_info *rli, rpl_gtid *gtid);
+extern void rpl_count_prior_commit_wait(THD *thd, ulonglong wait_start);
+extern int pool_mark_busy(rpl_parallel_thread_pool *pool, THD *thd);
+extern void pool_mark_not_busy(rpl_parallel_thread_pool *pool);
 extern int rpl_pause_for_ftwrl(THD *thd);
 extern void rpl_unpause_after_ftwrl(THD *thd);
 
@@ -0,0 +1,269 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  INFORMATION_SCHEMA tables with statistics of the parallel replication
+  worker threads, to find out what the workers wait for when a slave lags.
+*/
+
+#include <my_global.h>
+#include <mysql/plugin.h>
+#include <sql_class.h>
+#include <sql_i_s.h>
+#include <sql_show.h>
+#include <rpl_parallel.h>
+
+namespace Show {
+
+static ST_FIELD_INFO worker_stats_fields_info[] =
+{
+  Column("WORKER_ID",                 SLong(6),     NOT_NULL),
+  Column("THREAD_ID",                 ULonglong(),  NULLABLE),
+  Column("CONNECTION_NAME",           Name(),       NOT_NULL),
+  Column("EVENT_GROUPS",              ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME",                ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_UNDER_100US",    ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_UNDER_1MS",      ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_UNDER_10MS",     ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_UNDER_100MS",    ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_UNDER_1S",       ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_UNDER_10S",      ULonglong(),  NOT_NULL),
+  Column("APPLY_TIME_OVER_10S",       ULonglong(),  NOT_NULL),
+  Column("QUEUE_WAITS",               ULonglong(),  NOT_NULL),
+  Column("QUEUE_WAIT_TIME",           ULonglong(),  NOT_NULL),
+  Column("GCO_WAITS",                 ULonglong(),  NOT_NULL),
+  Column("GCO_WAIT_TIME",             ULonglong(),  NOT_NULL),
+  Column("PRIOR_COMMIT_WAITS",        ULonglong(),  NOT_NULL),
+  Column("PRIOR_COMMIT_WAIT_TIME",    ULonglong(),  NOT_NULL),
+  Column("LOCK_WAITS",                ULonglong(),  NOT_NULL),
+  Column("LOCK_WAIT_TIME",            ULonglong(),  NOT_NULL),
+  Column("RETRIES",                   ULonglong(),  NOT_NULL),
+  Column("RETRY_TIME",                ULonglong(),  NOT_NULL),
+  CEnd()
+};
+
+} // namespace Show
+
+
+static int worker_stats_store(THD *thd, TABLE *table, uint worker_id,
+                              my_thread_id thread_id,
+                              const rpl_parallel_thread *rpt)
+{
+  const rpl_parallel_thread_stats *stats= &rpt->stats;
+  uint field= 0;
+
+  table->field[field++]->store(worker_id, true);
+  if (thread_id)
+  {
+    table->field[field]->set_notnull();
+    table->field[field]->store(thread_id, true);
+  }
+  else
+    table->field[field]->set_null();
+  field++;
+  table->field[field++]->store(rpt->channel_name, rpt->channel_name_length,
+                               system_charset_info);
+  table->field[field++]->store(stats->event_groups, true);
+  table->field[field++]->store(stats->apply_time, true);
+  for (uint b= 0; b < rpl_parallel_thread_stats::APPLY_TIME_BUCKETS; b++)
+    table->field[field++]->store(stats->apply_time_histogram[b], true);
+  for (uint w= 0; w < rpl_parallel_thread_stats::WAIT_CLASSES; w++)
+  {
+    table->field[field++]->store(stats->waits[w], true);
+    table->field[field++]->store(stats->wait_time[w], true);
+  }
+  return schema_table_store_record(thd, table);
+}
+
+/*
+  The pool is marked busy while it is read, so that it is not resized or
+  freed under us. When it has no threads, the copy saved in pfs_bkp when
+  the slave stopped is shown, like in
+  performance_schema.replication_applier_status_by_worker.
+*/
+
+static int worker_stats_fill_table(THD* thd, TABLE_LIST* tables, COND*)
+{
+  rpl_parallel_thread_pool *pool= &global_rpl_thread_pool;
+  TABLE* table= tables->table;
+  int res= 0;
+
+  if (!pool->inited)
+    return 0;
+
+  if (pool_mark_busy(pool, thd))
+    return 1;
+  if (pool->count)
+  {
+    for (uint i= 0; i < pool->count && !res; i++)
+    {
+      rpl_parallel_thread *rpt= pool->threads[i];
+      my_thread_id thread_id= 0;
+
+      /* The worker deletes its THD after clearing rpt->thd under the lock */
+      mysql_mutex_lock(&rpt->LOCK_rpl_thread);
+      if (rpt->thd)
+        thread_id= rpt->thd->thread_id;
+      mysql_mutex_unlock(&rpt->LOCK_rpl_thread);
+      res= worker_stats_store(thd, table, i, thread_id, rpt);
+    }
+  }
+  else if (pool->pfs_bkp.inited)
+  {
+    /* The THDs of the saved workers are gone */
+    for (uint i= 0; i < pool->pfs_bkp.count && !res; i++)
+      res= worker_stats_store(thd, table, i, 0, pool->pfs_bkp.rpl_thread_arr[i]);
+  }
+  pool_mark_not_busy(pool);
+  return res;
+}
+
+static void worker_stats_reset(rpl_parallel_thread_stats *stats)
+{
+  /* Keep the start of the event group or lock wait in progress */
+  ulonglong group_start= stats->group_start;
+  ulonglong lock_wait_start= stats->lock_wait_start;
+  stats->reset();
+  stats->group_start= group_start;
+  stats->lock_wait_start= lock_wait_start;
+}
+
+static int worker_stats_reset_table()
+{
+  rpl_parallel_thread_pool *pool= &global_rpl_thread_pool;
+
+  if (!pool->inited)
+    return 0;
+
+  if (pool_mark_busy(pool, current_thd))
+    return 1;
+  for (uint i= 0; i < pool->count; i++)
+    worker_stats_reset(&pool->threads[i]->stats);
+  if (pool->pfs_bkp.inited)
+  {
+    for (uint i= 0; i < pool->pfs_bkp.count; i++)
+      worker_stats_reset(&pool->pfs_bkp.rpl_thread_arr[i]->stats);
+  }
+  pool_mark_not_busy(pool);
+  return 0;
+}
+
+static int worker_stats_init(void* p)
+{
+  ST_SCHEMA_TABLE* schema= (ST_SCHEMA_TABLE*) p;
+  schema->fields_info= Show::worker_stats_fields_info;
+  schema->fill_table= worker_stats_fill_table;
+  schema->reset_table= worker_stats_reset_table;
+  return 0;
+}
+
+
+namespace Show {
+
+static ST_FIELD_INFO retried_tables_fields_info[] =
+{
+  Column("TABLE_SCHEMA", Name(),      NOT_NULL),
+  Column("TABLE_NAME",   Name(),      NOT_NULL),
+  Column("RETRIES",      ULonglong(), NOT_NULL),
+  CEnd()
+};
+
+} // namespace Show
+
+
+static int retried_tables_fill_table(THD* thd, TABLE_LIST* tables, COND*)
+{
+  rpl_parallel_thread_pool *pool= &global_rpl_thread_pool;
+  TABLE* table= tables->table;
+  int res= 0;
+
+  if (!pool->inited)
+    return 0;
+
+  mysql_mutex_lock(&pool->LOCK_retried_tables);
+  for (ulong i= 0; i < pool->retried_tables.records && !res; i++)
+  {
+    rpl_retried_table *entry=
+      (rpl_retried_table *) my_hash_element(&pool->retried_tables, i);
+    size_t db_length= strlen(entry->key);
+
+    table->field[0]->store(entry->key, db_length, system_charset_info);
+    table->field[1]->store(entry->key + db_length + 1,
+                           entry->key_length - db_length - 1,
+                           system_charset_info);
+    table->field[2]->store(entry->retries, true);
+    res= schema_table_store_record(thd, table);
+  }
+  mysql_mutex_unlock(&pool->LOCK_retried_tables);
+  return res;
+}
+
+static int retried_tables_reset_table()
+{
+  rpl_parallel_thread_pool *pool= &global_rpl_thread_pool;
+
+  if (!pool->inited)
+    return 0;
+
+  mysql_mutex_lock(&pool->LOCK_retried_tables);
+  my_hash_reset(&pool->retried_tables);
+  mysql_mutex_unlock(&pool->LOCK_retried_tables);
+  return 0;
+}
+
+static int retried_tables_init(void* p)
+{
+  ST_SCHEMA_TABLE* schema= (ST_SCHEMA_TABLE*) p;
+  schema->fields_info= Show::retried_tables_fields_info;
+  schema->fill_table= retried_tables_fill_table;
+  schema->reset_table= retried_tables_reset_table;
+  return 0;
+}
+
+static struct st_mysql_information_schema plugin_descriptor =
+{ MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
+
+maria_declare_plugin(rpl_parallel_info)
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &plugin_descriptor,
+  "SLAVE_WORKER_STATS",
+  "MariaDB Corporation",
+  "Provides wait and apply time statistics of parallel replication workers.",
+  PLUGIN_LICENSE_GPL,
+  worker_stats_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &plugin_descriptor,
+  "SLAVE_WORKER_RETRIED_TABLES",
+  "MariaDB Corporation",
+  "Provides the number of parallel replication retries per table.",
+  PLUGIN_LICENSE_GPL,
+  retried_tables_init,
+  0,
+  0x0100,
+  NULL,
+  NULL,
+  "1.0",
+  MariaDB_PLUGIN_MATURITY_STABLE
+}
+maria_declare_plugin_end;
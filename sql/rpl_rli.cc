@@ -686,6 +686,7 @@ int init_relay_log_pos(Relay_log_info* rli,const char* log,
   }
 
   rli->group_relay_log_pos = rli->event_relay_log_pos = pos;
+  rli->payload_reader.reset();
   rli->clear_flag(Relay_log_info::IN_STMT);
   rli->clear_flag(Relay_log_info::IN_TRANSACTION);
 
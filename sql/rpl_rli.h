@@ -214,6 +214,11 @@ class Relay_log_info : public Slave_reporting_capability
   char event_relay_log_name[FN_REFLEN];
   ulonglong event_relay_log_pos;
   ulonglong future_event_relay_log_pos;
+  /*
+    The events left of the Transaction_payload_log_event being applied. They
+    all have the relay log position just after the payload event.
+  */
+  Transaction_payload_reader payload_reader;
   /*
     The master log name for current event. Only used in parallel replication.
   */
@@ -46,7 +46,7 @@
   to guarantee that we read some consistent value.
  */
 static volatile sig_atomic_t segfaulted= 0;
-extern ulong max_used_connections;
+extern std::atomic<ulong> max_used_connections;
 extern volatile sig_atomic_t calling_initgroups;
 
 extern const char *optimizer_switch_names[];
@@ -181,7 +181,7 @@ extern "C" sig_handler handle_fatal_signal(int sig)
                         global_system_variables.read_buff_size);
 
   my_safe_printf_stderr("max_used_connections=%lu\n",
-                        max_used_connections);
+                        max_used_connections.load(std::memory_order_relaxed));
 
   if (thread_scheduler)
     my_safe_printf_stderr("max_threads=%lu\n",
@@ -6630,6 +6630,20 @@ static int queue_event(Master_info* mi, const uchar *buf, ulong event_len)
       goto err;
     }
 
+    /*
+      The master is idle; write out what relay_log_buffer_size kept in
+      memory, so the relay log file does not lag behind.
+    */
+    if (relay_log_buffer_size)
+    {
+      mysql_mutex_lock(log_lock);
+      if (flush_io_cache(rli->relay_log.get_log_file()))
+        error= ER_SLAVE_RELAY_LOG_WRITE_FAILURE;
+      mysql_mutex_unlock(log_lock);
+      if (unlikely(error))
+        goto err;
+    }
+
     /*
       Heartbeat events doesn't count in the binlog size, so we don't have to
       increment mi->master_log_pos
@@ -7566,6 +7580,22 @@ static Log_event* next_event(rpl_group_info *rgi, ulonglong *event_size)
 
   while (!sql_slave_killed(rgi))
   {
+    /*
+      The events of a transaction payload event are returned one by one
+      before anything more is read from the relay log. They keep the
+      positions of the payload event.
+    */
+    if (rli->payload_reader.has_events())
+    {
+      if (!(ev= rli->payload_reader.read_event(
+                  rli->relay_log.description_event_for_exec,
+                  opt_slave_sql_verify_checksum, &errmsg)))
+        goto err;
+      *event_size= ev->data_written;
+      rli->sql_thread_caught_up= false;
+      DBUG_RETURN(ev);
+    }
+
     /*
       We can have two kinds of log reading:
       hot_log:
@@ -7642,6 +7672,15 @@ static Log_event* next_event(rpl_group_info *rgi, ulonglong *event_size)
 
       if (hot_log)
         mysql_mutex_unlock(log_lock);
+      if (ev->get_type_code() == TRANSACTION_PAYLOAD_EVENT)
+      {
+        bool failed= rli->payload_reader.load(
+                       (Transaction_payload_log_event *) ev, &errmsg);
+        delete ev;
+        if (failed)
+          goto err;
+        continue;
+      }
       rli->sql_thread_caught_up= false;
       DBUG_RETURN(ev);
     }
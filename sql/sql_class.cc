@@ -55,11 +55,13 @@
 #include "sp_head.h"
 #include "sp_rcontext.h"
 #include "sp_cache.h"
+#include "item_jsonfunc.h"                     // json_key_index_cache_clear
 #include "sql_show.h"                           // append_identifier
 #include "transaction.h"
 #include "sql_select.h" /* declares create_tmp_table() */
 #include "debug_sync.h"
 #include "sql_parse.h"                          // is_update_query
+#include "sql_prepare.h"                        // bulk_parameters_row
 #include "sql_callback.h"
 #include "lock.h"
 #include "wsrep_mysqld.h"
@@ -736,6 +738,10 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
   status_var.local_memory_used= sizeof(THD);
   status_var.max_local_memory_used= status_var.local_memory_used;
   status_var.global_memory_used= 0;
+  bzero((char*) &status_var_in_shard, sizeof(status_var_in_shard));
+  status_shard= -1;
+  next_running_in_shard= NULL;
+  prev_running_in_shard= NULL;
   variables.pseudo_thread_id= thread_id;
   variables.max_mem_used= global_system_variables.max_mem_used;
   main_da.init();
@@ -865,6 +871,7 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
   sp_func_cache= NULL;
   sp_package_spec_cache= NULL;
   sp_package_body_cache= NULL;
+  json_key_indexes= NULL;
 
   /* For user vars replication*/
   if (opt_bin_log)
@@ -1393,6 +1400,9 @@ void THD::init_for_queries()
   set_time();
   reset_root_defaults(mem_root, variables.query_alloc_block_size,
                       variables.query_prealloc_size);
+  set_root_keep_limit(mem_root, variables.query_prealloc_size +
+                      QUERY_ALLOC_KEEP_BLOCKS *
+                      variables.query_alloc_block_size);
   reset_root_defaults(&transaction->mem_root,
                       variables.trans_alloc_block_size,
                       variables.trans_prealloc_size);
@@ -1573,6 +1583,7 @@ void THD::cleanup(void)
   sp_cache_clear(&sp_func_cache);
   sp_cache_clear(&sp_package_spec_cache);
   sp_cache_clear(&sp_package_body_cache);
+  json_key_index_cache_clear(&json_key_indexes);
   auto_inc_intervals_forced.empty();
   auto_inc_intervals_in_cur_stmt_for_binlog.empty();
 
@@ -1851,6 +1862,215 @@ void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
   */
 }
 
+
+Status_shards status_shards;
+
+void Status_shards::init()
+{
+  for (uint i= 0; i < SHARDS; i++)
+  {
+    mysql_mutex_init(key_LOCK_status_shard, &shards[i].lock, MY_MUTEX_INIT_FAST);
+    bzero((char*) &shards[i].status, sizeof(shards[i].status));
+  }
+}
+
+
+void Status_shards::destroy()
+{
+  for (uint i= 0; i < SHARDS; i++)
+    mysql_mutex_destroy(&shards[i].lock);
+}
+
+
+/*
+  Add the difference between two status variable arrays to another one
+  and make the subtracted array equal to the added one, in one pass.
+
+  SYNOPSIS
+    fold_status
+    to_var       add to this array
+    from_var     from this array
+    base_var     minus this array, set to from_var
+*/
+
+static void fold_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
+                        STATUS_VAR *base_var)
+{
+  ulong *end= (ulong*) ((uchar*) to_var + offsetof(STATUS_VAR,
+                                                  last_system_status_var) +
+                        sizeof(ulong));
+  ulong *to= (ulong*) to_var, *from= (ulong*) from_var;
+  ulong *base= (ulong*) base_var;
+
+  while (to != end)
+  {
+    ulong value= *(from++);
+    *(to++)+= value - *base;
+    *(base++)= value;
+  }
+
+#define FOLD_STATUS(X)                                          \
+  do {                                                          \
+    auto value= from_var->X;                                    \
+    to_var->X+= value - base_var->X;                            \
+    base_var->X= value;                                         \
+  } while (0)
+  FOLD_STATUS(bytes_received);
+  FOLD_STATUS(bytes_sent);
+  FOLD_STATUS(rows_read);
+  FOLD_STATUS(rows_sent);
+  FOLD_STATUS(rows_tmp_read);
+  FOLD_STATUS(binlog_bytes_written);
+  FOLD_STATUS(cpu_time);
+  FOLD_STATUS(busy_time);
+  FOLD_STATUS(table_open_cache_hits);
+  FOLD_STATUS(table_open_cache_misses);
+  FOLD_STATUS(table_open_cache_overflows);
+  FOLD_STATUS(local_memory_used);
+  FOLD_STATUS(global_memory_used);
+#undef FOLD_STATUS
+}
+
+
+void Status_shards::Shard::add_running(THD *thd)
+{
+  mysql_mutex_assert_owner(&lock);
+  if ((thd->next_running_in_shard= running_threads))
+    running_threads->prev_running_in_shard= &thd->next_running_in_shard;
+  thd->prev_running_in_shard= &running_threads;
+  running_threads= thd;
+  running++;
+}
+
+
+void Status_shards::Shard::remove_running(THD *thd)
+{
+  mysql_mutex_assert_owner(&lock);
+  if ((*thd->prev_running_in_shard= thd->next_running_in_shard))
+    thd->next_running_in_shard->prev_running_in_shard=
+      thd->prev_running_in_shard;
+  thd->prev_running_in_shard= NULL;
+  running--;
+}
+
+
+/**
+  Add a thread to a slot. Called when it is added to server_threads,
+  before it runs any command.
+*/
+
+void Status_shards::link(THD *thd)
+{
+  DBUG_ASSERT(thd->status_shard < 0);
+  uint idx= (uint) (thd->thread_id % SHARDS);
+  Shard *shard= &shards[idx];
+  mysql_mutex_lock(&shard->lock);
+  if (!thd->status_in_global)
+    fold_status(&shard->status, &thd->status_var, &thd->status_var_in_shard);
+  shard->threads++;
+  if (thd->get_command() != COM_SLEEP)
+    shard->add_running(thd);
+  thd->status_shard= (int) idx;
+  mysql_mutex_unlock(&shard->lock);
+}
+
+
+/**
+  Take a thread out of its slot. Called when it is removed from
+  server_threads.
+*/
+
+void Status_shards::unlink(THD *thd)
+{
+  static STATUS_VAR zero;
+  Shard *shard= &shards[thd->status_shard];
+  mysql_mutex_lock(&shard->lock);
+  fold_status(&shard->status, &zero, &thd->status_var_in_shard);
+  shard->threads--;
+  if (thd->prev_running_in_shard)
+    shard->remove_running(thd);
+  thd->status_shard= -1;
+  mysql_mutex_unlock(&shard->lock);
+}
+
+
+/**
+  Account for a change of the command of a thread: the change of its
+  status since the last fold is added to its slot, and it is put on or
+  taken off the list of running threads of the slot.
+*/
+
+void Status_shards::set_command(THD *thd, enum enum_server_command command)
+{
+  Shard *shard= &shards[thd->status_shard];
+  mysql_mutex_lock(&shard->lock);
+  if (!thd->status_in_global)
+    fold_status(&shard->status, &thd->status_var, &thd->status_var_in_shard);
+  if (command == COM_SLEEP)
+  {
+    if (thd->prev_running_in_shard)
+      shard->remove_running(thd);
+  }
+  else if (!thd->prev_running_in_shard)
+    shard->add_running(thd);
+  mysql_mutex_unlock(&shard->lock);
+}
+
+
+/**
+  Take the status of a thread out of its slot, before it is added to
+  global_status_var or reset.
+*/
+
+void Status_shards::remove(THD *thd)
+{
+  static STATUS_VAR zero;
+  Shard *shard= &shards[thd->status_shard];
+  mysql_mutex_lock(&shard->lock);
+  fold_status(&shard->status, &zero, &thd->status_var_in_shard);
+  mysql_mutex_unlock(&shard->lock);
+}
+
+
+/**
+  Add the status counters of all slots to a status variable array.
+
+  Threads that are not in COM_SLEEP may run for a long time without
+  changing their command (replication threads, the event scheduler,
+  long queries), so the change of their status since their last fold
+  is added as well. Like before status_shards, their status_var is
+  read while they may update it.
+
+  @return number of threads in server_threads
+*/
+
+uint Status_shards::add_to(STATUS_VAR *to)
+{
+  uint threads= 0;
+  for (uint i= 0; i < SHARDS; i++)
+  {
+    Shard *shard= &shards[i];
+    mysql_mutex_lock(&shard->lock);
+    add_to_status(to, &shard->status);
+    to->local_memory_used+= shard->status.local_memory_used;
+    for (THD *thd= shard->running_threads; thd;
+         thd= thd->next_running_in_shard)
+    {
+      if (thd->status_in_global)
+        continue;
+      add_diff_to_status(to, &thd->status_var, &thd->status_var_in_shard);
+      to->local_memory_used+= thd->status_var.local_memory_used -
+                              thd->status_var_in_shard.local_memory_used;
+      to->global_memory_used+= thd->status_var.global_memory_used -
+                               thd->status_var_in_shard.global_memory_used;
+    }
+    threads+= shard->threads;
+    to->threads_running+= shard->running;
+    mysql_mutex_unlock(&shard->lock);
+  }
+  return threads;
+}
+
 #define SECONDS_TO_WAIT_FOR_KILL 2
 #if !defined(_WIN32) && defined(HAVE_SELECT)
 /* my_sleep() can wait for sub second times */
@@ -2291,6 +2511,8 @@ void THD::cleanup_after_query()
   arg_of_last_insert_id_function= 0;
   /* Free Items that were created during this execution */
   free_items();
+  /* Forget the JSON documents the statement has searched */
+  json_key_index_cache_clear(&json_key_indexes);
   /* Reset where. */
   where= THD::DEFAULT_WHERE;
   /* reset table map for multi-table update */
@@ -3140,6 +3362,53 @@ bool select_send::send_eof()
 }
 
 
+/*
+  The metadata goes out with the first parameter row only; the diagnostics
+  area is already set by the following ones.
+*/
+
+bool select_send_bulk::send_result_set_metadata(List<Item> &list, uint flags)
+{
+  if (thd->get_stmt_da()->is_set())
+    return FALSE;
+
+  List<Item> tagged;
+  Item *row_index= new (thd->mem_root)
+    Item_uint(thd, "bulk_row", 0, MY_INT64_NUM_DECIMAL_DIGITS);
+  if (!row_index || tagged.push_back(row_index, thd->mem_root))
+    return TRUE;
+  List_iterator_fast<Item> it(list);
+  while (Item *item= it++)
+  {
+    if (tagged.push_back(item, thd->mem_root))
+      return TRUE;
+  }
+  return select_send::send_result_set_metadata(tagged, flags);
+}
+
+
+int select_send_bulk::send_data(List<Item> &items)
+{
+  Protocol *protocol= thd->protocol;
+  DBUG_ENTER("select_send_bulk::send_data");
+
+  protocol->prepare_for_resend();
+  if (protocol->store_longlong(bulk_parameters_row(thd), TRUE) ||
+      protocol->send_result_set_row(&items))
+  {
+    protocol->remove_last_row();
+    DBUG_RETURN(TRUE);
+  }
+
+  thd->inc_sent_row_count(1);
+
+  if (likely(thd->vio_ok()))
+    DBUG_RETURN(protocol->write());
+
+  DBUG_RETURN(0);
+}
+
+
 /************************************************************************
   Handling writing to file
 ************************************************************************/
@@ -5570,6 +5839,12 @@ extern "C" void thd_wait_begin(MYSQL_THD thd, int wait_type)
     if (unlikely(!thd))
       return;
   }
+#ifdef HAVE_REPLICATION
+  /* Lock waits of parallel replication workers, see SLAVE_WORKER_STATS */
+  if (unlikely(thd->rgi_slave && thd->rgi_slave->rpt) &&
+      (wait_type == THD_WAIT_ROW_LOCK || wait_type == THD_WAIT_TABLE_LOCK))
+    thd->rgi_slave->rpt->stats.lock_wait_start= microsecond_interval_timer();
+#endif
   MYSQL_CALLBACK(thd->scheduler, thd_wait_begin, (thd, wait_type));
 }
 
@@ -5588,6 +5863,18 @@ extern "C" void thd_wait_end(MYSQL_THD thd)
     if (unlikely(!thd))
       return;
   }
+#ifdef HAVE_REPLICATION
+  if (unlikely(thd->rgi_slave && thd->rgi_slave->rpt))
+  {
+    rpl_parallel_thread_stats *stats= &thd->rgi_slave->rpt->stats;
+    if (stats->lock_wait_start)
+    {
+      stats->add_wait(rpl_parallel_thread_stats::WAIT_FOR_LOCK,
+                      stats->lock_wait_start);
+      stats->lock_wait_start= 0;
+    }
+  }
+#endif
   MYSQL_CALLBACK(thd->scheduler, thd_wait_end, (thd));
 }
 
@@ -7041,6 +7328,8 @@ int THD::binlog_write_row(TABLE* table, bool is_trans,
   if (variables.option_bits & OPTION_GTID_BEGIN)
     is_trans= 1;
 
+  binlog_add_writeset(this, is_trans, table, record, NULL, NULL);
+
   Rows_log_event* ev;
   if (binlog_should_compress(len))
     ev =
@@ -7104,6 +7393,11 @@ int THD::binlog_update_row(TABLE* table, bool is_trans,
   if (variables.option_bits & OPTION_GTID_BEGIN)
     is_trans= 1;
 
+  binlog_add_writeset(this, is_trans, table, before_record, old_read_set,
+                      table->write_set);
+  binlog_add_writeset(this, is_trans, table, after_record, old_read_set,
+                      table->write_set);
+
   /*
     Don't print debug messages when running valgrind since they can
     trigger false warnings.
@@ -7180,6 +7474,8 @@ int THD::binlog_delete_row(TABLE* table, bool is_trans,
   if (variables.option_bits & OPTION_GTID_BEGIN)
     is_trans= 1;
 
+  binlog_add_writeset(this, is_trans, table, record, old_read_set, NULL);
+
   Rows_log_event* ev;
   if(binlog_should_compress(len))
     ev =
@@ -7926,6 +8222,7 @@ wait_for_commit::wait_for_prior_commit2(THD *thd)
   PSI_stage_info old_stage;
   wait_for_commit *loc_waitee;
   bool backup_lock_released= 0;
+  ulonglong wait_start= microsecond_interval_timer();
 
   /*
     Release MDL_BACKUP_COMMIT LOCK while waiting for other threads to commit
@@ -7991,6 +8288,9 @@ wait_for_commit::wait_for_prior_commit2(THD *thd)
   if (backup_lock_released)
     thd->mdl_context.acquire_lock(thd->backup_commit_lock,
                                   thd->variables.lock_wait_timeout);
+#ifdef HAVE_REPLICATION
+  rpl_count_prior_commit_wait(thd, wait_start);
+#endif
   return wakeup_error;
 
 end:
@@ -7998,6 +8298,9 @@ wait_for_commit::wait_for_prior_commit2(THD *thd)
   if (backup_lock_released)
     thd->mdl_context.acquire_lock(thd->backup_commit_lock,
                                   thd->variables.lock_wait_timeout);
+#ifdef HAVE_REPLICATION
+  rpl_count_prior_commit_wait(thd, wait_start);
+#endif
   return wakeup_error;
 }
 
@@ -88,6 +88,7 @@ class Load_log_event;
 class Log_event_writer;
 class sp_rcontext;
 class sp_cache;
+class Json_key_index_cache;
 class Lex_input_stream;
 class Parser_state;
 class Rows_log_event;
@@ -785,6 +786,7 @@ typedef struct system_variables
   my_bool sql_log_slow;
   my_bool sql_log_bin;
   my_bool binlog_annotate_row_events;
+  my_bool binlog_transaction_compression;
   my_bool binlog_direct_non_trans_update;
   my_bool column_compression_zlib_wrap;
 
@@ -922,6 +924,8 @@ typedef struct system_status_var
   ulong opened_tables;
   ulong opened_shares;
   ulong opened_views;               /* +1 opening a view */
+  ulong mem_root_blocks_allocated;  /* +1 malloc for THD::mem_root */
+  ulong mem_root_blocks_reused;     /* +1 block kept between statements */
 
   ulong select_full_join_count_;
   ulong select_full_range_join_count_;
@@ -1028,15 +1032,61 @@ void add_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var);
 void add_diff_to_status(STATUS_VAR *to_var, STATUS_VAR *from_var,
                         STATUS_VAR *dec_var);
 
+/**
+  Status counters of the threads in server_threads, kept in a number of
+  separately locked slots.
+
+  A thread is assigned a slot when it is added to server_threads. Each
+  time its command changes it folds the change of its status variables
+  and of its memory usage since the previous fold into the slot, and it
+  takes its part out again when its status is moved to global_status_var
+  or when it leaves server_threads. The slots also count the threads and
+  keep a list of the threads that are not in COM_SLEEP.
+
+  The global status is then global_status_var plus the sum of the slots
+  plus what the threads on the running lists did since their last fold,
+  so calc_sum_of_all_status() only looks at the threads that are busy.
+*/
+
+class Status_shards
+{
+public:
+  static constexpr uint SHARDS= 32;
+
+  void init();
+  void destroy();
+  void link(THD *thd);
+  void unlink(THD *thd);
+  void set_command(THD *thd, enum enum_server_command command);
+  void remove(THD *thd);
+  uint add_to(STATUS_VAR *to);
+
+private:
+  /* All members are protected by lock */
+  struct alignas(CPU_LEVEL1_DCACHE_LINESIZE) Shard
+  {
+    mysql_mutex_t lock;
+    STATUS_VAR status;
+    /* Number of threads in the slot */
+    uint threads;
+    /* Threads in the slot that are not in COM_SLEEP, and their number */
+    THD *running_threads;
+    uint running;
+    void add_running(THD *thd);
+    void remove_running(THD *thd);
+  };
+  Shard shards[SHARDS];
+};
+
+extern Status_shards status_shards;
+
 uint calc_sum_of_all_status(STATUS_VAR *to);
+uint global_status_snapshot(STATUS_VAR *to);
 static inline void calc_sum_of_all_status_if_needed(STATUS_VAR *to)
 {
   if (to->local_memory_used == 0)
   {
-    mysql_mutex_lock(&LOCK_status);
-    *to= global_status_var;
-    mysql_mutex_unlock(&LOCK_status);
-    calc_sum_of_all_status(to);
+    global_status_snapshot(to);
     DBUG_ASSERT(to->local_memory_used);
   }
 }
@@ -2633,6 +2683,12 @@ class THD: public THD_count, /* this must be first */
   struct  my_rnd_struct rand;		// used for authentication
   struct  system_variables variables;	// Changeable local variables
   struct  system_status_var status_var; // Per thread statistic vars
+  /* Value of status_var when it was last folded into status_shards */
+  struct  system_status_var status_var_in_shard;
+  /* Slot of this thread in status_shards, -1 if not in server_threads */
+  int     status_shard;
+  /* List of running threads of the slot, prev is NULL if not in it */
+  THD     *next_running_in_shard, **prev_running_in_shard;
   struct  system_status_var org_status_var; // For user statistics
   struct  system_status_var *initial_status_var; /* used by show status */
   THR_LOCK_INFO lock_info;              // Locking info of this thread
@@ -3594,6 +3650,8 @@ class THD: public THD_count, /* this must be first */
   sp_cache   *sp_func_cache;
   sp_cache   *sp_package_spec_cache;
   sp_cache   *sp_package_body_cache;
+  /* Indexes of the JSON documents searched by the statement */
+  Json_key_index_cache *json_key_indexes;
 
   /** number of name_const() substitutions, see sp_head.cc:subst_spvars() */
   uint       query_name_consts;
@@ -4506,6 +4564,11 @@ class THD: public THD_count, /* this must be first */
              (variables.sql_mode & MODE_STRICT_ALL_TABLES)));
   }
   void set_status_var_init();
+  void remove_status_from_shard()
+  {
+    if (status_shard >= 0)
+      status_shards.remove(this);
+  }
   void reset_n_backup_open_tables_state(Open_tables_backup *backup);
   void restore_backup_open_tables_state(Open_tables_backup *backup);
   void reset_sub_statement_state(Sub_statement_state *backup, uint new_state);
@@ -4903,6 +4966,9 @@ class THD: public THD_count, /* this must be first */
   virtual void set_statement(Statement *stmt);
   void set_command(enum enum_server_command command)
   {
+    /* Keep Threads_running and the status in status_shards up to date */
+    if (status_shard >= 0)
+      status_shards.set_command(this, command);
     m_command= command;
 #ifdef HAVE_PSI_THREAD_INTERFACE
     PSI_STATEMENT_CALL(set_thread_command)(m_command);
@@ -5033,6 +5099,7 @@ class THD: public THD_count, /* this must be first */
   void add_status_to_global()
   {
     DBUG_ASSERT(status_in_global == 0);
+    remove_status_from_shard();
     mysql_mutex_lock(&LOCK_status);
     add_to_status(&global_status_var, &status_var);
     /* Mark that this THD status has already been added in global status */
@@ -5947,6 +6014,21 @@ class select_send :public select_result {
 };
 
 
+/*
+  Result of a SELECT executed for an array of parameters
+  (COM_STMT_BULK_EXECUTE): the rows of all parameter rows are sent as one
+  result set, each row prefixed with the index of its parameter row.
+*/
+
+class select_send_bulk :public select_send
+{
+public:
+  select_send_bulk(THD *thd_arg): select_send(thd_arg) {}
+  bool send_result_set_metadata(List<Item> &list, uint flags);
+  int send_data(List<Item> &items);
+};
+
+
 /*
   We need this class, because select_send::send_eof() will call ::my_eof.
 
@@ -7782,6 +7864,7 @@ class THD_list: public THD_list_iterator
   */
   void insert(THD *thd)
   {
+    status_shards.link(thd);
     mysql_rwlock_wrlock(&lock);
     threads.append(thd);
     mysql_rwlock_unlock(&lock);
@@ -7800,6 +7883,7 @@ class THD_list: public THD_list_iterator
     mysql_rwlock_wrlock(&lock);
     thd->unlink();
     mysql_rwlock_unlock(&lock);
+    status_shards.unlink(thd);
   }
 };
 
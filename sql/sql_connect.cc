@@ -1352,9 +1352,10 @@ bool thd_is_connection_alive(THD *thd)
 void do_handle_one_connection(CONNECT *connect, bool put_in_cache)
 {
   ulonglong thr_create_utime= microsecond_interval_timer();
-  THD *thd;
-  if (!(thd= connect->create_thd(NULL)))
+  THD *thd, *cached_thd= thd_cache.get();
+  if (!(thd= connect->create_thd(cached_thd)))
   {
+    delete cached_thd;
     connect->close_and_delete();
     return;
   }
@@ -1456,7 +1457,10 @@ void do_handle_one_connection(CONNECT *connect, bool put_in_cache)
 
     server_threads.insert(thd);
   }
-  delete thd;
+  if (thd->free_connection_done)
+    thd_cache.put(thd);
+  else
+    delete thd;
 }
 #endif /* EMBEDDED_LIBRARY */
 
@@ -1580,3 +1584,71 @@ THD *CONNECT::create_thd(THD *thd)
 
   DBUG_RETURN(thd);
 }
+
+
+/* Handling of the THD cache, see class THD_cache */
+
+/**
+  Takes a THD from the cache.
+
+  @return THD to pass to CONNECT::create_thd(), or 0 if the cache is empty
+*/
+
+THD *THD_cache::get()
+{
+  mysql_mutex_lock(&LOCK_thd_cache);
+  THD *thd= list.get();
+  if (thd)
+    cached_thd_count--;
+  mysql_mutex_unlock(&LOCK_thd_cache);
+  /* Memory allocated when resetting the THD is accounted to it */
+  if (thd)
+    set_current_thd(thd);
+  return thd;
+}
+
+
+/**
+  Puts the THD of a closed connection into the cache, or deletes it if
+  the cache is full.
+
+  Must be called after unlink_thd(), when the THD is no longer in use.
+*/
+
+void THD_cache::put(THD *thd)
+{
+  if (!IF_WSREP(thd->wsrep_applier, false))
+  {
+    /* Detach the THD from the instrumentation and from this thread */
+    if (PSI_thread *psi= thd->get_psi())
+      PSI_CALL_set_thread_THD(psi, 0);
+    thd->set_psi(NULL);
+    thd->reset_globals();
+
+    mysql_mutex_lock(&LOCK_thd_cache);
+    if (!closed && cached_thd_count < thread_cache_size)
+    {
+      list.append(thd);
+      cached_thd_count++;
+      mysql_mutex_unlock(&LOCK_thd_cache);
+      return;
+    }
+    mysql_mutex_unlock(&LOCK_thd_cache);
+  }
+  delete thd;
+}
+
+
+/** Deletes all cached THD objects. */
+
+void THD_cache::flush()
+{
+  I_List<THD> flushed;
+  mysql_mutex_lock(&LOCK_thd_cache);
+  list.move_elements_to(&flushed);
+  cached_thd_count= 0;
+  mysql_mutex_unlock(&LOCK_thd_cache);
+
+  while (THD *thd= flushed.get())
+    delete thd;
+}
@@ -177,6 +177,11 @@
 
 #define QUERY_ALLOC_BLOCK_SIZE		16384
 #define QUERY_ALLOC_PREALLOC_SIZE   	24576
+/*
+  Besides query_prealloc_size, this many blocks of query_alloc_block_size
+  are kept between statements (see set_root_keep_limit())
+*/
+#define QUERY_ALLOC_KEEP_BLOCKS		8
 #define TRANS_ALLOC_BLOCK_SIZE		8192
 #define TRANS_ALLOC_PREALLOC_SIZE	4096
 #define RANGE_ALLOC_BLOCK_SIZE		4096
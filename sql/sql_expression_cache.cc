@@ -138,6 +138,16 @@ void Expression_cache_tmptable::init()
     goto error;
   }
 
+  /* The parameters are the key, heap tables can't have blobs in keys */
+  for (Field **field= cache_table->field + 1; *field; field++)
+  {
+    if ((*field)->flags & BLOB_FLAG)
+    {
+      DBUG_PRINT("error", ("blob parameter"));
+      goto error;
+    }
+  }
+
   field_counter= 1;
 
   if (cache_table->alloc_keys(1) ||
@@ -1385,7 +1385,7 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
     if (init_io_cache(&cache,(get_it_from_net) ? -1 : file, 0,
 		      (get_it_from_net) ? READ_NET :
 		      (is_fifo ? READ_FIFO : READ_CACHE),0L,1,
-		      MYF(MY_WME | MY_THREAD_SPECIFIC)))
+		      MYF(MY_WME | MY_THREAD_SPECIFIC | MY_READ_AHEAD)))
     {
       error=1;
     }
@@ -621,7 +621,8 @@ void init_update_queries(void)
   sql_command_flags[SQLCOM_SELECT]=         CF_REEXECUTION_FRAGILE |
                                             CF_CAN_GENERATE_ROW_EVENTS |
                                             CF_OPTIMIZER_TRACE |
-                                            CF_CAN_BE_EXPLAINED;
+                                            CF_CAN_BE_EXPLAINED |
+                                            CF_PS_ARRAY_BINDING_SAFE;
   // (1) so that subquery is traced when doing "SET @var = (subquery)"
   /*
     @todo SQLCOM_SET_OPTION should have CF_CAN_GENERATE_ROW_EVENTS
@@ -2263,8 +2264,7 @@ dispatch_command_return dispatch_command(enum enum_server_command command, THD *
       break;
     general_log_print(thd, command, NullS);
     status_var_increment(thd->status_var.com_stat[SQLCOM_SHOW_STATUS]);
-    *current_global_status_var= global_status_var;
-    calc_sum_of_all_status(current_global_status_var);
+    global_status_snapshot(current_global_status_var);
     if (!(uptime= (ulong) (thd->start_time - server_start_time)))
       queries_per_second1000= 0;
     else
@@ -2463,6 +2463,11 @@ dispatch_command_return dispatch_command(enum enum_server_command command, THD *
   */
   thd->lex->m_sql_cmd= NULL;
   free_root(thd->mem_root,MYF(MY_KEEP_PREALLOC));
+  thd->status_var.mem_root_blocks_allocated+=
+    (ulong) thd->mem_root->blocks_allocated;
+  thd->status_var.mem_root_blocks_reused+=
+    (ulong) thd->mem_root->blocks_reused;
+  thd->mem_root->blocks_allocated= thd->mem_root->blocks_reused= 0;
 
 #if defined(ENABLED_PROFILING)
   thd->profiling.finish_current_query();
@@ -6259,12 +6264,18 @@ static bool execute_sqlcom_select(THD *thd, TABLE_LIST *all_tables)
           thd->protocol= new Protocol_discard(thd);
         }
       }
+      else if (!result && thd->is_bulk_op())
+      {
+        if (!(result= new (thd->mem_root) select_send_bulk(thd)))
+          return 1;                               /* purecov: inspected */
+      }
       else
       {
         if (!result && !(result= new (thd->mem_root) select_send(thd)))
           return 1;                               /* purecov: inspected */
       }
-      query_cache_store_query(thd, all_tables);
+      if (!thd->is_bulk_op())
+        query_cache_store_query(thd, all_tables);
       res= handle_select(thd, lex, result, 0);
       if (result != lex->result)
         delete result;
@@ -184,6 +184,8 @@ class Prepared_statement: public Statement
   my_bool iterations;
   my_bool start_param;
   my_bool read_types;
+  /* Number of parameter rows of the bulk operation read so far */
+  ulonglong bulk_rows;
 
 #ifndef EMBEDDED_LIBRARY
   bool (*set_params)(Prepared_statement *st, uchar *data, uchar *data_end,
@@ -218,6 +220,7 @@ class Prepared_statement: public Statement
   bool execute_server_runnable(Server_runnable *server_runnable);
   my_bool set_bulk_parameters(bool reset);
   bool bulk_iterations() { return iterations; };
+  ulonglong bulk_row() { return bulk_rows - 1; }
   /* Destroy this statement */
   void deallocate();
   bool execute_immediate(const char *query, uint query_length);
@@ -4125,6 +4128,7 @@ Prepared_statement::Prepared_statement(THD *thd_arg)
   iterations(0),
   start_param(0),
   read_types(0),
+  bulk_rows(0),
   m_sql_mode(thd->variables.sql_mode)
 {
   init_sql_alloc(key_memory_prepared_statement_main_mem_root,
@@ -4683,6 +4687,19 @@ my_bool bulk_parameters_iterations(THD *thd)
 }
 
 
+/**
+  Index (starting from 0) of the parameter row the bulk operation is
+  currently executed for.
+*/
+
+ulonglong bulk_parameters_row(THD *thd)
+{
+  Prepared_statement *stmt= (Prepared_statement *) thd->bulk_param;
+  DBUG_ASSERT(stmt);
+  return stmt->bulk_row();
+}
+
+
 my_bool Prepared_statement::set_bulk_parameters(bool reset)
 {
   DBUG_ENTER("Prepared_statement::set_bulk_parameters");
@@ -4701,6 +4718,7 @@ my_bool Prepared_statement::set_bulk_parameters(bool reset)
       reset_stmt_params(this);
       DBUG_RETURN(true);
     }
+    bulk_rows++;
     if (packet >= packet_end)
       iterations= FALSE;
   }
@@ -4721,6 +4739,7 @@ Prepared_statement::execute_bulk_loop(String *expanded_query,
   packet_end= packet_end_arg;
   iterations= TRUE;
   start_param= true;
+  bulk_rows= 0;
 #ifdef DBUG_ASSERT_EXISTS
   Item *free_list_state= thd->free_list;
 #endif
@@ -4745,15 +4764,29 @@ Prepared_statement::execute_bulk_loop(String *expanded_query,
     my_error(ER_UNSUPPORTED_PS, MYF(0));
     goto err;
   }
+  if (lex->sql_command == SQLCOM_SELECT)
+  {
+    /*
+      Only a plain single-table SELECT can be executed for an array of
+      parameters: every parameter row produces its rows of one common
+      result set, tagged with the index of the parameter row.
+    */
+    if (open_cursor || lex->result || lex->describe || lex->analyze_stmt ||
+        lex->unit.first_select()->next_select() ||
+        !lex->query_tables || lex->query_tables->next_global)
+    {
+      DBUG_PRINT("error", ("SELECT is not supported in bulk execution."));
+      my_error(ER_UNSUPPORTED_PS, MYF(0));
+      goto err;
+    }
+  }
   /*
      Here second buffer for not optimized commands,
      optimized commands do it inside thier internal loop.
   */
   if (!(sql_command_flags[lex->sql_command] & CF_PS_ARRAY_BINDING_OPTIMIZED) &&
-      this->lex->has_returning())
+      (this->lex->has_returning() || lex->sql_command == SQLCOM_SELECT))
   {
-    // Above check can be true for SELECT in future
-    DBUG_ASSERT(lex->sql_command != SQLCOM_SELECT);
     readbuff= thd->net.buff; // old buffer
     if (net_allocate_new_packet(&thd->net, thd, MYF(MY_THREAD_SPECIFIC)))
     {
@@ -5210,9 +5243,10 @@ bool Prepared_statement::execute(String *expanded_query, bool open_cursor)
     /*
       Try to find it in the query cache, if not, execute it.
       Note that multi-statements cannot exist here (they are not supported in
-      prepared statements).
+      prepared statements). Results of bulk operations are never cached.
     */
-    if (query_cache_send_result_to_client(thd, thd->query(),
+    if (thd->is_bulk_op() ||
+        query_cache_send_result_to_client(thd, thd->query(),
                                           thd->query_length()) <= 0)
     {
       MYSQL_QUERY_EXEC_START(thd->query(), thd->thread_id, thd->get_db(),
@@ -354,7 +354,10 @@ bool reload_acl_and_cache(THD *thd, unsigned long long options,
   if (thd && (options & REFRESH_STATUS))
     refresh_status(thd);
   if (options & REFRESH_THREADS)
+  {
     thread_cache.flush();
+    thd_cache.flush();
+  }
 #ifdef HAVE_REPLICATION
   if (options & REFRESH_MASTER)
   {
@@ -162,6 +162,10 @@ struct binlog_send_info {
   bool clear_initial_log_pos;
   bool should_stop;
   size_t dirlen;
+  /** Binlog_tail_cache generation when the current file was opened */
+  ulong tail_cache_generation;
+  /** Rebuilds the missing GTID index of the current file */
+  Gtid_index_writer gtid_index_builder;
 
   binlog_send_info(THD *thd_arg, String *packet_arg, ushort flags_arg,
                    char *lfn)
@@ -180,7 +184,8 @@ struct binlog_send_info {
       hb_info_counter(0),
 #endif
       clear_initial_log_pos(false),
-      should_stop(false)
+      should_stop(false),
+      tail_cache_generation(0)
   {
     error_text[0] = 0;
     bzero(&error_gtid, sizeof(error_gtid));
@@ -2664,6 +2669,416 @@ static my_off_t get_binlog_end_pos(binlog_send_info *info,
   return 0;
 }
 
+/*
+  Copy of the most recently read events of the newest binlog file, shared
+  by all binlog dump threads.
+
+  Events are added by the dump thread that reads them from the file first,
+  after decryption and checksum verification; dump threads that follow it
+  closely get the events from memory instead of reading the file again.
+  The cached events always form one contiguous range of positions in one
+  file, oldest events are dropped when space is needed.
+
+  RESET MASTER recreates binlog files with the same names, so the cache
+  has a generation that is increased when it is cleared; dump threads only
+  use the cache with the generation they saw before opening the file.
+
+  The index of the events is allocated from binlog_tail_cache_size too.
+  One event is added at a time: space is reserved for it under the write
+  lock, it is copied without the lock, and made visible under the write
+  lock again, so readers are only blocked for the bookkeeping.
+*/
+
+class Binlog_tail_cache
+{
+public:
+  Binlog_tail_cache()
+    : buffer(NULL), entries(NULL), size(0), generation(0), adding(false),
+      initialized(false)
+  {}
+
+  bool init(size_t size_arg);
+  void destroy();
+  void clear()
+  {
+    mysql_rwlock_wrlock(&lock);
+    reset();
+    generation++;
+    mysql_rwlock_unlock(&lock);
+  }
+  ulong get_generation()
+  {
+    mysql_rwlock_rdlock(&lock);
+    ulong res= generation;
+    mysql_rwlock_unlock(&lock);
+    return res;
+  }
+  void add(ulong gen, const char *log_name, my_off_t pos, const uchar *data,
+           size_t length);
+  bool read(ulong gen, const char *log_name, my_off_t pos, String *packet,
+            size_t max_length, size_t *length);
+
+private:
+  struct Entry
+  {
+    my_off_t pos;                       /* Position of the event in file */
+    size_t offset;                      /* Position of the event in buffer */
+    size_t length;
+  };
+  /*
+    Expected average event size, for the number of index entries. It is
+    about the average of the events of small row-based transactions.
+  */
+  static const size_t AVG_EVENT_SIZE= 128;
+
+  void reset()
+  {
+    first= count= 0;
+    tail= 0;
+    end_pos= 0;
+    file_name[0]= 0;
+  }
+  Entry *entry(uint i) const { return entries + (first + i) % max_entries; }
+  bool find_space(size_t length, size_t *offset) const;
+  void drop_oldest()
+  {
+    first= (first + 1) % max_entries;
+    if (!--count)
+      first= 0, tail= 0;
+  }
+
+  mysql_rwlock_t lock;
+  uchar *buffer;
+  Entry *entries;
+  size_t size;
+  uint max_entries;
+  uint first, count;                    /* Used part of entries[] */
+  size_t tail;                          /* Where the next event goes */
+  my_off_t end_pos;                     /* End of the newest event */
+  ulong generation;
+  bool adding;                          /* An event is being copied in */
+  bool initialized;
+  char file_name[FN_REFLEN];
+};
+
+
+static ulong log_name_number(const char *log_name)
+{
+  const char *ext= fn_ext(log_name);
+  return *ext ? strtoul(ext + 1, NULL, 10) : 0;
+}
+
+static Binlog_tail_cache binlog_tail_cache;
+
+
+bool Binlog_tail_cache::init(size_t size_arg)
+{
+  mysql_rwlock_init(key_rwlock_binlog_tail_cache, &lock);
+  initialized= true;
+  reset();
+  if (!size_arg)
+    return false;
+  /* The index comes first in the allocated memory, the events after it */
+  max_entries= (uint) MY_MAX(size_arg / (AVG_EVENT_SIZE + sizeof(Entry)), 16);
+  if (!(entries= (Entry*) my_malloc(PSI_INSTRUMENT_ME, size_arg, MYF(MY_WME))))
+  {
+    destroy();
+    return true;
+  }
+  buffer= (uchar*) (entries + max_entries);
+  size= size_arg - max_entries * sizeof(Entry);
+  return false;
+}
+
+
+void Binlog_tail_cache::destroy()
+{
+  if (!initialized)
+    return;
+  initialized= false;
+  my_free(entries);
+  buffer= NULL;
+  entries= NULL;
+  size= 0;
+  mysql_rwlock_destroy(&lock);
+}
+
+
+/* Find room for an event of the given length without dropping events */
+
+bool Binlog_tail_cache::find_space(size_t length, size_t *offset) const
+{
+  if (!count)
+  {
+    *offset= 0;
+    return length <= size;
+  }
+  if (count == max_entries)
+    return false;
+  size_t head= entry(0)->offset;
+  if (tail > head)
+  {
+    /* Used part is [head, tail); try after it, then before it */
+    if (size - tail >= length)
+      *offset= tail;
+    else if (head >= length)
+      *offset= 0;
+    else
+      return false;
+    return true;
+  }
+  /* Used part wraps around the end of the buffer, free part is [tail, head) */
+  if (head - tail >= length)
+  {
+    *offset= tail;
+    return true;
+  }
+  return false;
+}
+
+
+void Binlog_tail_cache::add(ulong gen, const char *log_name, my_off_t pos,
+                            const uchar *data, size_t length)
+{
+  size_t offset;
+  bool skip;
+  if (length > size / 2)
+    return;
+
+  /*
+    Another dump thread may have added the event after we failed to find
+    it; check without blocking the readers.
+  */
+  mysql_rwlock_rdlock(&lock);
+  skip= gen != generation || adding ||
+        (count && pos < end_pos && !strcmp(log_name, file_name));
+  mysql_rwlock_unlock(&lock);
+  if (skip)
+    return;
+
+  mysql_rwlock_wrlock(&lock);
+  if (gen != generation || adding)
+    goto end;
+  if (strcmp(log_name, file_name))
+  {
+    /* Only follow the newest binlog file */
+    if (count && log_name_number(log_name) < log_name_number(file_name))
+      goto end;
+    reset();
+    strmake_buf(file_name, log_name);
+  }
+  else if (count && pos != end_pos)
+  {
+    /* Already cached, or some events between are missing */
+    if (pos < end_pos)
+      goto end;
+    reset();
+    strmake_buf(file_name, log_name);
+  }
+
+  while (!find_space(length, &offset))
+    drop_oldest();
+  /* No reader uses the reserved space, and other adders skip */
+  adding= true;
+  mysql_rwlock_unlock(&lock);
+
+  memcpy(buffer + offset, data, length);
+
+  mysql_rwlock_wrlock(&lock);
+  adding= false;
+  /* Unless the cache was cleared meanwhile */
+  if (gen == generation)
+  {
+    Entry *e= entries + (first + count) % max_entries;
+    e->pos= pos;
+    e->offset= offset;
+    e->length= length;
+    count++;
+    tail= offset + length;
+    end_pos= pos + length;
+  }
+
+end:
+  mysql_rwlock_unlock(&lock);
+}
+
+
+/*
+  Append the event at the given position to the packet if it is cached
+  and not longer than max_length.
+
+  @retval true   The event was appended, its length is in *length
+  @retval false  The event must be read from the file
+*/
+
+bool Binlog_tail_cache::read(ulong gen, const char *log_name, my_off_t pos,
+                             String *packet, size_t max_length,
+                             size_t *length)
+{
+  bool found= false;
+  if (!size)
+    return false;
+
+  mysql_rwlock_rdlock(&lock);
+  if (gen == generation && count && pos >= entry(0)->pos && pos < end_pos &&
+      !strcmp(log_name, file_name))
+  {
+    uint low= 0, high= count;
+    while (low < high)
+    {
+      uint mid= (low + high) / 2;
+      if (entry(mid)->pos < pos)
+        low= mid + 1;
+      else
+        high= mid;
+    }
+    Entry *e= entry(low);
+    if (low < count && e->pos == pos && e->length <= max_length &&
+        !packet->append((const char*) buffer + e->offset, e->length))
+    {
+      *length= e->length;
+      found= true;
+    }
+  }
+  mysql_rwlock_unlock(&lock);
+  return found;
+}
+
+
+bool binlog_tail_cache_init()
+{
+  return binlog_tail_cache.init((size_t) binlog_tail_cache_size);
+}
+
+
+void binlog_tail_cache_free()
+{
+  binlog_tail_cache.destroy();
+}
+
+
+/* Forget all cached events, for when binlog files are recreated */
+
+void binlog_tail_cache_clear()
+{
+  if (binlog_tail_cache_size)
+    binlog_tail_cache.clear();
+}
+
+
+/*
+  Read the next event from the binlog, from binlog_tail_cache if possible.
+
+  Returns the same as Log_event::read_log_event().
+*/
+
+static int read_binlog_event(binlog_send_info *info, IO_CACHE *log,
+                             LOG_INFO *linfo, String *packet)
+{
+  size_t ev_offset= packet->length();
+  size_t length;
+  THD *thd= info->thd;
+  my_off_t pos= my_b_tell(log);
+  size_t max_length= MY_MAX(thd->variables.max_allowed_packet,
+                            opt_binlog_rows_event_max_size +
+                            MAX_LOG_EVENT_HEADER);
+
+  if (binlog_tail_cache.read(info->tail_cache_generation,
+                             linfo->log_file_name, pos, packet, max_length,
+                             &length))
+  {
+    my_b_seek(log, pos + length);
+    return 0;
+  }
+
+  int error= Log_event::read_log_event(log, packet, info->fdev,
+                       opt_master_verify_checksum ? info->current_checksum_alg
+                                                  : BINLOG_CHECKSUM_ALG_OFF);
+  if (likely(!error) && binlog_tail_cache_size)
+    binlog_tail_cache.add(info->tail_cache_generation,
+                          linfo->log_file_name, pos,
+                          (const uchar*) packet->ptr() + ev_offset,
+                          packet->length() - ev_offset);
+  return error;
+}
+
+
+/*
+  Check that there is a Gtid_log_event at the given offset of the binlog
+  file, as a safety net against an index that is ahead of the binlog file
+  after a crash.
+*/
+
+static bool gtid_index_check_event(binlog_send_info *info, IO_CACHE *log,
+                                   my_off_t offset)
+{
+  String buf;
+  my_b_seek(log, offset);
+  if (Log_event::read_log_event(log, &buf, info->fdev,
+                                opt_master_verify_checksum
+                                ? info->current_checksum_alg
+                                : BINLOG_CHECKSUM_ALG_OFF))
+    return false;
+  return (Log_event_type)(uchar) buf[LOG_EVENT_OFFSET] == GTID_EVENT;
+}
+
+
+/*
+  Find where to start sending a binlog file from, using its GTID index to
+  skip the event groups before the slave GTID position.
+
+  If the file has no GTID index and is read from its start, start
+  rebuilding the index. The index of the binlog file being written is
+  created by the writer.
+
+  Returns the position to start reading the binlog file from.
+*/
+
+static my_off_t gtid_index_start_pos(binlog_send_info *info, IO_CACHE *log,
+                                     LOG_INFO *linfo, my_off_t pos)
+{
+  char end_pos_file[FN_REFLEN];
+  my_off_t max_offset, start;
+  bool active;
+
+  if (pos != BIN_LOG_HEADER_SIZE)
+    return pos;
+
+  mysql_bin_log.lock_binlog_end_pos();
+  max_offset= mysql_bin_log.get_binlog_end_pos(end_pos_file);
+  mysql_bin_log.unlock_binlog_end_pos();
+  if (!(active= !strcmp(end_pos_file, linfo->log_file_name)))
+    max_offset= my_b_filelength(log);
+
+  if (!gtid_index_exists(linfo->log_file_name))
+  {
+    if (!active)
+      info->gtid_index_builder.open(linfo->log_file_name,
+                                    opt_binlog_gtid_index_span, true);
+    return pos;
+  }
+
+  /* START SLAVE UNTIL needs to see all the GTIDs */
+  if (!info->using_gtid_state || info->until_gtid_state ||
+      !info->gtid_state.count())
+    return pos;
+
+  if (!(start= gtid_index_find_start(linfo->log_file_name, &info->gtid_state,
+                                     max_offset)))
+    return pos;
+  /* The events at the end of the active file may not be written yet */
+  my_off_t cur_pos= my_b_tell(log);
+  if (start < max_offset ? !gtid_index_check_event(info, log, start)
+                         : !active)
+  {
+    /* Continue after the format description event, as without index */
+    my_b_seek(log, cur_pos);
+    return pos;
+  }
+  return start;
+}
+
+
 /**
  * This function sends events from one binlog file
  * but only up until end_pos
@@ -2693,9 +3108,7 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
       return 1;
 
     info->last_pos= linfo->pos;
-    error= Log_event::read_log_event(log, packet, info->fdev,
-                       opt_master_verify_checksum ? info->current_checksum_alg
-                                                  : BINLOG_CHECKSUM_ALG_OFF);
+    error= read_binlog_event(info, log, linfo, packet);
     linfo->pos= my_b_tell(log);
 
     if (unlikely(error))
@@ -2707,6 +3120,20 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
     Log_event_type event_type=
         (Log_event_type)((uchar)(*packet)[LOG_EVENT_OFFSET+ev_offset]);
 
+    if (event_type == GTID_EVENT && info->gtid_index_builder.is_open())
+    {
+      rpl_gtid gtid;
+      uchar flags2;
+      if (Gtid_log_event::peek((uchar*) packet->ptr() + ev_offset,
+                               packet->length() - ev_offset,
+                               info->current_checksum_alg,
+                               &gtid.domain_id, &gtid.server_id,
+                               &gtid.seq_no, &flags2, info->fdev))
+        info->gtid_index_builder.discard();
+      else
+        info->gtid_index_builder.process_gtid(info->last_pos, &gtid);
+    }
+
 #ifndef DBUG_OFF
     if (info->dbug_reconnect_counter > 0)
     {
@@ -2933,6 +3360,7 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
       goto err;
     }
 
+    info->tail_cache_generation= binlog_tail_cache.get_generation();
     if ((file=open_binlog(&log, linfo.log_file_name, &info->errmsg)) < 0)
     {
       info->error= ER_MASTER_FATAL_ERROR_READING_BINLOG;
@@ -2966,12 +3394,17 @@ void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
     if (info->until_gtid_state && info->until_gtid_state->count() == 0)
       info->gtid_until_group= GTID_UNTIL_STOP_AFTER_STANDALONE;
 
+    if (opt_binlog_gtid_index)
+      pos= gtid_index_start_pos(info, &log, &linfo, pos);
+
     THD_STAGE_INFO(thd, stage_sending_binlog_event_to_slave);
     if (send_one_binlog_file(info, &log, &linfo, pos))
       break;
 
     if (should_stop(info))
       break;
+    /* The whole file was read, so a rebuilt GTID index is complete */
+    info->gtid_index_builder.close();
 
     DBUG_EXECUTE_IF("wait_after_binlog_EOF",
                     {
@@ -4132,6 +4565,10 @@ bool mysql_show_binlog_events(THD* thd)
     thd->variables.max_allowed_packet += MAX_LOG_EVENT_HEADER;
 
     mysql_mutex_lock(log_lock);
+    /* Do not read ranges of the binlog a group commit has not written yet */
+    binary_log->lock_binlog_end_pos();
+    binary_log->wait_for_cache_fill();
+    binary_log->unlock_binlog_end_pos();
 
     /*
       open_binlog() sought to position 4.
@@ -273,6 +273,7 @@ static bool change_refs_to_tmp_fields(THD *thd, Ref_ptr_array ref_pointer_array,
 				      uint elements, List<Item> &items);
 static void init_tmptable_sum_functions(Item_sum **func);
 static void update_tmptable_sum_func(Item_sum **func,TABLE *tmp_table);
+static bool copy_blobs(Field **ptr);
 static void copy_sum_funcs(Item_sum **func_ptr, Item_sum **end);
 static bool add_ref_to_table_cond(THD *thd, JOIN_TAB *join_tab);
 static bool setup_sum_funcs(THD *thd, Item_sum **func_ptr);
@@ -19081,13 +19082,18 @@ bool Create_tmp_table::choose_engine(THD *thd, TABLE *table,
                                      TMP_TABLE_PARAM *param)
 {
   TABLE_SHARE *share= table->s;
+  bool blob_in_key= m_blobs_count[distinct] != 0;
   DBUG_ENTER("Create_tmp_table::choose_engine");
   /*
     If result table is small; use a heap, otherwise TMP_TABLE_HTON (Aria)
     In the future we should try making storage engine selection more dynamic
+
+    Heap tables can store blobs but can't have them in keys.
   */
+  for (ORDER *tmp= m_group; tmp && !blob_in_key; tmp= tmp->next)
+    blob_in_key= (*tmp->item)->get_tmp_table_field()->flags & BLOB_FLAG;
 
-  if (share->blob_fields || m_using_unique_constraint ||
+  if (blob_in_key || m_using_unique_constraint ||
       (thd->variables.big_tables &&
        !(m_select_options & SELECT_SMALL_RESULT)) ||
       (m_select_options & TMP_TABLE_FORCE_MYISAM) ||
@@ -22619,6 +22625,35 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
+/**
+  Convert the heap table of end_update() after a write to it failed
+
+  The row in record[0] is written to the new table, which is then updated
+  with end_unique_update().
+
+  @return FALSE ok, TRUE error
+*/
+
+static bool
+convert_group_tmp_table_from_heap(JOIN_TAB *join_tab, int error)
+{
+  TABLE *const table= join_tab->table;
+  if (create_internal_tmp_table_from_heap(join_tab->join->thd, table,
+                                       join_tab->tmp_table_param->start_recinfo,
+                                          &join_tab->tmp_table_param->recinfo,
+                                          error, 0, NULL))
+    return true;                                // Not a table_is_full error
+  /* Change method to update rows */
+  if (unlikely((error= table->file->ha_index_init(0, 0))))
+  {
+    table->file->print_error(error, MYF(0));
+    return true;
+  }
+  join_tab->aggr->set_write_func(end_unique_update);
+  return false;
+}
+
+
 /*
   @brief
     Perform a GROUP BY operation over rows coming in arbitrary order. 
@@ -22669,12 +22704,29 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
   {						/* Update old record */
     restore_record(table,record[1]);
     update_tmptable_sum_func(join->sum_funcs,table);
-    if (unlikely((error= table->file->ha_update_tmp_row(table->record[1],
-                                                        table->record[0]))))
+    if (likely(!(error= table->file->ha_update_tmp_row(table->record[1],
+                                                       table->record[0]))))
+      goto end;
+    /*
+      New blob values may not fit in a heap table. Convert the table,
+      replacing the row with its new version. The blobs of record[0] may
+      point to the data of the row, so copy them first.
+    */
+    if (error != HA_ERR_RECORD_FILE_FULL ||
+        table->s->db_type() != heap_hton)
     {
       table->file->print_error(error,MYF(0));	/* purecov: inspected */
       DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
     }
+    if (copy_blobs(table->field))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (unlikely((error= table->file->ha_delete_tmp_row(table->record[1]))))
+    {
+      table->file->print_error(error, MYF(0));
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
+    if (convert_group_tmp_table_from_heap(join_tab, HA_ERR_RECORD_FILE_FULL))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
     goto end;
   }
 
@@ -22682,22 +22734,9 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
   if (unlikely(copy_funcs(join_tab->tmp_table_param->items_to_copy,
                           join->thd)))
     DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
-  if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))))
-  {
-    if (create_internal_tmp_table_from_heap(join->thd, table,
-                                       join_tab->tmp_table_param->start_recinfo,
-                                            &join_tab->tmp_table_param->recinfo,
-                                            error, 0, NULL))
-      DBUG_RETURN(NESTED_LOOP_ERROR);            // Not a table_is_full error
-    /* Change method to update rows */
-    if (unlikely((error= table->file->ha_index_init(0, 0))))
-    {
-      table->file->print_error(error, MYF(0));
-      DBUG_RETURN(NESTED_LOOP_ERROR);
-    }
-
-    join_tab->aggr->set_write_func(end_unique_update);
-  }
+  if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))) &&
+      convert_group_tmp_table_from_heap(join_tab, error))
+    DBUG_RETURN(NESTED_LOOP_ERROR);
   join_tab->send_records++;
 end:
   join->accepted_rows++;                        // For rownum()
@@ -24561,8 +24600,8 @@ JOIN_TAB::remove_duplicates()
     thd->reset_killed();
 
   table->file->info(HA_STATUS_VARIABLE);
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error=remove_dup_with_hash_index(join->thd, table, field_count, first_field,
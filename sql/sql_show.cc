@@ -3880,41 +3880,31 @@ static bool show_status_array(THD *thd, const char *wild,
 }
 
 /*
-  collect status for all running threads
-  Return number of threads used
+  Add the status of all threads to a copy of global_status_var.
+  The threads are not looked at, their status is kept in status_shards.
+  Return number of threads
 */
 
-struct calc_sum_callback_arg
-{
-  calc_sum_callback_arg(STATUS_VAR *to_arg): to(to_arg), count(0) {}
-  STATUS_VAR *to;
-  uint count;
-};
-
-
-static my_bool calc_sum_callback(THD *thd, calc_sum_callback_arg *arg)
+uint calc_sum_of_all_status(STATUS_VAR *to)
 {
-  arg->count++;
-  if (!thd->status_in_global)
-  {
-    add_to_status(arg->to, &thd->status_var);
-    arg->to->local_memory_used+= thd->status_var.local_memory_used;
-  }
-  if (thd->get_command() != COM_SLEEP)
-    arg->to->threads_running++;
-  return 0;
+  DBUG_ENTER("calc_sum_of_all_status");
+  to->local_memory_used= 0;
+  DBUG_RETURN(status_shards.add_to(to));
 }
 
 
-uint calc_sum_of_all_status(STATUS_VAR *to)
-{
-  calc_sum_callback_arg arg(to);
-  DBUG_ENTER("calc_sum_of_all_status");
+/*
+  Get the global status counters, as shown by SHOW GLOBAL STATUS.
+  Cheap enough to be called often, for example by monitoring code.
+  Return number of threads
+*/
 
-  to->local_memory_used= 0;
-  /* Add to this status from existing threads */
-  server_threads.iterate(calc_sum_callback, &arg);
-  DBUG_RETURN(arg.count);
+uint global_status_snapshot(STATUS_VAR *to)
+{
+  mysql_mutex_lock(&LOCK_status);
+  *to= global_status_var;
+  mysql_mutex_unlock(&LOCK_status);
+  return calc_sum_of_all_status(to);
 }
 
 
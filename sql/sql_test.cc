@@ -571,8 +571,7 @@ void mysql_print_status()
   STATUS_VAR tmp;
   uint count;
 
-  tmp= global_status_var;
-  count= calc_sum_of_all_status(&tmp);
+  count= global_status_snapshot(&tmp);
   printf("\nStatus information:\n\n");
   (void) my_getwd(current_dir, sizeof(current_dir),MYF(0));
   printf("Current dir: %s\n", current_dir);
@@ -501,6 +501,15 @@ static Sys_var_ulong Sys_back_log(
        AUTO_SET READ_ONLY GLOBAL_VAR(back_log), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 65535), DEFAULT(150), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_acceptor_threads(
+       "acceptor_threads",
+       "Number of threads accepting new TCP/IP connections on the main port. "
+       "If greater than 1, every acceptor thread listens on its own "
+       "SO_REUSEPORT socket and the kernel spreads incoming connections "
+       "between them",
+       READ_ONLY GLOBAL_VAR(opt_acceptor_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 256), DEFAULT(1), BLOCK_SIZE(1));
+
 static Sys_var_charptr_fscs Sys_basedir(
        "basedir", "Path to installation directory. All paths are "
        "usually resolved relative to this",
@@ -545,6 +554,55 @@ Sys_binlog_file_cache_size(
        CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(IO_SIZE*2, SIZE_T_MAX), DEFAULT(IO_SIZE*4), BLOCK_SIZE(IO_SIZE));
 
+static Sys_var_ulonglong Sys_binlog_tail_cache_size(
+       "binlog_tail_cache_size",
+       "Size of the in-memory cache of the most recently read binlog "
+       "events, shared by all binlog dump threads. Dump threads that are "
+       "close to the end of the binlog send events from this cache instead "
+       "of reading the binlog file. 0 disables the cache",
+       READ_ONLY GLOBAL_VAR(binlog_tail_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, SIZE_T_MAX), DEFAULT(0), BLOCK_SIZE(IO_SIZE));
+
+static Sys_var_mybool Sys_binlog_gtid_index(
+       "binlog_gtid_index",
+       "Write a sparse index from GTID position to file offset next to "
+       "each binlog file, so binlog dump threads of slaves connecting with "
+       "a GTID position can skip directly to it. Missing indexes of old "
+       "binlog files are rebuilt when a dump thread reads the whole file",
+       READ_ONLY GLOBAL_VAR(opt_binlog_gtid_index),
+       CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+
+static Sys_var_ulong Sys_binlog_gtid_index_span(
+       "binlog_gtid_index_span",
+       "Minimum number of bytes of binlog between two entries of the "
+       "binlog GTID index",
+       READ_ONLY GLOBAL_VAR(opt_binlog_gtid_index_span),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(IO_SIZE, UINT_MAX32),
+       DEFAULT(65536), BLOCK_SIZE(1));
+
+static Sys_var_mybool Sys_binlog_single_sync_commit(
+       "binlog_single_sync_commit",
+       "Do not sync the redo log of the storage engine when a transaction "
+       "is prepared. The binlog group commit syncs the redo log and the "
+       "binlog in parallel instead, and crash recovery removes from the "
+       "binlog the transactions whose prepare did not reach the redo log. "
+       "Needs exactly one transactional storage engine that supports it, "
+       "like InnoDB",
+       READ_ONLY GLOBAL_VAR(opt_binlog_single_sync_commit),
+       CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+
+static Sys_var_on_access_global<Sys_var_ulonglong,
+                    PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_LARGE_COMMIT_THRESHOLD>
+Sys_binlog_large_commit_threshold(
+       "binlog_large_commit_threshold",
+       "Transactions with at least this many bytes of events are written "
+       "to the binary log after the group commit released the binlog lock, "
+       "into a range of the binlog reserved for them, so that other "
+       "transactions can be written to the binlog at the same time. "
+       "0 disables this",
+       GLOBAL_VAR(opt_binlog_large_commit_threshold), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONGLONG_MAX), DEFAULT(0), BLOCK_SIZE(65536));
+
 static Sys_var_on_access_global<Sys_var_ulonglong,
                              PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_STMT_CACHE_SIZE>
 Sys_binlog_stmt_cache_size(
@@ -1473,6 +1531,40 @@ Sys_log_bin_compress_min_len(
   GLOBAL_VAR(opt_bin_log_compress_min_len),
   CMD_LINE(OPT_ARG), VALID_RANGE(10, 1024), DEFAULT(256), BLOCK_SIZE(1));
 
+static bool check_binlog_transaction_compression(sys_var *self, THD *thd,
+                                                 set_var *var)
+{
+#ifndef HAVE_ZSTD
+  if (var->save_result.ulonglong_value)
+  {
+    my_error(ER_FEATURE_DISABLED, MYF(0), "binlog_transaction_compression",
+             "zstd");
+    return true;
+  }
+#endif
+  return false;
+}
+
+static Sys_var_on_access<Sys_var_mybool,
+                         PRIV_SET_SYSTEM_VAR_BINLOG_TRANSACTION_COMPRESSION,
+                         PRIV_SET_SYSTEM_VAR_BINLOG_TRANSACTION_COMPRESSION>
+Sys_binlog_transaction_compression(
+  "binlog_transaction_compression",
+  "Compress each transaction into a single zstd compressed event in the "
+  "binary log. The slave SQL thread expands it, and the relay log and the "
+  "network transfer keep it compressed",
+  SESSION_VAR(binlog_transaction_compression), CMD_LINE(OPT_ARG),
+  DEFAULT(FALSE), NO_MUTEX_GUARD, NOT_IN_BINLOG,
+  ON_CHECK(check_binlog_transaction_compression));
+
+static Sys_var_on_access_global<Sys_var_uint,
+                PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_COMPRESSION_LEVEL>
+Sys_binlog_transaction_compression_level(
+  "binlog_transaction_compression_level",
+  "The zstd compression level used by binlog_transaction_compression",
+  GLOBAL_VAR(opt_binlog_transaction_compression_level),
+  CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 22), DEFAULT(3), BLOCK_SIZE(1));
+
 static Sys_var_on_access_global<Sys_var_mybool,
                     PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_TRUST_FUNCTION_CREATORS>
 Sys_trust_function_creators(
@@ -2476,6 +2568,24 @@ Sys_binlog_commit_wait_usec(
        GLOBAL_VAR(opt_binlog_commit_wait_usec), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
+static const char *binlog_dependency_tracking_names[]=
+  {"COMMIT_ORDER", "WRITESET", NullS};
+static Sys_var_on_access_global<Sys_var_enum,
+          PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_TRANSACTION_DEPENDENCY_TRACKING>
+Sys_binlog_transaction_dependency_tracking(
+       "binlog_transaction_dependency_tracking",
+       "How the commit_id used by parallel replication to find transactions "
+       "that can be applied in parallel is assigned. COMMIT_ORDER: "
+       "transactions that were group committed together get the same "
+       "commit_id. WRITESET: in addition, consecutive transactions that "
+       "change rows with different primary and unique key values get the "
+       "same commit_id; transactions that are not in row format, or use "
+       "tables without a unique key or with foreign keys, are handled as "
+       "with COMMIT_ORDER",
+       GLOBAL_VAR(opt_binlog_dependency_tracking), CMD_LINE(REQUIRED_ARG),
+       binlog_dependency_tracking_names,
+       DEFAULT(BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER));
+
 
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
@@ -3001,9 +3111,14 @@ static Sys_var_ulong Sys_range_alloc_block_size(
 static bool fix_thd_mem_root(sys_var *self, THD *thd, enum_var_type type)
 {
   if (type != OPT_GLOBAL)
+  {
     reset_root_defaults(thd->mem_root,
                         thd->variables.query_alloc_block_size,
                         thd->variables.query_prealloc_size);
+    set_root_keep_limit(thd->mem_root, thd->variables.query_prealloc_size +
+                        QUERY_ALLOC_KEEP_BLOCKS *
+                        thd->variables.query_alloc_block_size);
+  }
   return false;
 }
 static Sys_var_ulong Sys_query_alloc_block_size(
@@ -3895,6 +4010,13 @@ static Sys_var_ulong Sys_table_def_size(
        VALID_RANGE(TABLE_DEF_CACHE_MIN, 2*1024*1024),
        DEFAULT(TABLE_DEF_CACHE_DEFAULT), BLOCK_SIZE(1));
 
+static Sys_var_mybool Sys_table_def_preload(
+       "table_definition_cache_preload",
+       "Read definitions of existing tables into the table definition "
+       "cache in the background at startup, until the cache is full",
+       READ_ONLY GLOBAL_VAR(tdc_preload), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 
 static bool fix_table_open_cache(sys_var *, THD *, enum_var_type)
 {
@@ -5312,6 +5434,19 @@ Sys_relay_log_recovery(
        "processed.",
        GLOBAL_VAR(relay_log_recovery), CMD_LINE(OPT_ARG), DEFAULT(FALSE));
 
+static Sys_var_ulong Sys_relay_log_buffer_size(
+       "relay_log_buffer_size",
+       "Size of the buffer in which the slave I/O thread keeps the events "
+       "it appends to the relay log, and from which the SQL thread reads "
+       "them. The buffer is written to the relay log file when it is full, "
+       "when the relay log is rotated or synced, when master.info is "
+       "updated, and when a heartbeat shows that the master is idle. As "
+       "buffered events are lost at a crash, this is only done while "
+       "relay_log_recovery is enabled. 0 writes every event to the relay "
+       "log file at once",
+       READ_ONLY GLOBAL_VAR(relay_log_buffer_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024*1024), DEFAULT(0), BLOCK_SIZE(IO_SIZE));
+
 
 bool Sys_var_rpl_filter::global_update(THD *thd, set_var *var)
 {
@@ -8078,6 +8078,10 @@ void TABLE::create_key_part_by_field(KEY_PART_INFO *key_part_info,
   However, they might be created for #2. In order to catch that case, we filter
   them out here.
 
+  HEAP temporary tables store blobs apart from the record and can't have
+  them in keys at all, so for them we also filter out the other columns
+  with BLOB_FLAG, i.e. GEOMETRY columns.
+
   @return TRUE if the key is valid
   @return FALSE otherwise
 */
@@ -8093,7 +8097,8 @@ bool TABLE::check_tmp_key(uint key, uint key_parts,
   {
     uint fld_idx= next_field_no(arg);
     reg_field= field + fld_idx;
-    if ((*reg_field)->type() == MYSQL_TYPE_BLOB)
+    if ((*reg_field)->type() == MYSQL_TYPE_BLOB ||
+        ((*reg_field)->flags & BLOB_FLAG && s->db_type() == heap_hton))
       return FALSE;
     uint fld_store_len= (uint16) (*reg_field)->key_length();
     if ((*reg_field)->real_maybe_null())
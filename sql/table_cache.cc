@@ -50,10 +50,12 @@
 #include "lf.h"
 #include "table.h"
 #include "sql_base.h"
+#include "sql_table.h"                          // filename_to_tablename
 
 
 /** Configuration. */
 ulong tdc_size; /**< Table definition cache threshold for LRU eviction. */
+my_bool tdc_preload; /**< Load table definitions at startup. */
 ulong tc_size; /**< Table cache threshold for LRU eviction. */
 uint32 tc_instances;
 static std::atomic<uint32_t> tc_active_instances(1);
@@ -96,6 +98,12 @@ static PSI_cond_info all_tc_conds[]=
 {
   { &key_TABLE_SHARE_COND_release, "TABLE_SHARE::tdc.COND_release", 0 }
 };
+
+static PSI_thread_key key_thread_tdc_preload;
+static PSI_thread_info all_tc_threads[]=
+{
+  { &key_thread_tdc_preload, "tdc_preload", PSI_FLAG_GLOBAL }
+};
 #endif
 
 
@@ -592,6 +600,7 @@ bool tdc_init(void)
 #ifdef HAVE_PSI_INTERFACE
   mysql_mutex_register("sql", all_tc_mutexes, array_elements(all_tc_mutexes));
   mysql_cond_register("sql", all_tc_conds, array_elements(all_tc_conds));
+  mysql_thread_register("sql", all_tc_threads, array_elements(all_tc_threads));
 #endif
   /* Extra instance is allocated to avoid false sharing */
   if (!(tc= new Table_cache_instance[tc_instances + 1]))
@@ -1203,6 +1212,159 @@ int show_tc_active_instances(THD *thd, SHOW_VAR *var, char *buff,
 }
 
 
+/**
+  Load definition of a table into the table definition cache.
+
+  Tables with a conflicting metadata lock (i.e. under DDL) are skipped,
+  as well as tables whose definition cannot be read.
+
+  @return true if a table definition was loaded
+*/
+
+static bool tdc_preload_share(THD *thd, const LEX_CSTRING *db,
+                              const LEX_CSTRING *table_name)
+{
+  TABLE_LIST tl;
+  bool res= false;
+
+  tl.init_one_table(db, table_name, 0, TL_READ);
+  MDL_REQUEST_INIT(&tl.mdl_request, MDL_key::TABLE, db->str, table_name->str,
+                   MDL_SHARED_HIGH_PRIO, MDL_EXPLICIT);
+  if (thd->mdl_context.try_acquire_lock(&tl.mdl_request) ||
+      !tl.mdl_request.ticket)
+  {
+    thd->clear_error();
+    return false;
+  }
+  if (TABLE_SHARE *share= tdc_acquire_share(thd, &tl, GTS_TABLE | GTS_VIEW))
+  {
+    tdc_release_share(share);
+    res= true;
+  }
+  thd->clear_error();
+  thd->mdl_context.release_lock(tl.mdl_request.ticket);
+  return res;
+}
+
+
+/**
+  Read definitions of existing tables into the table definition cache.
+
+  Runs in its own thread after startup, so that the first access to
+  a table after restart doesn't have to read and parse its .frm file.
+  Stops when the cache is full or the server is shutting down.
+*/
+
+pthread_handler_t tdc_preload_shares(void *arg)
+{
+  THD *thd= (THD*) arg;
+  MY_DIR *dbs;
+  ulong loaded= 0;
+  char path[FN_REFLEN + 1];
+  char db_buff[NAME_LEN + 1], table_buff[NAME_LEN + 1];
+  char file_buff[FN_REFLEN + 1];
+  my_thread_init();
+  DBUG_ENTER("tdc_preload_shares");
+
+  thd->thread_stack= (char*) &thd;
+  thd->store_globals();
+  mysql_thread_set_psi_id(thd->thread_id);
+
+  if (!(dbs= my_dir(mysql_data_home, MYF(MY_WANT_STAT))))
+    goto end;
+
+  for (size_t i= 0; i < dbs->number_of_files; i++)
+  {
+    FILEINFO *dir= dbs->dir_entry + i;
+    MY_DIR *tables;
+    LEX_CSTRING db;
+
+    if (!MY_S_ISDIR(dir->mystat->st_mode) ||
+        db_name_is_in_ignore_db_dirs_list(dir->name))
+      continue;
+    db.length= filename_to_tablename(dir->name, db_buff, sizeof(db_buff));
+    if (lower_case_table_names)
+      db.length= my_casedn_str(files_charset_info, db_buff);
+    db.str= db_buff;
+    build_table_filename(path, sizeof(path) - 1, db.str, "", "", 0);
+    if (!(tables= my_dir(path, MYF(0))))
+      continue;
+
+    for (size_t j= 0; j < tables->number_of_files; j++)
+    {
+      const char *name= tables->dir_entry[j].name;
+      const char *ext= fn_ext(name);
+      LEX_CSTRING table_name;
+
+      if (abort_loop || thd->killed || tdc_records() >= tdc_size)
+      {
+        my_dirend(tables);
+        goto end_dir;
+      }
+      if (strcmp(ext, reg_ext) ||
+          is_prefix(name, tmp_file_prefix))
+        continue;
+      strmake(file_buff, name, MY_MIN((size_t) (ext - name),
+                                      sizeof(file_buff) - 1));
+      table_name.length= filename_to_tablename(file_buff, table_buff,
+                                               sizeof(table_buff));
+      if (lower_case_table_names)
+        table_name.length= my_casedn_str(files_charset_info, table_buff);
+      table_name.str= table_buff;
+      if (tdc_preload_share(thd, &db, &table_name))
+        loaded++;
+    }
+    my_dirend(tables);
+  }
+
+end_dir:
+  my_dirend(dbs);
+  sql_print_information("Loaded %lu table definitions into the table "
+                        "definition cache", loaded);
+end:
+  server_threads.erase(thd);
+  delete thd;
+  DBUG_LEAVE; // Can't use DBUG_RETURN after my_thread_end
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Start loading table definitions in the background if
+  table_definition_cache_preload is set.
+*/
+
+void tdc_start_preload(void)
+{
+  THD *thd;
+  pthread_t th;
+  int err;
+  if (!tdc_preload)
+    return;
+
+  thd= new THD(next_thread_id());
+  thd->system_thread= SYSTEM_THREAD_GENERIC;
+  thd->security_ctx->skip_grants();
+  thd->set_command(COM_DAEMON);
+  thd->proc_info= "Loading table definitions";
+  /*
+    Registered before the server accepts connections, so that it is in
+    SHOW PROCESSLIST until all definitions are loaded, and it is killed
+    at shutdown.
+  */
+  server_threads.insert(thd);
+  if ((err= mysql_thread_create(key_thread_tdc_preload, &th,
+                                &connection_attrib, tdc_preload_shares, thd)))
+  {
+    sql_print_warning("Can't create thread to load table definitions "
+                      "(errno: %M)", err);
+    server_threads.erase(thd);
+    delete thd;
+  }
+}
+
+
 /**
   Waits until ref_count goes down to given number
 
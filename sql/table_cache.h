@@ -62,11 +62,13 @@ struct TDC_element
 
 
 extern ulong tdc_size;
+extern my_bool tdc_preload;
 extern ulong tc_size;
 extern uint32 tc_instances;
 
 extern bool tdc_init(void);
 extern void tdc_start_shutdown(void);
+extern void tdc_start_preload(void);
 extern void tdc_deinit(void);
 extern ulong tdc_records(void);
 extern void tdc_purge(bool all);
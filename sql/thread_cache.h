@@ -208,3 +208,66 @@ class Thread_cache
 };
 
 extern Thread_cache thread_cache;
+
+
+/**
+  Cache of THD objects of closed connections.
+
+  Connections that are not served by a parked thread (pool-of-threads
+  scheduler, newly created threads) take their THD from here instead of
+  constructing a new one. A cached THD is unlinked from the server and
+  from any OS thread, and has only its preallocated memory left; it is
+  reset for the new connection by CONNECT::create_thd(). At most
+  thread_cache_size objects are kept.
+*/
+class THD_cache
+{
+  mysql_mutex_t LOCK_thd_cache;
+  I_List<THD> list;
+  ulong cached_thd_count;
+  /** Set at shutdown, when no more objects are accepted. */
+  bool closed;
+  PSI_mutex_key key_LOCK_thd_cache;
+
+public:
+  void init()
+  {
+#ifdef HAVE_PSI_INTERFACE
+    PSI_mutex_info mutexes[]=
+    {
+      { &key_LOCK_thd_cache, "LOCK_thd_cache", PSI_FLAG_GLOBAL }
+    };
+    mysql_mutex_register("sql", mutexes, array_elements(mutexes));
+#endif
+    mysql_mutex_init(key_LOCK_thd_cache, &LOCK_thd_cache, MY_MUTEX_INIT_FAST);
+    list.empty();
+    cached_thd_count= 0;
+    closed= false;
+  }
+
+
+  void destroy()
+  {
+    DBUG_ASSERT(cached_thd_count == 0);
+    DBUG_ASSERT(list.is_empty());
+    mysql_mutex_destroy(&LOCK_thd_cache);
+  }
+
+
+  THD *get();
+  void put(THD *thd);
+  void flush();
+
+
+  /** Frees the cached objects and stops caching. Pre-shutdown hook. */
+  void final_flush()
+  {
+    mysql_mutex_lock(&LOCK_thd_cache);
+    closed= true;
+    mysql_mutex_unlock(&LOCK_thd_cache);
+    flush();
+  }
+
+};
+
+extern THD_cache thd_cache;
@@ -25,6 +25,7 @@
 #include <threadpool.h>
 #include <sql_class.h>
 #include <sql_parse.h>
+#include <thread_cache.h>
 
 #ifdef WITH_WSREP
 #include "wsrep_trans_observer.h"
@@ -267,9 +268,11 @@ static THD *threadpool_add_connection(CONNECT *connect, TP_connection *c)
   my_thread_init();
   st_my_thread_var* mysys_var= my_thread_var;
   PSI_CALL_set_thread(PSI_CALL_new_thread(key_thread_one_connection, connect, 0));
-  if (!mysys_var ||!(thd= connect->create_thd(NULL)))
+  THD *cached_thd= mysys_var ? thd_cache.get() : NULL;
+  if (!mysys_var ||!(thd= connect->create_thd(cached_thd)))
   {
     /* Out of memory? */
+    delete cached_thd;
     connect->close_and_delete();
     if (mysys_var)
       my_thread_end();
@@ -321,7 +324,7 @@ static void threadpool_remove_connection(THD *thd)
   close_connection(thd, 0);
   unlink_thd(thd);
   PSI_CALL_delete_current_thread(); // before THD is destroyed
-  delete thd;
+  thd_cache.put(thd);
 
   /*
     Free resources associated with this connection:
@@ -717,7 +717,7 @@ bool Unique::merge(TABLE *table, uchar *buff, size_t buff_size,
   /* Open cached file for table records if it isn't open */
   if (! my_b_inited(outfile) &&
       open_cached_file(outfile,mysql_tmpdir,TEMP_PREFIX,READ_RECORD_BUFFER,
-                       MYF(MY_WME)))
+                       MYF(MY_WME | MY_READ_AHEAD)))
     return 1;
 
   bzero((char*) &sort_param,sizeof(sort_param));
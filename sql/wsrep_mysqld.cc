@@ -3240,6 +3240,7 @@ void wsrep_close_client_connections(my_bool wait_to_end, THD* except_caller_thd)
 {
   /* Clear thread cache */
   thread_cache.final_flush();
+  thd_cache.flush();
 
   /*
     First signal all threads that it's time to die
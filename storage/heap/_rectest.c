@@ -21,9 +21,21 @@
 
 int hp_rectest(register HP_INFO *info, register const uchar *old)
 {
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end;
+  size_t start= 0;
   DBUG_ENTER("hp_rectest");
 
-  if (memcmp(info->current_ptr,old,(size_t) info->s->reclength))
+  /* The stored blob pointers point to chunks, not to the data read */
+  for (blob= share->blob_descs, end= blob + share->blobs; blob < end; blob++)
+  {
+    size_t length= blob->offset + blob->packlength - start;
+    if (memcmp(info->current_ptr + start, old + start, length))
+      DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED));
+    start+= length + sizeof(uchar*);
+  }
+  if (memcmp(info->current_ptr + start, old + start,
+             (size_t) share->reclength - start))
   {
     DBUG_RETURN((my_errno=HA_ERR_RECORD_CHANGED)); /* Record have changed */
   }
@@ -71,8 +71,8 @@ static handler *heap_create_handler(handlerton *hton,
 *****************************************************************************/
 
 ha_heap::ha_heap(handlerton *hton, TABLE_SHARE *table_arg)
-  :handler(hton, table_arg), file(0), records_changed(0), key_stat_version(0), 
-  internal_table(0)
+  :handler(hton, table_arg), file(0), records_changed(0), remember_pos(0),
+  key_stat_version(0), internal_table(0)
 {}
 
 /*
@@ -363,6 +363,17 @@ void ha_heap::position(const uchar *record)
   *(HEAP_PTR*) ref= heap_position(file);	// Ref is aligned
 }
 
+int ha_heap::remember_rnd_pos()
+{
+  remember_pos= file->current_record;
+  return 0;
+}
+
+int ha_heap::restart_rnd_next(uchar *buf)
+{
+  return heap_scan_restart(file, buf, remember_pos);
+}
+
 int ha_heap::info(uint flag)
 {
   HEAPINFO hp_info;
@@ -608,6 +619,7 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOB_DESC *blob_descs;
   bool found_real_auto_increment= 0;
 
   bzero(hp_create_info, sizeof(*hp_create_info));
@@ -619,8 +631,15 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                        MYF(MY_WME | MY_THREAD_SPECIFIC),
                        &keydef, keys * sizeof(HP_KEYDEF),
                        &seg, parts * sizeof(HA_KEYSEG),
+                       &blob_descs, share->blob_fields * sizeof(HP_BLOB_DESC),
                        NULL))
     return my_errno;
+  for (uint i= 0; i < share->blob_fields; i++)
+  {
+    Field_blob *blob= (Field_blob*) table_arg->field[share->blob_field[i]];
+    blob_descs[i].offset= (uint) blob->offset(table_arg->record[0]);
+    blob_descs[i].packlength= blob->pack_length_no_ptr();
+  }
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -649,6 +668,13 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
     {
       Field *field= key_part->field;
 
+      /* Blobs are stored apart from the record, they can't be in keys */
+      if (field->flags & BLOB_FLAG)
+      {
+        my_free(keydef);
+        return HA_ERR_UNSUPPORTED;
+      }
+
       if (pos->algorithm == HA_KEY_ALG_BTREE)
 	seg->type= field->key_type();
       else
@@ -713,6 +739,18 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
+  if (share->blob_fields)
+  {
+    /*
+      share->max_rows of internal temporary tables does not count the blob
+      data, so limit the size of the table instead
+    */
+    if (internal_table)
+      set_if_smaller(hp_create_info->max_table_size,
+                     current_thd->variables.tmp_memory_table_size);
+    hp_create_info->blob_descs= blob_descs;
+    hp_create_info->blobs= share->blob_fields;
+  }
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
@@ -819,7 +857,8 @@ int ha_heap::find_unique_row(uchar *record, uint unique_idx)
         We compare it only by record in the index, so better to read all
         records.
       */
-      memcpy(record, file->current_ptr, (size_t) share->reclength);
+      if (hp_extract_record(file, record, file->current_ptr))
+        DBUG_RETURN(-1);
 
       DBUG_RETURN(0); // found and position set
     }
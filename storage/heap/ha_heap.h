@@ -32,6 +32,8 @@ class ha_heap final : public handler
   key_map btree_keys;
   /* number of records changed since last statistics update */
   ulong   records_changed;
+  /* scan position for restart_rnd_next() */
+  ulong   remember_pos;
   uint    key_stat_version;
   my_bool internal_table;
 public:
@@ -45,6 +47,10 @@ class ha_heap final : public handler
   }
   /* Rows also use a fixed-size format */
   enum row_type get_row_type() const { return ROW_TYPE_FIXED; }
+  /*
+    HA_NO_BLOBS is only checked for user tables. Internal temporary tables
+    can have blobs, see hp_blob.c
+  */
   ulonglong table_flags() const
   {
     return (HA_FAST_KEY_READ | HA_NO_BLOBS | HA_NULL_IN_KEY |
@@ -94,6 +100,8 @@ class ha_heap final : public handler
   int rnd_next(uchar *buf);
   int rnd_pos(uchar * buf, uchar *pos);
   void position(const uchar *record);
+  int remember_rnd_pos();
+  int restart_rnd_next(uchar *buf);
   int can_continue_handler_scan();
   int info(uint);
   int extra(enum ha_extra_function operation);
@@ -33,6 +33,13 @@ C_MODE_START
 #define HP_MIN_RECORDS_IN_BLOCK 16
 #define HP_MAX_RECORDS_IN_BLOCK 8192
 
+/*
+  Blob data is stored in chains of chunks of HP_SHARE::blob_block.
+  A chunk starts with a pointer to the next chunk of the chain.
+*/
+#define HP_BLOB_CHUNK_LENGTH 256
+#define HP_BLOB_CHUNK_DATA   (HP_BLOB_CHUNK_LENGTH - sizeof(uchar*))
+
 	/* Some extern variables */
 
 extern LIST *heap_open_list,*heap_share_list;
@@ -66,6 +73,11 @@ extern uchar *hp_find_block(HP_BLOCK *info,ulong pos);
 extern int hp_get_new_block(HP_SHARE *info, HP_BLOCK *block,
                             size_t* alloc_length);
 extern void hp_free(HP_SHARE *info);
+extern uchar *hp_get_blob_chunk(HP_SHARE *info);
+extern void hp_free_blob_chain(uchar **list, uchar *chunk);
+extern int hp_write_blobs(HP_INFO *info, const uchar *record, uchar *pos);
+extern int hp_read_blobs(HP_INFO *info, uchar *record);
+extern void hp_free_blobs(HP_SHARE *info, const uchar *pos, my_bool delayed);
 extern uchar *hp_free_level(HP_BLOCK *block,uint level,HP_PTRS *pos,
 			   uchar *last_pos);
 extern int hp_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
@@ -134,3 +146,34 @@ static inline ulong hp_mask(ulong hashnr, ulong buffmax, ulong maxlength)
   if ((hashnr & (buffmax-1)) < maxlength) return (hashnr & (buffmax-1));
   return (hashnr & ((buffmax >> 1) -1));
 }
+
+
+/* Length of the blob data of a record */
+
+static inline ulong hp_blob_length(const HP_BLOB_DESC *blob,
+                                   const uchar *record)
+{
+  const uchar *pos= record + blob->offset;
+  switch (blob->packlength) {
+  case 1: return (ulong) *pos;
+  case 2: return (ulong) uint2korr(pos);
+  case 3: return (ulong) uint3korr(pos);
+  case 4: return (ulong) uint4korr(pos);
+  }
+  DBUG_ASSERT(0);
+  return 0;
+}
+
+
+/*
+  Copy a stored record to the caller
+
+  The blob pointers are set to the blob data, see hp_read_blobs()
+*/
+
+static inline int hp_extract_record(HP_INFO *info, uchar *record,
+                                    const uchar *pos)
+{
+  memcpy(record, pos, (size_t) info->s->reclength);
+  return info->s->blobs ? hp_read_blobs(info, record) : 0;
+}
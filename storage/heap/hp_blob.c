@@ -0,0 +1,191 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  Blob columns of heap tables
+
+  The record stores the blob length and, instead of the pointer to the
+  data, a pointer to the first chunk of a chain in HP_SHARE::blob_block.
+  A blob that fits in one chunk is read without copying, longer ones are
+  copied to HP_INFO::blob_buff. As with other engines, the data read is
+  valid until the next read with the same handle.
+*/
+
+#include "heapdef.h"
+
+static inline uchar **hp_blob_ptr(const HP_BLOB_DESC *blob, const uchar *pos)
+{
+  return (uchar**) (pos + blob->offset + blob->packlength);
+}
+
+
+/* Copy blob data to a new chain of chunks */
+
+static uchar *hp_write_blob_chain(HP_SHARE *share, const uchar *data,
+                                  ulong length)
+{
+  uchar *first= 0, **prev= &first, *chunk;
+  do
+  {
+    size_t chunk_length= MY_MIN(length, HP_BLOB_CHUNK_DATA);
+    if (!(chunk= hp_get_blob_chunk(share)))
+    {
+      *prev= 0;
+      hp_free_blob_chain(&share->blob_del_link, first);
+      return 0;
+    }
+    *prev= chunk;
+    prev= (uchar**) chunk;
+    memcpy(chunk + sizeof(uchar*), data, chunk_length);
+    data+= chunk_length;
+    length-= (ulong) chunk_length;
+  } while (length);
+  *prev= 0;
+  return first;
+}
+
+
+/*
+  Store the blobs of a record
+
+  SYNOPSIS
+    hp_write_blobs()
+      info              heap handle
+      record            record with the blob data
+      pos               stored record, a copy of record
+
+  RETURN
+    0  ok, the blob pointers in pos point to the chains
+    #  error, nothing is allocated
+*/
+
+int hp_write_blobs(HP_INFO *info, const uchar *record, uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end;
+  DBUG_ENTER("hp_write_blobs");
+
+  for (blob= share->blob_descs, end= blob + share->blobs; blob < end; blob++)
+  {
+    ulong length= hp_blob_length(blob, record);
+    uchar *chain= 0;
+    if (length)
+    {
+      const uchar *data;
+      memcpy(&data, hp_blob_ptr(blob, record), sizeof(data));
+      if (!(chain= hp_write_blob_chain(share, data, length)))
+      {
+        while (blob-- > share->blob_descs)
+          hp_free_blob_chain(&share->blob_del_link,
+                             *hp_blob_ptr(blob, pos));
+        DBUG_RETURN(my_errno);
+      }
+    }
+    memcpy(hp_blob_ptr(blob, pos), &chain, sizeof(chain));
+  }
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Point the blobs of a record copied from the table to their data
+
+  RETURN
+    0  ok
+    #  out of memory
+*/
+
+int hp_read_blobs(HP_INFO *info, uchar *record)
+{
+  HP_SHARE *share= info->s;
+  HP_BLOB_DESC *blob, *end= share->blob_descs + share->blobs;
+  size_t buff_length= 0;
+  uchar *buff;
+
+  for (blob= share->blob_descs; blob < end; blob++)
+  {
+    ulong length= hp_blob_length(blob, record);
+    if (length > HP_BLOB_CHUNK_DATA)
+      buff_length+= length;
+  }
+  if (buff_length > info->blob_buff_length)
+  {
+    if (!(buff= (uchar*) my_realloc(hp_key_memory_HP_INFO, info->blob_buff,
+                                    buff_length,
+                                    MYF(MY_ALLOW_ZERO_PTR | MY_WME |
+                                        (share->internal ?
+                                         MY_THREAD_SPECIFIC : 0)))))
+      return my_errno;
+    info->blob_buff= buff;
+    info->blob_buff_length= buff_length;
+  }
+
+  buff= info->blob_buff;
+  for (blob= share->blob_descs; blob < end; blob++)
+  {
+    ulong length= hp_blob_length(blob, record);
+    uchar **ptr= hp_blob_ptr(blob, record), *chunk, *data;
+    memcpy(&chunk, ptr, sizeof(chunk));
+    if (length <= HP_BLOB_CHUNK_DATA)
+      data= chunk ? chunk + sizeof(uchar*) : 0;
+    else
+    {
+      data= buff;
+      for (; length > HP_BLOB_CHUNK_DATA; length-= HP_BLOB_CHUNK_DATA)
+      {
+        memcpy(buff, chunk + sizeof(uchar*), HP_BLOB_CHUNK_DATA);
+        buff+= HP_BLOB_CHUNK_DATA;
+        chunk= *((uchar**) chunk);
+      }
+      memcpy(buff, chunk + sizeof(uchar*), length);
+      buff+= length;
+    }
+    memcpy(ptr, &data, sizeof(data));
+  }
+  return 0;
+}
+
+
+/*
+  Free the blob chains of a stored record
+
+  SYNOPSIS
+    hp_free_blobs()
+      share             heap share
+      pos               stored record
+      delayed           The record was deleted or updated. The caller may
+                        still use the blob data it read, for example to
+                        write it to a new record, so the chunks are reused
+                        only after the next delayed free.
+*/
+
+void hp_free_blobs(HP_SHARE *share, const uchar *pos, my_bool delayed)
+{
+  HP_BLOB_DESC *blob, *end;
+  uchar **list= &share->blob_del_link;
+
+  if (delayed)
+  {
+    hp_free_blob_chain(list, share->blob_pending);
+    share->blob_pending= 0;
+    list= &share->blob_pending;
+  }
+  for (blob= share->blob_descs, end= blob + share->blobs; blob < end; blob++)
+  {
+    uchar *chain;
+    memcpy(&chain, hp_blob_ptr(blob, pos), sizeof(chain));
+    hp_free_blob_chain(list, chain);
+  }
+}
@@ -153,3 +153,69 @@ uchar *hp_free_level(HP_BLOCK *block, uint level, HP_PTRS *pos, uchar *last_pos)
   }
   return next_ptr;			/* next memory position */
 }
+
+
+/*
+  Get a chunk for blob data
+
+  SYNOPSIS
+    hp_get_blob_chunk()
+      info              heap share
+
+  NOTES
+    Freed chunks are reused first, otherwise the next unused chunk of
+    info->blob_block is taken. The chunks count in data_length like the
+    records.
+
+  RETURN
+    pointer to the chunk
+    0  Table is full or out of memory, my_errno is set
+*/
+
+uchar *hp_get_blob_chunk(HP_SHARE *info)
+{
+  HP_BLOCK *block= &info->blob_block;
+  ulong block_pos;
+  size_t length;
+  uchar *pos;
+
+  if ((pos= info->blob_del_link))
+  {
+    info->blob_del_link= *((uchar**) pos);
+    return pos;
+  }
+  if (info->data_length + info->index_length >= info->max_table_size)
+  {
+    my_errno= HA_ERR_RECORD_FILE_FULL;
+    return 0;
+  }
+  if (!(block_pos= block->last_allocated % block->records_in_block))
+  {
+    if (hp_get_new_block(info, block, &length))
+      return 0;
+    info->data_length+= length;
+  }
+  block->last_allocated++;
+  return (uchar*) block->level_info[0].last_blocks +
+         block_pos * block->recbuffer;
+}
+
+
+/*
+  Put a chain of blob chunks to a list of chunks
+
+  The chunks are already linked by their first bytes, so only the last one
+  has to be linked to the old list.
+*/
+
+void hp_free_blob_chain(uchar **list, uchar *chunk)
+{
+  uchar *last;
+
+  if (!chunk)
+    return;
+  for (last= chunk; *((uchar**) last); last= *((uchar**) last))
+  {}
+  *((uchar**) last)= *list;
+  *list= chunk;
+}
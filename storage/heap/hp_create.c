@@ -162,7 +162,9 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!(share= (HP_SHARE*) my_malloc(hp_key_memory_HP_SHARE,
                                        sizeof(HP_SHARE)+
 				       keys*sizeof(HP_KEYDEF)+
-				       key_segs*sizeof(HA_KEYSEG),
+				       key_segs*sizeof(HA_KEYSEG)+
+                                       create_info->blobs *
+                                       sizeof(HP_BLOB_DESC),
 				       MYF(MY_ZEROFILL |
                                            (create_info->internal_table ?
                                             MY_THREAD_SPECIFIC : 0)))))
@@ -171,6 +173,14 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     share->key_stat_version= 1;
     keyseg= (HA_KEYSEG*) (share->keydef + keys);
     init_block(&share->block, visible_offset + 1, min_records, max_records);
+    if ((share->blobs= create_info->blobs))
+    {
+      share->blob_descs= (HP_BLOB_DESC*) (keyseg + key_segs);
+      memcpy(share->blob_descs, create_info->blob_descs,
+             sizeof(HP_BLOB_DESC) * create_info->blobs);
+      init_block(&share->blob_block, HP_BLOB_CHUNK_LENGTH, min_records,
+                 max_records);
+    }
 	/* Fix keys */
     memcpy(share->keydef, keydef, (size_t) (sizeof(keydef[0]) * keys));
     for (i= 0, keyinfo= share->keydef; i < keys; i++, keyinfo++)
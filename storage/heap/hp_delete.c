@@ -42,6 +42,8 @@ int heap_delete(HP_INFO *info, const uchar *record)
       goto err;
   }
 
+  if (share->blobs)
+    hp_free_blobs(share, pos, 1);
   info->update=HA_STATE_DELETED;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
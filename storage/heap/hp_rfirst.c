@@ -37,7 +37,6 @@ int heap_rfirst(HP_INFO *info, uchar *record, int inx)
       memcpy(&pos, pos + (*keyinfo->get_key_length)(keyinfo, pos), 
 	     sizeof(uchar*));
       info->current_ptr = pos;
-      memcpy(record, pos, (size_t)share->reclength);
       /*
         If we're performing index_first on a table that was taken from
         table cache, info->lastkey_len is initialized to previous query.
@@ -50,6 +49,8 @@ int heap_rfirst(HP_INFO *info, uchar *record, int inx)
       */
       info->lastkey_len= 0;
       info->update = HA_STATE_AKTIV;
+      if (hp_extract_record(info, record, pos))
+        DBUG_RETURN(my_errno);
     }
     else
     {
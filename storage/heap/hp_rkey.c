@@ -68,8 +68,9 @@ int heap_rkey(HP_INFO *info, uchar *record, int inx, const uchar *key,
     if ((keyinfo->flag & (HA_NOSAME | HA_NULL_PART_KEY)) != HA_NOSAME)
       memcpy(info->lastkey, key, (size_t) keyinfo->length);
   }
-  memcpy(record, pos, (size_t) share->reclength);
   info->update= HA_STATE_AKTIV;
+  if (hp_extract_record(info, record, pos))
+    DBUG_RETURN(my_errno);
   DBUG_RETURN(0);
 }
 
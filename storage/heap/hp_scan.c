@@ -71,7 +71,22 @@ int heap_scan(register HP_INFO *info, uchar *record)
     DBUG_RETURN(my_errno=HA_ERR_RECORD_DELETED);
   }
   info->update= HA_STATE_PREV_FOUND | HA_STATE_NEXT_FOUND | HA_STATE_AKTIV;
-  memcpy(record,info->current_ptr,(size_t) share->reclength);
+  if (hp_extract_record(info, record, info->current_ptr))
+    DBUG_RETURN(my_errno);
   info->current_hash_ptr=0;			/* Can't use read_next */
   DBUG_RETURN(0);
 } /* heap_scan */
+
+
+/*
+  Continue a scan from a record read earlier, which is read again.
+  pos is HP_INFO::current_record after that record was read.
+*/
+
+int heap_scan_restart(HP_INFO *info, uchar *record, ulong pos)
+{
+  DBUG_ENTER("heap_scan_restart");
+  info->current_record= pos - 1;
+  info->next_block= pos;                        /* Find the record block */
+  DBUG_RETURN(heap_scan(info, record));
+}
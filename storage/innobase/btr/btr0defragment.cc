@@ -90,7 +90,7 @@ bool btr_defragment_active;
 static void btr_defragment_chunk(void*);
 
 static tpool::timer* btr_defragment_timer;
-static tpool::task_group task_group(1);
+static tpool::task_group task_group(1, tpool::TASK_PRIORITY_LOW);
 static tpool::task btr_defragment_task(btr_defragment_chunk, 0, &task_group);
 static void btr_defragment_start();
 
@@ -1039,6 +1039,7 @@ inline bool buf_pool_t::chunk_t::create(size_t bytes)
   }
 
   reg();
+  os_aio_register_buffer(mem, mem_size());
 
   return true;
 }
@@ -1139,6 +1140,7 @@ bool buf_pool_t::create()
         for (auto i= chunk->size; i--; block++)
           block->page.lock.free();
 
+        os_aio_unregister_buffer(chunk->mem, chunk->mem_size());
         allocator.deallocate_large_dodump(chunk->mem, &chunk->mem_pfx);
       }
       ut_free(chunks);
@@ -1252,6 +1254,7 @@ void buf_pool_t::close()
     for (auto i= chunk->size; i--; block++)
       block->page.lock.free();
 
+    os_aio_unregister_buffer(chunk->mem, chunk->mem_size());
     allocator.deallocate_large_dodump(chunk->mem, &chunk->mem_pfx);
   }
 
@@ -1782,6 +1785,8 @@ inline void buf_pool_t::resize()
 				block->page.lock.free();
 			}
 
+			os_aio_unregister_buffer(chunk->mem,
+						 chunk->mem_size());
 			allocator.deallocate_large_dodump(
 				chunk->mem, &chunk->mem_pfx);
 			sum_freed += chunk->size;
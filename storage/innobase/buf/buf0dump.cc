@@ -811,7 +811,7 @@ static void buf_dump_load_func(void *)
 
 
 /* Execute task with max.concurrency */
-static tpool::task_group tpool_group(1);
+static tpool::task_group tpool_group(1, tpool::TASK_PRIORITY_LOW);
 static tpool::waitable_task buf_dump_load_task(buf_dump_load_func, &tpool_group);
 static bool load_dump_enabled;
 
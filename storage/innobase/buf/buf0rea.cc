@@ -415,16 +415,21 @@ buf_read_ahead_random(const page_id_t page_id, ulint zip_size, bool ibuf)
   /* Read all the suitable blocks within the area */
   const ulint ibuf_mode= ibuf ? BUF_READ_IBUF_PAGES_ONLY : BUF_READ_ANY_PAGE;
 
-  for (page_id_t i= low; i < high; ++i)
   {
-    if (ibuf_bitmap_page(i, zip_size))
-      continue;
-    if (space->is_stopping())
-      break;
-    dberr_t err;
-    space->reacquire();
-    if (buf_read_page_low(&err, space, false, ibuf_mode, i, zip_size, false))
-      count++;
+    /* Submit the reads of the area with one system call */
+    os_aio_batch batch;
+    for (page_id_t i= low; i < high; ++i)
+    {
+      if (ibuf_bitmap_page(i, zip_size))
+        continue;
+      if (space->is_stopping())
+        break;
+      dberr_t err;
+      space->reacquire();
+      if (buf_read_page_low(&err, space, false, ibuf_mode, i, zip_size,
+                            false))
+        count++;
+    }
   }
 
   if (count)
@@ -658,17 +663,20 @@ buf_read_ahead_linear(const page_id_t page_id, ulint zip_size, bool ibuf)
 
   /* If we got this far, read-ahead can be sensible: do it */
   count= 0;
-  for (ulint ibuf_mode= ibuf ? BUF_READ_IBUF_PAGES_ONLY : BUF_READ_ANY_PAGE;
-       new_low != new_high_1; ++new_low)
   {
-    if (ibuf_bitmap_page(new_low, zip_size))
-      continue;
-    if (space->is_stopping())
-      break;
-    dberr_t err;
-    space->reacquire();
-    count+= buf_read_page_low(&err, space, false, ibuf_mode, new_low, zip_size,
-                              false);
+    os_aio_batch batch;
+    for (ulint ibuf_mode= ibuf ? BUF_READ_IBUF_PAGES_ONLY : BUF_READ_ANY_PAGE;
+         new_low != new_high_1; ++new_low)
+    {
+      if (ibuf_bitmap_page(new_low, zip_size))
+        continue;
+      if (space->is_stopping())
+        break;
+      dberr_t err;
+      space->reacquire();
+      count+= buf_read_page_low(&err, space, false, ibuf_mode, new_low,
+                                zip_size, false);
+    }
   }
 
   if (count)
@@ -44,7 +44,7 @@ static void fts_optimize_callback(void *);
 static void timer_callback(void*);
 static tpool::timer* timer;
 
-static tpool::task_group task_group(1);
+static tpool::task_group task_group(1, tpool::TASK_PRIORITY_LOW);
 static tpool::task task(fts_optimize_callback,0, &task_group);
 
 /** FTS optimize thread, for MDL acquisition */
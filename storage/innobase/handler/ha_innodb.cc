@@ -990,6 +990,18 @@ static SHOW_VAR innodb_status_variables[]= {
   {"ibuf_merges", &ibuf.n_merges, SHOW_SIZE_T},
   {"ibuf_segment_size", &ibuf.seg_size, SHOW_SIZE_T},
   {"ibuf_size", &ibuf.size, SHOW_SIZE_T},
+#ifdef HAVE_URING
+  {"io_uring_completed", &export_vars.innodb_io_uring.completed,
+   SHOW_ULONGLONG},
+  {"io_uring_completion_time", &export_vars.innodb_io_uring.completion_time,
+   SHOW_ULONGLONG},
+  {"io_uring_submit_calls", &export_vars.innodb_io_uring.submit_calls,
+   SHOW_ULONGLONG},
+  {"io_uring_submit_time", &export_vars.innodb_io_uring.submit_time,
+   SHOW_ULONGLONG},
+  {"io_uring_submitted", &export_vars.innodb_io_uring.submitted,
+   SHOW_ULONGLONG},
+#endif
   {"log_waits", &log_sys.waits, SHOW_SIZE_T},
   {"log_write_requests", &log_sys.write_to_buf, SHOW_SIZE_T},
   {"log_writes", &log_sys.write_to_log, SHOW_SIZE_T},
@@ -1025,6 +1037,22 @@ static SHOW_VAR innodb_status_variables[]= {
   {"system_rows_read", &export_vars.innodb_system_rows_read, SHOW_SIZE_T},
   {"system_rows_updated", &export_vars.innodb_system_rows_updated,
    SHOW_SIZE_T},
+  {"thread_pool_high_priority_tasks",
+   &export_vars.innodb_tpool[tpool::TASK_PRIORITY_HIGH].tasks, SHOW_ULONGLONG},
+  {"thread_pool_high_priority_wait_time",
+   &export_vars.innodb_tpool[tpool::TASK_PRIORITY_HIGH].wait_time,
+   SHOW_ULONGLONG},
+  {"thread_pool_normal_priority_tasks",
+   &export_vars.innodb_tpool[tpool::TASK_PRIORITY_NORMAL].tasks,
+   SHOW_ULONGLONG},
+  {"thread_pool_normal_priority_wait_time",
+   &export_vars.innodb_tpool[tpool::TASK_PRIORITY_NORMAL].wait_time,
+   SHOW_ULONGLONG},
+  {"thread_pool_low_priority_tasks",
+   &export_vars.innodb_tpool[tpool::TASK_PRIORITY_LOW].tasks, SHOW_ULONGLONG},
+  {"thread_pool_low_priority_wait_time",
+   &export_vars.innodb_tpool[tpool::TASK_PRIORITY_LOW].wait_time,
+   SHOW_ULONGLONG},
   {"num_open_files", &fil_system.n_open, SHOW_SIZE_T},
   {"truncated_status_writes", &export_vars.innodb_truncated_status_writes,
    SHOW_SIZE_T},
@@ -1637,6 +1665,22 @@ static bool innobase_flush_logs(handlerton*)
   return false;
 }
 
+/** Report the binlog position of the last durably committed transaction,
+as recovered at startup.
+@param file_name  binlog file name, FN_REFLEN bytes
+@param pos        end offset of the transaction in the binlog file
+@return whether no binlog position was recorded */
+static bool innodb_recovered_binlog_pos(handlerton*, char *file_name,
+                                        ulonglong *pos)
+{
+  if (!*trx_sys.recovered_binlog_filename)
+    return true;
+  strmake(file_name, trx_sys.recovered_binlog_filename,
+          std::min<size_t>(FN_REFLEN, TRX_SYS_MYSQL_LOG_NAME_LEN) - 1);
+  *pos= trx_sys.recovered_binlog_offset;
+  return false;
+}
+
 /************************************************************************//**
 Implements the SHOW ENGINE INNODB STATUS command. Sends the output of the
 InnoDB Monitor to the client.
@@ -4016,6 +4060,14 @@ static int innodb_init_params()
 				  "https://jira.mariadb.org/browse/MDEV-26674",
 				  io_uring_may_be_unsafe);
 	}
+	if (srv_io_uring_iopoll
+	    && srv_file_flush_method != SRV_O_DIRECT
+	    && srv_file_flush_method != SRV_O_DIRECT_NO_FSYNC) {
+		sql_print_warning("InnoDB: innodb_io_uring_iopoll=ON requires "
+				  "innodb_flush_method=O_DIRECT or "
+				  "O_DIRECT_NO_FSYNC; ignored");
+		srv_io_uring_iopoll = FALSE;
+	}
 #endif
 
 #ifndef _WIN32
@@ -4068,6 +4120,7 @@ static int innodb_init(void* p)
 	innobase_hton->commit_by_xid = innobase_commit_by_xid;
 	innobase_hton->rollback_by_xid = innobase_rollback_by_xid;
 	innobase_hton->commit_checkpoint_request = innodb_log_flush_request;
+	innobase_hton->recovered_binlog_pos = innodb_recovered_binlog_pos;
 	innobase_hton->create = innobase_create_handler;
 
 	innobase_hton->drop_database = innodb_drop_database;
@@ -19398,6 +19451,21 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, innodb_use_native_aio_default());
 
+#ifdef HAVE_URING
+static MYSQL_SYSVAR_BOOL(io_uring_sqpoll, srv_io_uring_sqpoll,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Let a kernel thread poll the io_uring submission queue, saving the"
+  " system calls for submitting reads and writes (needs a spare CPU core)",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(io_uring_iopoll, srv_io_uring_iopoll,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Poll for io_uring completions instead of waiting for interrupts"
+  " (requires innodb_flush_method=O_DIRECT and a block device that"
+  " supports polling)",
+  NULL, NULL, FALSE);
+#endif
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -19794,6 +19862,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+#ifdef HAVE_URING
+  MYSQL_SYSVAR(io_uring_sqpoll),
+  MYSQL_SYSVAR(io_uring_iopoll),
+#endif
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -1099,6 +1099,28 @@ int os_aio_init();
 Frees the asynchronous io system. */
 void os_aio_free();
 
+/** Register a memory area of the buffer pool, so that the native AIO
+can access it without mapping the pages for every request.
+@param ptr	start of the memory area
+@param size	size of the memory area in bytes */
+void os_aio_register_buffer(void *ptr, size_t size);
+
+/** Unregister a memory area before it is freed.
+@param ptr	start of the memory area
+@param size	size of the memory area in bytes */
+void os_aio_unregister_buffer(void *ptr, size_t size);
+
+/** Queue the os_aio() requests of the current thread while in scope,
+and submit them in a single system call at the end. This is only
+implemented for io_uring. */
+struct os_aio_batch
+{
+  os_aio_batch();
+  ~os_aio_batch();
+  os_aio_batch(const os_aio_batch&) = delete;
+  os_aio_batch &operator=(const os_aio_batch&) = delete;
+};
+
 /** Request a read or write.
 @param type		I/O request
 @param buf		buffer
@@ -224,6 +224,12 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
+#ifdef HAVE_URING
+/** innodb_io_uring_sqpoll: whether a kernel thread polls the io_uring */
+extern my_bool	srv_io_uring_sqpoll;
+/** innodb_io_uring_iopoll: whether the io_uring completions are polled */
+extern my_bool	srv_io_uring_iopoll;
+#endif
 extern my_bool	srv_numa_interleave;
 
 /* Use atomic writes i.e disable doublewrite buffer */
@@ -694,6 +700,12 @@ struct export_var_t{
 	ulint innodb_data_reads;		/*!< I/O read requests */
 	ulint innodb_dblwr_pages_written;	/*!< srv_dblwr_pages_written */
 	ulint innodb_dblwr_writes;		/*!< srv_dblwr_writes */
+	/** srv_thread_pool queueing, see tpool::task_priority */
+	tpool::task_queue_stats innodb_tpool[tpool::N_TASK_PRIORITIES];
+#ifdef HAVE_URING
+	/** io_uring counters, see tpool::aio_stats */
+	tpool::aio_stats innodb_io_uring;
+#endif
 	ulint innodb_deadlocks;
 	ulint innodb_history_list_length;
 	lsn_t innodb_lsn_current;
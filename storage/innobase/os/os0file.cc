@@ -86,13 +86,19 @@ class io_slots
 public:
 	io_slots(int max_submitted_io, int max_callback_concurrency) :
 		m_cache(max_submitted_io),
-		m_group(max_callback_concurrency),
+		m_group(max_callback_concurrency, tpool::TASK_PRIORITY_HIGH),
 		m_max_aio(max_submitted_io)
 	{
 	}
 	/* Get cached AIO control block */
 	tpool::aiocb* acquire()
 	{
+		if (tpool::aiocb* cb = m_cache.get(false)) {
+			return cb;
+		}
+		/* The slots may be held by requests that the current
+		thread has queued in an os_aio_batch. */
+		srv_thread_pool->submit_batch();
 		return m_cache.get();
 	}
 	/* Release AIO control block back to cache */
@@ -1358,6 +1364,13 @@ os_file_create_func(
 # endif
 #endif
 
+#ifdef HAVE_URING
+	/* Let io_uring find out once whether the file uses O_DIRECT */
+	if (purpose == OS_FILE_AIO && srv_thread_pool) {
+		srv_thread_pool->bind(file);
+	}
+#endif
+
 #ifdef USE_FILE_LOCK
 	if (!read_only
 	    && create_mode != OS_FILE_OPEN_RAW && os_file_lock(file, name)) {
@@ -1380,6 +1393,11 @@ os_file_create_func(
 		}
 
 		*success = false;
+#ifdef HAVE_URING
+		if (purpose == OS_FILE_AIO && srv_thread_pool) {
+			srv_thread_pool->unbind(file);
+		}
+#endif
 		close(file);
 		file = -1;
 	}
@@ -1575,6 +1593,11 @@ os_file_get_last_error.
 @return true if success */
 bool os_file_close_func(os_file_t file)
 {
+#ifdef HAVE_URING
+  /* Before close(), because the descriptor can be reused right away */
+  if (srv_thread_pool)
+    srv_thread_pool->unbind(file);
+#endif
   int ret= close(file);
 
   if (!ret)
@@ -3725,7 +3748,23 @@ int os_aio_init()
     goto disable;
 #endif
 
+#ifdef HAVE_URING
+  int options= 0;
+  if (srv_io_uring_sqpoll)
+    options|= tpool::AIO_SQPOLL;
+  if (srv_io_uring_iopoll)
+    options|= tpool::AIO_IOPOLL;
+  ret= srv_thread_pool->configure_aio(srv_use_native_aio, max_events, options);
+  if (ret && options)
+  {
+    ut_ad(srv_use_native_aio);
+    ib::warn() << "io_uring could not be set up with innodb_io_uring_sqpoll"
+      " or innodb_io_uring_iopoll; retrying without them";
+    ret= srv_thread_pool->configure_aio(true, max_events);
+  }
+#else
   ret= srv_thread_pool->configure_aio(srv_use_native_aio, max_events);
+#endif
 
 #ifdef LINUX_NATIVE_AIO
   if (ret)
@@ -3766,9 +3805,34 @@ void os_aio_free()
   write_slots.reset();
 }
 
+void os_aio_register_buffer(void *ptr, size_t size)
+{
+  if (srv_thread_pool && srv_use_native_aio)
+    srv_thread_pool->register_buffer(ptr, size);
+}
+
+void os_aio_unregister_buffer(void *ptr, size_t size)
+{
+  if (srv_thread_pool && srv_use_native_aio)
+    srv_thread_pool->unregister_buffer(ptr, size);
+}
+
+os_aio_batch::os_aio_batch()
+{
+  if (srv_use_native_aio)
+    srv_thread_pool->begin_batch();
+}
+
+os_aio_batch::~os_aio_batch()
+{
+  if (srv_use_native_aio)
+    srv_thread_pool->end_batch();
+}
+
 /** Wait until there are no pending asynchronous writes. */
 static void os_aio_wait_until_no_pending_writes_low()
 {
+  srv_thread_pool->submit_batch();
   bool notify_wait = write_slots->pending_io_count() > 0;
 
   if (notify_wait)
@@ -3790,6 +3854,7 @@ void os_aio_wait_until_no_pending_writes()
 /** Wait until all pending asynchronous reads have completed. */
 void os_aio_wait_until_no_pending_reads()
 {
+  srv_thread_pool->submit_batch();
   const auto notify_wait= read_slots->pending_io_count();
 
   if (notify_wait)
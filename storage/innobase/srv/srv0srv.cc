@@ -140,6 +140,10 @@ OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
+#ifdef HAVE_URING
+my_bool	srv_io_uring_sqpoll;
+my_bool	srv_io_uring_iopoll;
+#endif
 my_bool	srv_numa_interleave;
 /** copy of innodb_use_atomic_writes; @see innodb_init_params() */
 my_bool	srv_use_atomic_writes;
@@ -998,6 +1002,11 @@ srv_export_innodb_status(void)
 	export_vars.innodb_data_pending_reads =
 		ulint(MONITOR_VALUE(MONITOR_OS_PENDING_READS));
 
+#ifdef HAVE_URING
+	srv_thread_pool->get_aio_stats(&export_vars.innodb_io_uring);
+#endif
+	srv_thread_pool->get_queue_stats(export_vars.innodb_tpool);
+
 	export_vars.innodb_data_pending_writes =
 		ulint(MONITOR_VALUE(MONITOR_OS_PENDING_WRITES));
 
@@ -1311,10 +1320,12 @@ bool srv_any_background_activity()
 static void purge_worker_callback(void*);
 static void purge_coordinator_callback(void*);
 
-static tpool::task_group purge_task_group;
+static tpool::task_group purge_task_group(innodb_purge_threads_MAX,
+                                          tpool::TASK_PRIORITY_LOW);
 tpool::waitable_task purge_worker_task(purge_worker_callback, nullptr,
                                        &purge_task_group);
-static tpool::task_group purge_coordinator_task_group(1);
+static tpool::task_group purge_coordinator_task_group(1,
+                                                      tpool::TASK_PRIORITY_LOW);
 static tpool::waitable_task purge_coordinator_task
   (purge_coordinator_callback, nullptr, &purge_coordinator_task_group);
 
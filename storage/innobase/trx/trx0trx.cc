@@ -31,6 +31,7 @@ Created 3/26/1996 Heikki Tuuri
 #endif
 
 #include <mysql/service_thd_error_context.h>
+#include "dur_prop.h"
 
 #include "btr0sea.h"
 #include "lock0lock.h"
@@ -1824,6 +1825,9 @@ static lsn_t trx_prepare_low(trx_t *trx)
 	return(mtr.commit_lsn());
 }
 
+extern "C"
+enum durability_properties thd_get_durability_property(const MYSQL_THD thd);
+
 /****************************************************************//**
 Prepares a transaction. */
 TRANSACTIONAL_TARGET
@@ -1837,6 +1841,15 @@ trx_prepare(
 	Recovered transactions cannot. */
 	ut_a(!trx->is_recovered);
 
+	/* Act as if the redo log that binlog_single_sync_commit did not
+	sync at prepare had been lost in a crash */
+	DBUG_EXECUTE_IF("binlog_single_sync_lose_prepare",
+			if (trx->mysql_thd
+			    && thd_get_durability_property(trx->mysql_thd)
+			    == HA_IGNORE_DURABILITY) {
+				return;
+			});
+
 	lsn_t	lsn = trx_prepare_low(trx);
 
 	ut_a(trx->state == TRX_STATE_ACTIVE);
@@ -1860,9 +1873,16 @@ trx_prepare(
 		there are > 2 users in the database. Then at least 2 users can
 		gather behind one doing the physical log write to disk.
 
-		We must not be holding any mutexes or latches here. */
+		We must not be holding any mutexes or latches here.
 
-		trx_flush_log_if_needed(lsn, trx);
+		With binlog_single_sync_commit, the binlog group commit
+		makes the log durable while it syncs the binlog. */
+
+		if (!trx->mysql_thd
+		    || thd_get_durability_property(trx->mysql_thd)
+		    != HA_IGNORE_DURABILITY) {
+			trx_flush_log_if_needed(lsn, trx);
+		}
 
 		if (!UT_LIST_GET_LEN(trx->lock.trx_locks)
 		    || trx->isolation_level == TRX_ISO_SERIALIZABLE) {
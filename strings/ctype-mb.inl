@@ -173,6 +173,8 @@ MY_FUNCTION_NAME(well_formed_char_length)(CHARSET_INFO *cs __attribute__((unused
     single-byte or multi-byte character was found
   - MY_CS_ILSEQ (0) on a bad byte sequence
   - MY_CS_TOOSMALLxx if the incoming sequence is incomplete
+  WELL_FORMED_PREFIX(b,e,nchars), if defined, skips a well formed prefix
+  of long strings faster, e.g. my_utf8_well_formed_prefix().
 */
 static size_t
 MY_FUNCTION_NAME(well_formed_char_length)(CHARSET_INFO *cs __attribute__((unused)),
@@ -182,6 +184,10 @@ MY_FUNCTION_NAME(well_formed_char_length)(CHARSET_INFO *cs __attribute__((unused
 {
   size_t nchars0= nchars;
   int chlen;
+#ifdef WELL_FORMED_PREFIX
+  if (e - b >= MY_SIMD_MIN_LENGTH)
+    b+= WELL_FORMED_PREFIX((const uchar *) b, (const uchar *) e, &nchars);
+#endif
   for ( ; nchars ; nchars--, b+= chlen)
   {
     if ((chlen= CHARLEN(cs, (uchar*) b, (uchar*) e)) <= 0)
@@ -0,0 +1,670 @@
+/*
+  Copyright (c) 2024 MariaDB Corporation
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+/*
+  Vectorized ASCII, UTF-8 and JSON string scanning
+
+  The UTF-8 validation checks every byte together with the three bytes
+  before it, using three 16-entry lookup tables indexed by nibbles,
+  see "Validating UTF-8 In Less Than One Instruction Per Byte" by
+  John Keiser and Daniel Lemire. Unlike the original algorithm it only
+  reports the well formed prefix of whole blocks, the caller finds the
+  exact position and the kind of the error character by character.
+
+  Implementations:
+  - x86: SSSE3 (16 bytes) and AVX2 (32 bytes), chosen at run time
+  - aarch64: NEON (16 bytes)
+  - otherwise: 8 ASCII bytes at a time
+*/
+
+#include "strings_def.h"
+#include <m_ctype.h>
+#include <my_bit.h>
+#include "ctype-utf8.h"
+#include "ctype-simd.h"
+
+#if (defined __GNUC__ && (__GNUC__ >= 5 || defined __clang__) && \
+     (defined __x86_64__ || defined __i386__)) || \
+    (defined _MSC_VER && (defined _M_X64 || defined _M_IX86))
+#define HAVE_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define MY_TARGET_SSSE3 /* nothing */
+#define MY_TARGET_AVX2  /* nothing */
+#else
+#include <cpuid.h>
+#define MY_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define MY_TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+#elif defined __aarch64__ && defined __ARM_NEON
+#define HAVE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+
+/*
+  Error flags of a pair of bytes, looked up by the high nibble of the
+  first byte, the low nibble of the first byte, and the high nibble of
+  the second byte. A pair is wrong if the AND of the three is not 0.
+  Surrogates (ED A0..ED BF) are allowed, like in my_charlen_utf8mb3().
+*/
+#define TOO_SHORT      0x01  /* 11______ 0_______, 11______ 11______ */
+#define TOO_LONG       0x02  /* 0_______ 10______ */
+#define OVERLONG_3     0x04  /* 11100000 100_____ */
+#define TOO_LARGE      0x08  /* 11110100 1001____, 11110100 101_____ */
+#define OVERLONG_2     0x20  /* 1100000_ 10______ */
+#define TOO_LARGE_1000 0x40  /* 11110101 1000____, 1111011_ 1000____ */
+#define OVERLONG_4     0x40  /* 11110000 1000____ */
+#define TWO_CONTS      0x80  /* 10______ 10______ */
+#define CARRY          (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+static const uchar utf8_byte_1_high[16]=
+{
+  /* 0_______ ________ */
+  TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+  TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+  /* 10______ ________ */
+  TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+  /* 1100____ ________ */
+  TOO_SHORT | OVERLONG_2,
+  /* 1101____ ________ */
+  TOO_SHORT,
+  /* 1110____ ________ */
+  TOO_SHORT | OVERLONG_3,
+  /* 1111____ ________ */
+  TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+};
+
+static const uchar utf8_byte_1_low[16]=
+{
+  /* ____0000 ________ */
+  CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+  /* ____0001 ________ */
+  CARRY | OVERLONG_2,
+  /* ____001_ ________ */
+  CARRY,
+  CARRY,
+  /* ____0100 ________ */
+  CARRY | TOO_LARGE,
+  /* ____0101 ________ and above */
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000,
+  CARRY | TOO_LARGE | TOO_LARGE_1000
+};
+
+static const uchar utf8_byte_2_high[16]=
+{
+  /* ________ 0_______ */
+  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+  /* ________ 1000____ */
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+  /* ________ 1001____ */
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+  /* ________ 101_____ */
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | TOO_LARGE,
+  TOO_LONG | OVERLONG_2 | TWO_CONTS | TOO_LARGE,
+  /* ________ 11______ */
+  TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+};
+
+/*
+  A block that ends with the first bytes of a character must be followed
+  by continuation bytes: the last byte must be below 0xC0, the one before
+  below 0xE0, and the one before that below 0xF0.
+*/
+static const uchar utf8_incomplete_max[32]=
+{
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+
+/*
+  The blocks before p are well formed, but p can be in the middle of
+  a character that started in the last block. Move back to its first
+  byte, and don't count it.
+*/
+static size_t utf8_prefix_end(const uchar *b, const uchar *p,
+                              size_t *nchars, size_t left)
+{
+  if (p > b)
+  {
+    const uchar *q;
+    uint len;
+    for (q= p - 1; IS_CONTINUATION_BYTE(*q); q--)
+      DBUG_ASSERT(q > b);
+    len= *q < 0x80 ? 1 : *q < 0xE0 ? 2 : *q < 0xF0 ? 3 : 4;
+    if (q + len > p)
+    {
+      p= q;
+      left++;
+    }
+  }
+  *nchars= left;
+  return (size_t) (p - b);
+}
+
+
+/* 8 ASCII bytes at a time, for platforms without a vector version */
+static size_t utf8_prefix_generic(const uchar *b, const uchar *e,
+                                  size_t *nchars, uint mbmaxlen
+                                  __attribute__((unused)))
+{
+  const uchar *p= b;
+  size_t left= *nchars;
+  for ( ; e - p >= 8 && left >= 8; p+= 8, left-= 8)
+  {
+    ulonglong word;
+    memcpy(&word, p, 8);
+    if (word & 0x8080808080808080ULL)
+      break;
+  }
+  *nchars= left;
+  return (size_t) (p - b);
+}
+
+
+static size_t ascii_prefix_generic(const uchar *b, const uchar *e)
+{
+  const uchar *p= b;
+  for ( ; e - p >= 8; p+= 8)
+  {
+    ulonglong word;
+    memcpy(&word, p, 8);
+    if (word & 0x8080808080808080ULL)
+      break;
+  }
+  while (p < e && *p < 0x80)
+    p++;
+  return (size_t) (p - b);
+}
+
+
+/*
+  Bytes that can be skipped in a JSON string constant: printable ASCII
+  other than the quote and the backslash.
+*/
+static inline my_bool json_plain_byte(uchar c)
+{
+  return c >= 0x20 && c < 0x80 && c != '"' && c != '\\';
+}
+
+
+#define ONES 0x0101010101010101ULL
+
+static size_t json_plain_prefix_generic(const uchar *b, const uchar *e)
+{
+  const uchar *p= b;
+  for ( ; e - p >= 8; p+= 8)
+  {
+    ulonglong word, quote, bksl;
+    memcpy(&word, p, 8);
+    quote= word ^ (ONES * '"');
+    bksl= word ^ (ONES * '\\');
+    /* The high bit of a byte below 0x20 or above 0x7F, or of a zero byte */
+    if ((((word - ONES * 0x20) | word |
+          ((quote - ONES) & ~quote) | ((bksl - ONES) & ~bksl)) &
+         (ONES * 0x80)))
+      break;
+  }
+  while (p < e && json_plain_byte(*p))
+    p++;
+  return (size_t) (p - b);
+}
+
+#undef ONES
+
+
+#ifdef HAVE_SIMD_X86
+
+MY_TARGET_SSSE3
+static size_t utf8_prefix_ssse3(const uchar *b, const uchar *e,
+                                size_t *nchars, uint mbmaxlen)
+{
+  const __m128i zero= _mm_setzero_si128();
+  const __m128i nibble= _mm_set1_epi8(0x0F);
+  const __m128i byte_1_high= _mm_loadu_si128((const __m128i*) utf8_byte_1_high);
+  const __m128i byte_1_low= _mm_loadu_si128((const __m128i*) utf8_byte_1_low);
+  const __m128i byte_2_high= _mm_loadu_si128((const __m128i*) utf8_byte_2_high);
+  const __m128i incomplete_max=
+    _mm_loadu_si128((const __m128i*) (utf8_incomplete_max + 16));
+  /* utf8mb3 has no 4-byte characters */
+  const __m128i max_byte= _mm_set1_epi8(mbmaxlen == 3 ? (char) 0xEF :
+                                                        (char) 0xFF);
+  __m128i prev= zero, prev_incomplete= zero;
+  const uchar *p= b;
+  size_t left= *nchars;
+
+  for ( ; e - p >= 16; p+= 16)
+  {
+    __m128i in= _mm_loadu_si128((const __m128i*) p);
+    uint chars;
+    if (!_mm_movemask_epi8(in))
+    {
+      /* ASCII, only a character started in the previous block can fail */
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(prev_incomplete, zero)) != 0xFFFF)
+        break;
+      chars= 16;
+      prev_incomplete= zero;
+    }
+    else
+    {
+      __m128i prev1= _mm_alignr_epi8(in, prev, 15);
+      __m128i prev2= _mm_alignr_epi8(in, prev, 14);
+      __m128i prev3= _mm_alignr_epi8(in, prev, 13);
+      __m128i special=
+        _mm_and_si128(
+          _mm_and_si128(
+            _mm_shuffle_epi8(byte_1_high,
+                             _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+            _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+          _mm_shuffle_epi8(byte_2_high,
+                           _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+      /* the 3rd and 4th bytes of a character must be continuation bytes */
+      __m128i must23=
+        _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)),
+                     _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80)));
+      __m128i error=
+        _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8((char) 0x80)),
+                      special);
+      error= _mm_or_si128(error, _mm_subs_epu8(in, max_byte));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF)
+        break;
+      /* count all bytes but the continuation bytes 0x80..0xBF */
+      chars= 16 - my_count_bits_uint32(
+                    _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-64), in)));
+      prev_incomplete= _mm_subs_epu8(in, incomplete_max);
+    }
+    if (chars > left)
+      break;
+    left-= chars;
+    prev= in;
+  }
+  return utf8_prefix_end(b, p, nchars, left);
+}
+
+
+/* bytes of 'in' preceded by the last N bytes of 'prev' */
+#define AVX2_PREV(in, prev, N) \
+  _mm256_alignr_epi8(in, _mm256_permute2x128_si256(prev, in, 0x21), 16 - (N))
+
+MY_TARGET_AVX2
+static size_t utf8_prefix_avx2(const uchar *b, const uchar *e,
+                               size_t *nchars, uint mbmaxlen)
+{
+  const __m256i zero= _mm256_setzero_si256();
+  const __m256i nibble= _mm256_set1_epi8(0x0F);
+  const __m256i byte_1_high= _mm256_broadcastsi128_si256(
+    _mm_loadu_si128((const __m128i*) utf8_byte_1_high));
+  const __m256i byte_1_low= _mm256_broadcastsi128_si256(
+    _mm_loadu_si128((const __m128i*) utf8_byte_1_low));
+  const __m256i byte_2_high= _mm256_broadcastsi128_si256(
+    _mm_loadu_si128((const __m128i*) utf8_byte_2_high));
+  const __m256i incomplete_max=
+    _mm256_loadu_si256((const __m256i*) utf8_incomplete_max);
+  const __m256i max_byte= _mm256_set1_epi8(mbmaxlen == 3 ? (char) 0xEF :
+                                                           (char) 0xFF);
+  __m256i prev= zero, prev_incomplete= zero;
+  const uchar *p= b;
+  size_t left= *nchars;
+
+  for ( ; e - p >= 32; p+= 32)
+  {
+    __m256i in= _mm256_loadu_si256((const __m256i*) p);
+    uint chars;
+    if (!_mm256_movemask_epi8(in))
+    {
+      if (!_mm256_testz_si256(prev_incomplete, prev_incomplete))
+        break;
+      chars= 32;
+      prev_incomplete= zero;
+    }
+    else
+    {
+      __m256i prev1= AVX2_PREV(in, prev, 1);
+      __m256i prev2= AVX2_PREV(in, prev, 2);
+      __m256i prev3= AVX2_PREV(in, prev, 3);
+      __m256i special=
+        _mm256_and_si256(
+          _mm256_and_si256(
+            _mm256_shuffle_epi8(byte_1_high,
+                                _mm256_and_si256(_mm256_srli_epi16(prev1, 4),
+                                                 nibble)),
+            _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+          _mm256_shuffle_epi8(byte_2_high,
+                              _mm256_and_si256(_mm256_srli_epi16(in, 4),
+                                               nibble)));
+      __m256i must23=
+        _mm256_or_si256(_mm256_subs_epu8(prev2,
+                                         _mm256_set1_epi8(0xE0 - 0x80)),
+                        _mm256_subs_epu8(prev3,
+                                         _mm256_set1_epi8(0xF0 - 0x80)));
+      __m256i error=
+        _mm256_xor_si256(_mm256_and_si256(must23,
+                                          _mm256_set1_epi8((char) 0x80)),
+                         special);
+      error= _mm256_or_si256(error, _mm256_subs_epu8(in, max_byte));
+      if (!_mm256_testz_si256(error, error))
+        break;
+      chars= 32 - my_count_bits_uint32((uint32) _mm256_movemask_epi8(
+                    _mm256_cmpgt_epi8(_mm256_set1_epi8(-64), in)));
+      prev_incomplete= _mm256_subs_epu8(in, incomplete_max);
+    }
+    if (chars > left)
+      break;
+    left-= chars;
+    prev= in;
+  }
+  return utf8_prefix_end(b, p, nchars, left);
+}
+
+
+/* SSE2 is always there on x86_64, but not necessarily on i386 */
+MY_TARGET_SSSE3
+static size_t ascii_prefix_ssse3(const uchar *b, const uchar *e)
+{
+  const uchar *p= b;
+  for ( ; e - p >= 16; p+= 16)
+  {
+    uint mask= _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) p));
+    if (mask)
+      return (size_t) (p - b) + my_find_first_bit(mask);
+  }
+  return (size_t) (p - b) + ascii_prefix_generic(p, e);
+}
+
+
+MY_TARGET_AVX2
+static size_t ascii_prefix_avx2(const uchar *b, const uchar *e)
+{
+  const uchar *p= b;
+  for ( ; e - p >= 32; p+= 32)
+  {
+    uint mask= (uint) _mm256_movemask_epi8(
+                 _mm256_loadu_si256((const __m256i*) p));
+    if (mask)
+      return (size_t) (p - b) + my_find_first_bit(mask);
+  }
+  return (size_t) (p - b) + ascii_prefix_ssse3(p, e);
+}
+
+
+MY_TARGET_SSSE3
+static size_t json_plain_prefix_ssse3(const uchar *b, const uchar *e)
+{
+  const __m128i quote= _mm_set1_epi8('"');
+  const __m128i bksl= _mm_set1_epi8('\\');
+  const __m128i space= _mm_set1_epi8(' ');
+  const uchar *p= b;
+  for ( ; e - p >= 16; p+= 16)
+  {
+    __m128i in= _mm_loadu_si128((const __m128i*) p);
+    /* Signed comparison: bytes above 0x7F are negative */
+    __m128i special= _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(in, quote),
+                                               _mm_cmpeq_epi8(in, bksl)),
+                                  _mm_cmplt_epi8(in, space));
+    uint mask= _mm_movemask_epi8(special);
+    if (mask)
+      return (size_t) (p - b) + my_find_first_bit(mask);
+  }
+  return (size_t) (p - b) + json_plain_prefix_generic(p, e);
+}
+
+
+MY_TARGET_AVX2
+static size_t json_plain_prefix_avx2(const uchar *b, const uchar *e)
+{
+  const __m256i quote= _mm256_set1_epi8('"');
+  const __m256i bksl= _mm256_set1_epi8('\\');
+  const __m256i space= _mm256_set1_epi8(' ');
+  const uchar *p= b;
+  for ( ; e - p >= 32; p+= 32)
+  {
+    __m256i in= _mm256_loadu_si256((const __m256i*) p);
+    /* Signed comparison: bytes above 0x7F are negative */
+    __m256i special=
+      _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(in, quote),
+                                      _mm256_cmpeq_epi8(in, bksl)),
+                      _mm256_cmpgt_epi8(space, in));
+    uint mask= (uint) _mm256_movemask_epi8(special);
+    if (mask)
+      return (size_t) (p - b) + my_find_first_bit(mask);
+  }
+  return (size_t) (p - b) + json_plain_prefix_ssse3(p, e);
+}
+
+
+static void cpu_features(my_bool *ssse3, my_bool *avx2)
+{
+  uint ecx1, ebx7= 0;
+  my_bool os_avx;
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 1);
+  ecx1= regs[2];
+  /* OSXSAVE, and the OS saves the XMM and YMM registers */
+  os_avx= (ecx1 & (1U << 27)) && (_xgetbv(0) & 6) == 6;
+  __cpuid(regs, 0);
+  if (regs[0] >= 7)
+  {
+    __cpuidex(regs, 7, 0);
+    ebx7= regs[1];
+  }
+#else
+  uint eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx1, &edx))
+    ecx1= 0;
+  os_avx= 0;
+  if (ecx1 & (1U << 27))
+  {
+    uint xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+    os_avx= (xcr0_lo & 6) == 6;
+  }
+  if (__get_cpuid_max(0, 0) >= 7)
+    __cpuid_count(7, 0, eax, ebx7, ecx, edx);
+#endif
+  *ssse3= MY_TEST(ecx1 & (1U << 9));
+  *avx2= os_avx && (ebx7 & (1U << 5));
+}
+
+#endif /* HAVE_SIMD_X86 */
+
+
+#ifdef HAVE_SIMD_NEON
+
+static size_t utf8_prefix_neon(const uchar *b, const uchar *e,
+                               size_t *nchars, uint mbmaxlen)
+{
+  const uint8x16_t byte_1_high= vld1q_u8(utf8_byte_1_high);
+  const uint8x16_t byte_1_low= vld1q_u8(utf8_byte_1_low);
+  const uint8x16_t byte_2_high= vld1q_u8(utf8_byte_2_high);
+  const uint8x16_t incomplete_max= vld1q_u8(utf8_incomplete_max + 16);
+  const uint8x16_t max_byte= vdupq_n_u8(mbmaxlen == 3 ? 0xEF : 0xFF);
+  uint8x16_t prev= vdupq_n_u8(0), prev_incomplete= vdupq_n_u8(0);
+  const uchar *p= b;
+  size_t left= *nchars;
+
+  for ( ; e - p >= 16; p+= 16)
+  {
+    uint8x16_t in= vld1q_u8(p);
+    uint chars;
+    if (vmaxvq_u8(in) < 0x80)
+    {
+      if (vmaxvq_u8(prev_incomplete))
+        break;
+      chars= 16;
+      prev_incomplete= vdupq_n_u8(0);
+    }
+    else
+    {
+      uint8x16_t prev1= vextq_u8(prev, in, 15);
+      uint8x16_t prev2= vextq_u8(prev, in, 14);
+      uint8x16_t prev3= vextq_u8(prev, in, 13);
+      uint8x16_t special=
+        vandq_u8(vandq_u8(vqtbl1q_u8(byte_1_high, vshrq_n_u8(prev1, 4)),
+                          vqtbl1q_u8(byte_1_low,
+                                     vandq_u8(prev1, vdupq_n_u8(0x0F)))),
+                 vqtbl1q_u8(byte_2_high, vshrq_n_u8(in, 4)));
+      uint8x16_t must23= vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)),
+                                  vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+      uint8x16_t error= veorq_u8(vandq_u8(must23, vdupq_n_u8(0x80)), special);
+      error= vorrq_u8(error, vqsubq_u8(in, max_byte));
+      if (vmaxvq_u8(error))
+        break;
+      chars= 16 - vaddvq_u8(vshrq_n_u8(
+                   vcltq_s8(vreinterpretq_s8_u8(in), vdupq_n_s8(-64)), 7));
+      prev_incomplete= vqsubq_u8(in, incomplete_max);
+    }
+    if (chars > left)
+      break;
+    left-= chars;
+    prev= in;
+  }
+  return utf8_prefix_end(b, p, nchars, left);
+}
+
+
+static size_t ascii_prefix_neon(const uchar *b, const uchar *e)
+{
+  const uchar *p= b;
+  for ( ; e - p >= 16; p+= 16)
+  {
+    if (vmaxvq_u8(vld1q_u8(p)) >= 0x80)
+      break;
+  }
+  return (size_t) (p - b) + ascii_prefix_generic(p, e);
+}
+
+
+static size_t json_plain_prefix_neon(const uchar *b, const uchar *e)
+{
+  const uchar *p= b;
+  for ( ; e - p >= 16; p+= 16)
+  {
+    uint8x16_t in= vld1q_u8(p);
+    uint8x16_t special=
+      vorrq_u8(vorrq_u8(vceqq_u8(in, vdupq_n_u8('"')),
+                        vceqq_u8(in, vdupq_n_u8('\\'))),
+               vorrq_u8(vcltq_u8(in, vdupq_n_u8(0x20)),
+                        vcgeq_u8(in, vdupq_n_u8(0x80))));
+    if (vmaxvq_u8(special))
+      break;
+  }
+  return (size_t) (p - b) + json_plain_prefix_generic(p, e);
+}
+
+#endif /* HAVE_SIMD_NEON */
+
+
+typedef size_t (*utf8_prefix_func)(const uchar *, const uchar *,
+                                   size_t *, uint);
+typedef size_t (*ascii_prefix_func)(const uchar *, const uchar *);
+
+static size_t utf8_prefix_choose(const uchar *b, const uchar *e,
+                                 size_t *nchars, uint mbmaxlen);
+static size_t ascii_prefix_choose(const uchar *b, const uchar *e);
+static size_t json_plain_prefix_choose(const uchar *b, const uchar *e);
+
+/*
+  Chosen on the first call. Several threads may do it at once, they all
+  store the same values.
+*/
+static utf8_prefix_func utf8_prefix= utf8_prefix_choose;
+static ascii_prefix_func ascii_prefix= ascii_prefix_choose;
+static ascii_prefix_func json_plain_prefix= json_plain_prefix_choose;
+
+static void simd_choose()
+{
+  utf8_prefix_func utf8= utf8_prefix_generic;
+  ascii_prefix_func ascii= ascii_prefix_generic;
+  ascii_prefix_func json= json_plain_prefix_generic;
+#if defined HAVE_SIMD_X86
+  my_bool ssse3, avx2;
+  cpu_features(&ssse3, &avx2);
+  if (avx2)
+  {
+    utf8= utf8_prefix_avx2;
+    ascii= ascii_prefix_avx2;
+    json= json_plain_prefix_avx2;
+  }
+  else if (ssse3)
+  {
+    utf8= utf8_prefix_ssse3;
+    ascii= ascii_prefix_ssse3;
+    json= json_plain_prefix_ssse3;
+  }
+#elif defined HAVE_SIMD_NEON
+  utf8= utf8_prefix_neon;
+  ascii= ascii_prefix_neon;
+  json= json_plain_prefix_neon;
+#endif
+  utf8_prefix= utf8;
+  ascii_prefix= ascii;
+  json_plain_prefix= json;
+}
+
+static size_t utf8_prefix_choose(const uchar *b, const uchar *e,
+                                 size_t *nchars, uint mbmaxlen)
+{
+  simd_choose();
+  return utf8_prefix(b, e, nchars, mbmaxlen);
+}
+
+static size_t ascii_prefix_choose(const uchar *b, const uchar *e)
+{
+  simd_choose();
+  return ascii_prefix(b, e);
+}
+
+static size_t json_plain_prefix_choose(const uchar *b, const uchar *e)
+{
+  simd_choose();
+  return json_plain_prefix(b, e);
+}
+
+
+size_t my_ascii_prefix_length(const uchar *b, const uchar *e)
+{
+  return ascii_prefix(b, e);
+}
+
+
+size_t my_utf8_well_formed_prefix(const uchar *b, const uchar *e,
+                                  size_t *nchars, uint mbmaxlen)
+{
+  DBUG_ASSERT(mbmaxlen == 3 || mbmaxlen == 4);
+  return utf8_prefix(b, e, nchars, mbmaxlen);
+}
+
+
+size_t my_json_plain_prefix_length(const uchar *b, const uchar *e)
+{
+  return json_plain_prefix(b, e);
+}
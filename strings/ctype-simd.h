@@ -0,0 +1,48 @@
+/*
+  Copyright (c) 2024 MariaDB Corporation
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; version 2 of the License.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+*/
+
+#ifndef _CTYPE_SIMD_H
+#define _CTYPE_SIMD_H
+
+/*
+  Vectorized kernels for long strings, see ctype-simd.c.
+  Shorter strings are not worth a call, callers should do them byte by byte.
+*/
+#define MY_SIMD_MIN_LENGTH 16
+
+/* Number of leading bytes in the range 0x00..0x7F */
+size_t my_ascii_prefix_length(const uchar *b, const uchar *e);
+
+/*
+  Skip the well formed utf8mb3 (mbmaxlen=3) or utf8mb4 (mbmaxlen=4)
+  characters at the beginning of [b,e), at most *nchars of them.
+  Returns the number of bytes skipped, which always ends on a character
+  boundary, and decrements *nchars by the number of characters skipped.
+  It stops before a block with a bad byte sequence, the rest must be
+  checked character by character.
+*/
+size_t my_utf8_well_formed_prefix(const uchar *b, const uchar *e,
+                                  size_t *nchars, uint mbmaxlen);
+
+/*
+  Number of leading bytes which are printable ASCII characters other than
+  the quote and the backslash, so they can be skipped in a JSON string
+  constant in any ASCII based character set.
+*/
+size_t my_json_plain_prefix_length(const uchar *b, const uchar *e);
+
+#endif /* _CTYPE_SIMD_H */
@@ -34,6 +34,7 @@
 
 #include "strings_def.h"
 #include <m_ctype.h>
+#include "ctype-simd.h"
 
 typedef struct
 {
@@ -31816,6 +31817,74 @@ my_space_weight(const MY_UCA_WEIGHT_LEVEL *level)
 }
 
 
+/*
+  The end of the run of ASCII bytes at the beginning of [str,end).
+  Long runs are found with the vectorized scan from ctype-simd.c.
+*/
+static inline const uchar *
+my_uca_ascii_run_end(const uchar *str, const uchar *end)
+{
+  if ((size_t) (end - str) >= MY_SIMD_MIN_LENGTH)
+    return str + my_ascii_prefix_length(str, end);
+  for ( ; str < end && *str < 0x80; str++)
+  { }
+  return str;
+}
+
+
+/*
+  Weights of the ASCII characters on a level, copied to a local
+  variable once per string. The loops writing sort keys do not have
+  to reload them from the level after every byte stored then.
+*/
+typedef struct my_uca_ascii_weights_st
+{
+  const uint16 *weights;      /* Weight strings of the page 0 */
+  uint length;                /* Weight string length on the page 0 */
+  const char *context_flags;  /* Contraction flags, or NULL */
+} MY_UCA_ASCII_WEIGHTS;
+
+
+static inline void
+my_uca_ascii_weights_init(MY_UCA_ASCII_WEIGHTS *ascii,
+                          const MY_UCA_WEIGHT_LEVEL *level)
+{
+  ascii->weights= level->weights[0];
+  ascii->length= level->lengths[0];
+  ascii->context_flags= level->contractions.nitems ?
+                        level->contractions.flags : NULL;
+}
+
+
+/*
+  Leave the scanner in the state it would have after scanning
+  the ASCII characters up to "str" itself, the last of them
+  having the weight string "weight" of at most one weight.
+  This keeps the previous context handling of the next character right.
+*/
+static inline void
+my_uca_scanner_skip_ascii(my_uca_scanner *scanner, const uchar *str,
+                          const uint16 *weight)
+{
+  DBUG_ASSERT(str > scanner->sbeg && !weight[1]);
+  scanner->page= 0;
+  scanner->code= str[-1];
+  scanner->wbeg= weight + 1;
+  scanner->sbeg= str;
+}
+
+
+/*
+  Add a weight to the hash value, the high byte first.
+  See the comment in hash_sort() why MY_HASH_ADD_16() is not used.
+*/
+#define MY_UCA_HASH_ADD_WEIGHT(m1, m2, weight) \
+  do { \
+    MY_HASH_ADD(m1, m2, (weight) >> 8); \
+    MY_HASH_ADD(m1, m2, (weight) & 0xFF); \
+  } while (0)
+
+
 /**
   Helper function:
   Find address of weights of the given character.
@@ -29,6 +29,7 @@
 
 
 #include "ctype-utf8.h"
+#include "ctype-simd.h"
 #include "ctype-unidata.h"
 
 
@@ -5475,10 +5476,12 @@ int my_charlen_utf8mb3(CHARSET_INFO *cs __attribute__((unused)),
 
 #define MY_FUNCTION_NAME(x)       my_ ## x ## _utf8mb3
 #define CHARLEN(cs,str,end)       my_charlen_utf8mb3(cs,str,end)
+#define WELL_FORMED_PREFIX(b,e,n) my_utf8_well_formed_prefix(b,e,n,3)
 #define DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
 #include "ctype-mb.inl"
 #undef MY_FUNCTION_NAME
 #undef CHARLEN
+#undef WELL_FORMED_PREFIX
 #undef DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
 /* my_well_formed_char_length_utf8mb3 */
 
@@ -7948,10 +7951,12 @@ my_charlen_utf8mb4(CHARSET_INFO *cs __attribute__((unused)),
 
 #define MY_FUNCTION_NAME(x)       my_ ## x ## _utf8mb4
 #define CHARLEN(cs,str,end)       my_charlen_utf8mb4(cs,str,end)
+#define WELL_FORMED_PREFIX(b,e,n) my_utf8_well_formed_prefix(b,e,n,4)
 #define DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
 #include "ctype-mb.inl"
 #undef MY_FUNCTION_NAME
 #undef CHARLEN
+#undef WELL_FORMED_PREFIX
 #undef DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
 /* my_well_formed_char_length_utf8mb4 */
 
@@ -17,6 +17,7 @@
 #include "strings_def.h"
 #include <m_ctype.h>
 #include <my_xml.h>
+#include "ctype-simd.h"
 
 /*
 
@@ -1238,21 +1239,17 @@ my_convert(char *to, uint32 to_length, CHARSET_INFO *to_cs,
 
   length= length2= MY_MIN(to_length, from_length);
 
-#if defined(__i386__) || defined(__x86_64__)
-  /*
-    Special loop for i386, it allows to refer to a
-    non-aligned memory block as UINT32, which makes
-    it possible to copy four bytes at once. This
-    gives about 10% performance improvement comparing
-    to byte-by-byte loop.
-  */
-  for ( ; length >= 4; length-= 4, from+= 4, to+= 4)
+  if (length >= MY_SIMD_MIN_LENGTH)
   {
-    if ((*(uint32*)from) & 0x80808080)
-      break;
-    *((uint32*) to)= *((const uint32*) from);
+    /* Copy the leading ASCII characters at once */
+    uint32 ascii= (uint32) my_ascii_prefix_length((const uchar *) from,
+                                                  (const uchar *) from +
+                                                  length);
+    memcpy(to, from, ascii);
+    from+= ascii;
+    to+= ascii;
+    length-= ascii;
   }
-#endif /* __i386__ */
 
   for (; ; *to++= *from++, length--)
   {
@@ -1293,6 +1290,8 @@ my_convert_fix(CHARSET_INFO *to_cs, char *to, size_t to_length,
   const uchar *from_end= (const uchar*) from + from_length;
   uchar *to_end= (uchar*) to + to_length;
   char *to_start= to;
+  /* ASCII characters can be copied as is, see my_convert() */
+  my_bool copy_ascii= !((to_cs->state | from_cs->state) & MY_CS_NONASCII);
 
   DBUG_ASSERT(to_cs != &my_charset_bin);
   DBUG_ASSERT(from_cs != &my_charset_bin);
@@ -1303,6 +1302,21 @@ my_convert_fix(CHARSET_INFO *to_cs, char *to, size_t to_length,
   for ( ; nchars; nchars--)
   {
     const char *from_prev= from;
+    if (copy_ascii && from_end - (const uchar *) from >= MY_SIMD_MIN_LENGTH &&
+        (uchar) *from < 0x80)
+    {
+      size_t ascii= my_ascii_prefix_length((const uchar *) from, from_end);
+      set_if_smaller(ascii, nchars);
+      set_if_smaller(ascii, (size_t) (to_end - (uchar *) to));
+      if (ascii > 1)
+      {
+        memcpy(to, from, ascii);
+        from+= ascii;
+        to+= ascii;
+        nchars-= ascii - 1;
+        continue;
+      }
+    }
     if ((cnvres= (*mb_wc)(from_cs, &wc, (uchar*) from, from_end)) > 0)
       from+= cnvres;
     else if (cnvres == MY_CS_ILSEQ)
@@ -1205,6 +1205,98 @@ int decimal2longlong(const decimal_t *from, longlong *to)
   return E_DEC_OK;
 }
 
+
+/*
+  Convert decimal to the integer value*10^scale
+
+  SYNOPSIS
+    decimal2longlong_scaled()
+      from    - value to convert
+      scale   - the number of digits after the point to keep
+      to      - points to result
+
+  NOTE
+    It is done only if nothing is lost, and the integer cannot overflow:
+    the value has at most scale digits after the point, and at most
+    DECIMAL_SCALED_LONGLONG_DIGITS digits altogether.
+
+  RETURN VALUE
+    E_DEC_OK/E_DEC_OVERFLOW
+*/
+
+int decimal2longlong_scaled(const decimal_t *from, decimal_digits_t scale,
+                            longlong *to)
+{
+  dec1 *buf=from->buf;
+  longlong x=0;
+  int intg=from->intg, frac;
+
+  /* Leading zero words, like the one of 0.5, hold no digits */
+  for (; intg > 0 && !*buf; buf++)
+    intg-= intg % DIG_PER_DEC1 ? intg % DIG_PER_DEC1 : DIG_PER_DEC1;
+  if (from->frac > scale || intg + scale > DECIMAL_SCALED_LONGLONG_DIGITS)
+    return E_DEC_OVERFLOW;
+
+  for (; intg > 0; intg-=DIG_PER_DEC1)
+    x=x*DIG_BASE + *buf++;
+  for (frac=from->frac; frac > 0; frac-=DIG_PER_DEC1)
+  {
+    int digits= MY_MIN(frac, DIG_PER_DEC1);
+    x=x*powers10[digits] + *buf++/powers10[DIG_PER_DEC1-digits];
+  }
+  for (frac=from->frac; frac < scale; frac++)
+    x*=10;
+
+  *to=from->sign ? -x : x;
+  return E_DEC_OK;
+}
+
+
+/*
+  Convert the integer value*10^scale back to decimal
+
+  SYNOPSIS
+    longlong_scaled2decimal()
+      from    - value*10^scale
+      scale   - the number of digits after the point,
+                at most DECIMAL_SCALED_LONGLONG_DIGITS
+      to      - points to result
+
+  RETURN VALUE
+    E_DEC_OK/E_DEC_OVERFLOW
+*/
+
+int longlong_scaled2decimal(longlong from, decimal_digits_t scale,
+                            decimal_t *to)
+{
+  ulonglong x= from < 0 ? -(ulonglong) from : (ulonglong) from;
+  ulonglong div=1, frac_part;
+  dec1 *buf;
+  int i, error;
+
+  DBUG_ASSERT(scale <= DECIMAL_SCALED_LONGLONG_DIGITS);
+  for (i=0; i < scale; i++)
+    div*=10;
+  frac_part=x % div;
+  if ((error=ull2dec(x / div, to)))
+    return error;
+
+  buf=to->buf + ROUND_UP(to->intg);
+  if (buf + ROUND_UP(scale) > to->buf + to->len)
+    return E_DEC_OVERFLOW;
+  if (scale > DIG_PER_DEC1)
+  {
+    buf[0]=(dec1) (frac_part / powers10[scale-DIG_PER_DEC1]);
+    buf[1]=(dec1) (frac_part % powers10[scale-DIG_PER_DEC1]) *
+           powers10[2*DIG_PER_DEC1-scale];
+  }
+  else if (scale)
+    buf[0]=(dec1) frac_part * powers10[DIG_PER_DEC1-scale];
+  to->frac=scale;
+  to->sign=from < 0;
+  return E_DEC_OK;
+}
+
 /*
   Convert decimal to its binary fixed-length representation
   two representations of the same length can be compared with memcmp
@@ -1533,6 +1625,86 @@ int bin2decimal(const uchar *from, decimal_t *to, decimal_digits_t precision,
   return(E_DEC_BAD_NUM);
 }
 
+
+/*
+  Read one group of digits of the binary representation of a decimal,
+  see bin2longlong_scaled()
+*/
+
+static inline my_bool bin_digits_scaled(const uchar **from, int digits,
+                                        dec1 mask, longlong *x)
+{
+  dec1 UNINIT_VAR(d);
+  switch (dig2bytes[digits])
+  {
+    case 1: d=mi_sint1korr(*from); break;
+    case 2: d=mi_sint2korr(*from); break;
+    case 3: d=mi_sint3korr(*from); break;
+    case 4: d=mi_sint4korr(*from); break;
+    default: abort();
+  }
+  *from+=dig2bytes[digits];
+  d^=mask;
+  if ((uint32) d >= (uint32) powers10[digits])
+    return 1;
+  *x=*x*powers10[digits] + d;
+  return 0;
+}
+
+
+/*
+  Restores the integer value*10^scale from the binary representation
+  of a decimal
+
+  SYNOPSIS
+    bin2longlong_scaled()
+      from    - value to convert
+      precision/scale - see decimal_bin_size() below,
+                precision is at most DECIMAL_SCALED_LONGLONG_DIGITS
+      to      - points to result
+
+  NOTE
+    This is bin2decimal() followed by decimal2longlong_scaled(), without
+    the decimal_t in between.
+
+  RETURN VALUE
+    E_DEC_OK/E_DEC_BAD_NUM. For a bad number bin2decimal() tells what
+    to do with it.
+*/
+
+int bin2longlong_scaled(const uchar *from, decimal_digits_t precision,
+                        decimal_digits_t scale, longlong *to)
+{
+  int intg=precision-scale,
+      intg0=intg/DIG_PER_DEC1, frac0=scale/DIG_PER_DEC1,
+      intg0x=intg-intg0*DIG_PER_DEC1, frac0x=scale-frac0*DIG_PER_DEC1;
+  dec1 mask=(*from & 0x80) ? 0 : -1;
+  uchar d_copy[16];
+  size_t bin_size=dig2bytes[intg0x] + (intg0+frac0)*sizeof(dec1) +
+                  dig2bytes[frac0x];
+  longlong x=0;
+
+  DBUG_ASSERT(precision <= DECIMAL_SCALED_LONGLONG_DIGITS);
+  DBUG_ASSERT(bin_size <= sizeof(d_copy));
+  memcpy(d_copy, from, bin_size);
+  d_copy[0]^=0x80;
+  from=d_copy;
+
+  if (intg0x && bin_digits_scaled(&from, intg0x, mask, &x))
+    return E_DEC_BAD_NUM;
+  for (; intg0; intg0--)
+    if (bin_digits_scaled(&from, DIG_PER_DEC1, mask, &x))
+      return E_DEC_BAD_NUM;
+  for (; frac0; frac0--)
+    if (bin_digits_scaled(&from, DIG_PER_DEC1, mask, &x))
+      return E_DEC_BAD_NUM;
+  if (frac0x && bin_digits_scaled(&from, frac0x, mask, &x))
+    return E_DEC_BAD_NUM;
+
+  *to=mask ? -x : x;
+  return E_DEC_OK;
+}
+
 /*
   Returns the size of array to hold a decimal with given precision and scale
 
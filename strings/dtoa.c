@@ -54,6 +54,7 @@
 static double my_strtod_int(const char *, char **, int *, char *, size_t);
 static char *dtoa(double, int, int, int *, int *, char **, char *, size_t);
 static void dtoa_free(char *, char *, size_t);
+static my_bool strtod_fast(const char *, char **, double *);
 
 /**
    @brief
@@ -466,6 +467,11 @@ double my_strtod(const char *str, char **end, int *error)
                               (str == NULL && *end == NULL)) &&
               error != NULL);
 
+  if (str && my_fast_dtoa && !strtod_fast(str, end, &res))
+  {
+    *error= 0;
+    return res;
+  }
   res= my_strtod_int(str, end, error, buf, sizeof(buf));
   return (*error == 0) ? res : (res < 0 ? -DBL_MAX : DBL_MAX);
 }
@@ -2131,6 +2137,545 @@ static int quorem(Bigint *b, Bigint *S)
 }
 
 
+/*
+  Fast paths of dtoa() and my_strtod()
+
+  These follow Grisu3 from "Printing Floating-Point Numbers Quickly and
+  Accurately with Integers" by Florian Loitsch [PLDI 2010], and the
+  strtod() of the double-conversion library. The value is multiplied by a
+  cached power of ten with a 64-bit significand. The product is not exact,
+  so the digits are checked against the error bound. In the rare cases
+  (about 0.5% of random doubles) where they cannot be proven right, the
+  functions give up and the bignum code is used instead. The results are
+  therefore always the same as without the fast paths.
+*/
+
+/* Use the fast paths, cleared only to compare with the bignum code */
+my_bool my_fast_dtoa= TRUE;
+
+/* Value f * 2^e with a 64-bit significand */
+typedef struct Diy_fp
+{
+  ULLong f;
+  int e;
+} Diy_fp;
+
+/* 10^k rounded to 64 bits, k= -348, -340, ..., 340 */
+static const struct
+{
+  ULLong f;
+  int16 e;
+  int16 k;
+} cached_powers[]=
+{
+  { 0xfa8fd5a0081c0288ULL, -1220, -348 },
+  { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+  { 0x8b16fb203055ac76ULL, -1166, -332 },
+  { 0xcf42894a5dce35eaULL, -1140, -324 },
+  { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+  { 0xe61acf033d1a45dfULL, -1087, -308 },
+  { 0xab70fe17c79ac6caULL, -1060, -300 },
+  { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+  { 0xbe5691ef416bd60cULL, -1007, -284 },
+  { 0x8dd01fad907ffc3cULL,  -980, -276 },
+  { 0xd3515c2831559a83ULL,  -954, -268 },
+  { 0x9d71ac8fada6c9b5ULL,  -927, -260 },
+  { 0xea9c227723ee8bcbULL,  -901, -252 },
+  { 0xaecc49914078536dULL,  -874, -244 },
+  { 0x823c12795db6ce57ULL,  -847, -236 },
+  { 0xc21094364dfb5637ULL,  -821, -228 },
+  { 0x9096ea6f3848984fULL,  -794, -220 },
+  { 0xd77485cb25823ac7ULL,  -768, -212 },
+  { 0xa086cfcd97bf97f4ULL,  -741, -204 },
+  { 0xef340a98172aace5ULL,  -715, -196 },
+  { 0xb23867fb2a35b28eULL,  -688, -188 },
+  { 0x84c8d4dfd2c63f3bULL,  -661, -180 },
+  { 0xc5dd44271ad3cdbaULL,  -635, -172 },
+  { 0x936b9fcebb25c996ULL,  -608, -164 },
+  { 0xdbac6c247d62a584ULL,  -582, -156 },
+  { 0xa3ab66580d5fdaf6ULL,  -555, -148 },
+  { 0xf3e2f893dec3f126ULL,  -529, -140 },
+  { 0xb5b5ada8aaff80b8ULL,  -502, -132 },
+  { 0x87625f056c7c4a8bULL,  -475, -124 },
+  { 0xc9bcff6034c13053ULL,  -449, -116 },
+  { 0x964e858c91ba2655ULL,  -422, -108 },
+  { 0xdff9772470297ebdULL,  -396, -100 },
+  { 0xa6dfbd9fb8e5b88fULL,  -369,  -92 },
+  { 0xf8a95fcf88747d94ULL,  -343,  -84 },
+  { 0xb94470938fa89bcfULL,  -316,  -76 },
+  { 0x8a08f0f8bf0f156bULL,  -289,  -68 },
+  { 0xcdb02555653131b6ULL,  -263,  -60 },
+  { 0x993fe2c6d07b7facULL,  -236,  -52 },
+  { 0xe45c10c42a2b3b06ULL,  -210,  -44 },
+  { 0xaa242499697392d3ULL,  -183,  -36 },
+  { 0xfd87b5f28300ca0eULL,  -157,  -28 },
+  { 0xbce5086492111aebULL,  -130,  -20 },
+  { 0x8cbccc096f5088ccULL,  -103,  -12 },
+  { 0xd1b71758e219652cULL,   -77,   -4 },
+  { 0x9c40000000000000ULL,   -50,    4 },
+  { 0xe8d4a51000000000ULL,   -24,   12 },
+  { 0xad78ebc5ac620000ULL,     3,   20 },
+  { 0x813f3978f8940984ULL,    30,   28 },
+  { 0xc097ce7bc90715b3ULL,    56,   36 },
+  { 0x8f7e32ce7bea5c70ULL,    83,   44 },
+  { 0xd5d238a4abe98068ULL,   109,   52 },
+  { 0x9f4f2726179a2245ULL,   136,   60 },
+  { 0xed63a231d4c4fb27ULL,   162,   68 },
+  { 0xb0de65388cc8ada8ULL,   189,   76 },
+  { 0x83c7088e1aab65dbULL,   216,   84 },
+  { 0xc45d1df942711d9aULL,   242,   92 },
+  { 0x924d692ca61be758ULL,   269,  100 },
+  { 0xda01ee641a708deaULL,   295,  108 },
+  { 0xa26da3999aef774aULL,   322,  116 },
+  { 0xf209787bb47d6b85ULL,   348,  124 },
+  { 0xb454e4a179dd1877ULL,   375,  132 },
+  { 0x865b86925b9bc5c2ULL,   402,  140 },
+  { 0xc83553c5c8965d3dULL,   428,  148 },
+  { 0x952ab45cfa97a0b3ULL,   455,  156 },
+  { 0xde469fbd99a05fe3ULL,   481,  164 },
+  { 0xa59bc234db398c25ULL,   508,  172 },
+  { 0xf6c69a72a3989f5cULL,   534,  180 },
+  { 0xb7dcbf5354e9beceULL,   561,  188 },
+  { 0x88fcf317f22241e2ULL,   588,  196 },
+  { 0xcc20ce9bd35c78a5ULL,   614,  204 },
+  { 0x98165af37b2153dfULL,   641,  212 },
+  { 0xe2a0b5dc971f303aULL,   667,  220 },
+  { 0xa8d9d1535ce3b396ULL,   694,  228 },
+  { 0xfb9b7cd9a4a7443cULL,   720,  236 },
+  { 0xbb764c4ca7a44410ULL,   747,  244 },
+  { 0x8bab8eefb6409c1aULL,   774,  252 },
+  { 0xd01fef10a657842cULL,   800,  260 },
+  { 0x9b10a4e5e9913129ULL,   827,  268 },
+  { 0xe7109bfba19c0c9dULL,   853,  276 },
+  { 0xac2820d9623bf429ULL,   880,  284 },
+  { 0x80444b5e7aa7cf85ULL,   907,  292 },
+  { 0xbf21e44003acdd2dULL,   933,  300 },
+  { 0x8e679c2f5e44ff8fULL,   960,  308 },
+  { 0xd433179d9c8cb841ULL,   986,  316 },
+  { 0x9e19db92b4e31ba9ULL,  1013,  324 },
+  { 0xeb96bf6ebadf77d9ULL,  1039,  332 },
+  { 0xaf87023b9bf0ee6bULL,  1066,  340 }
+};
+
+#define CACHED_POWERS_OFFSET 348
+#define CACHED_POWERS_STEP 8
+
+/*
+  Binary exponent of the value scaled by a cached power in grisu_dtoa().
+  The integral part then has at most 32 bits.
+*/
+#define GRISU_MIN_TARGET_EXP (-60)
+#define GRISU_MAX_TARGET_EXP (-32)
+
+/* 10^1 .. 10^7, exact */
+static const Diy_fp adjustment_powers[]=
+{
+  { 0xa000000000000000ULL, -60 },
+  { 0xc800000000000000ULL, -57 },
+  { 0xfa00000000000000ULL, -54 },
+  { 0x9c40000000000000ULL, -50 },
+  { 0xc350000000000000ULL, -47 },
+  { 0xf424000000000000ULL, -44 },
+  { 0x9896800000000000ULL, -40 }
+};
+
+static const ULong small_powers10[]=
+{
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+
+/* Product of two values rounded to 64 bits */
+
+static Diy_fp diy_fp_mul(Diy_fp x, Diy_fp y)
+{
+  ULLong a= x.f >> 32, b= x.f & FFFFFFFF, c= y.f >> 32, d= y.f & FFFFFFFF;
+  ULLong ac= a * c, bc= b * c, ad= a * d, bd= b * d;
+  ULLong tmp= (bd >> 32) + (ad & FFFFFFFF) + (bc & FFFFFFFF) + (1U << 31);
+  Diy_fp res;
+  res.f= ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  res.e= x.e + y.e + 64;
+  return res;
+}
+
+
+static Diy_fp diy_fp_normalize(Diy_fp x)
+{
+  while (!(x.f & 0xFFC0000000000000ULL))
+  {
+    x.f<<= 10;
+    x.e-= 10;
+  }
+  while (!(x.f & 0x8000000000000000ULL))
+  {
+    x.f<<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+
+/*
+  Cached power c= 10^*k with GRISU_MIN_TARGET_EXP <= e + c.e + 64 <=
+  GRISU_MAX_TARGET_EXP
+*/
+
+static Diy_fp grisu_cached_power(int e, int *k)
+{
+  int min_e= GRISU_MIN_TARGET_EXP - (e + 64);
+  int dk= (int) ceil((min_e + 63) * 0.30102999566398114);
+  int i= (CACHED_POWERS_OFFSET + dk - 1) / CACHED_POWERS_STEP + 1;
+  Diy_fp c;
+  c.f= cached_powers[i].f;
+  c.e= cached_powers[i].e;
+  *k= cached_powers[i].k;
+  DBUG_ASSERT(e + c.e + 64 >= GRISU_MIN_TARGET_EXP &&
+              e + c.e + 64 <= GRISU_MAX_TARGET_EXP);
+  return c;
+}
+
+
+/*
+  Move the last digit of the shortest candidate closer to w, and check
+  that the result is certainly within the boundaries and the closest
+  one, see RoundWeed() in the paper. All distances are relative to
+  too_high, the upper boundary plus the error.
+*/
+
+static my_bool grisu_round_weed(char *buf, int len, ULLong dist_too_high_w,
+                                ULLong unsafe_interval, ULLong rest,
+                                ULLong ten_kappa, ULLong unit)
+{
+  ULLong small_dist= dist_too_high_w - unit;
+  ULLong big_dist= dist_too_high_w + unit;
+  while (rest < small_dist && unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_dist ||
+          small_dist - rest >= rest + ten_kappa - small_dist))
+  {
+    buf[len - 1]--;
+    rest+= ten_kappa;
+  }
+  if (rest < big_dist && unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_dist ||
+       big_dist - rest > rest + ten_kappa - big_dist))
+    return TRUE;
+  return !(2 * unit <= rest && rest <= unsafe_interval - 4 * unit);
+}
+
+
+/*
+  Round the digits of a counted conversion, if the error allows to
+  decide, see RoundWeedCounted() in double-conversion
+*/
+
+static my_bool grisu_round_weed_counted(char *buf, int len, ULLong rest,
+                                        ULLong ten_kappa, ULLong unit,
+                                        int *kappa)
+{
+  int i;
+  if (unit >= ten_kappa || ten_kappa - unit <= unit)
+    return TRUE;
+  if (ten_kappa - rest > rest && ten_kappa - 2 * rest >= 2 * unit)
+    return FALSE;
+  if (rest > unit && ten_kappa - (rest - unit) <= rest - unit)
+  {
+    buf[len - 1]++;
+    for (i= len - 1; i > 0 && buf[i] == '0' + 10; i--)
+    {
+      buf[i]= '0';
+      buf[i - 1]++;
+    }
+    if (buf[0] == '0' + 10)
+    {
+      buf[0]= '1';
+      (*kappa)++;
+    }
+    return FALSE;
+  }
+  return TRUE;
+}
+
+
+/* Largest power of ten <= n, and its exponent plus one */
+
+static ULong biggest_power10(ULong n, int bits, int *exp_plus_one)
+{
+  int guess= (bits + 1) * 1233 >> 12;
+  if (n < small_powers10[guess])
+    guess--;
+  *exp_plus_one= guess + 1;
+  return small_powers10[guess];
+}
+
+
+/*
+  Digits of a positive finite double for dtoa() in mode 0, or in mode 4
+  with ndigits
+
+  @param u       the value
+  @param ndigits maximum number of digits, 0 for the shortest ones
+  @param buf     buffer for at least 18 digits
+  @param len     number of digits written to buf
+  @param decpt   position of the decimal point, as in dtoa()
+
+  @retval FALSE  ok
+  @retval TRUE   the digits could not be proven right, dtoa() must be used
+*/
+
+static my_bool grisu_dtoa(U *u, int ndigits, char *buf, int *len,
+                          int *decpt)
+{
+  ULLong bits= ((ULLong) word0(u) << 32) | word1(u);
+  int be= (int) (bits >> 52);
+  Diy_fp v, w, m_plus, m_minus, c, one, too_low, too_high;
+  ULLong unit= 1, unsafe_interval, fractionals, rest;
+  ULong integrals, divisor;
+  int k, kappa;
+
+  /*
+    dtoa() does not return the shortest digits for denormals in mode 4,
+    leave them to it
+  */
+  if (!be)
+    return TRUE;
+  v.f= (bits & 0xFFFFFFFFFFFFFULL) | 1ULL << 52;
+  v.e= be - Bias - (P - 1);
+
+  /* Boundaries halfway to the neighbours */
+  m_plus.f= (v.f << 1) + 1;
+  m_plus.e= v.e - 1;
+  m_plus= diy_fp_normalize(m_plus);
+  if (v.f == 1ULL << 52 && be > 1)
+  {
+    m_minus.f= (v.f << 2) - 1;
+    m_minus.e= v.e - 2;
+  }
+  else
+  {
+    m_minus.f= (v.f << 1) - 1;
+    m_minus.e= v.e - 1;
+  }
+  m_minus.f<<= m_minus.e - m_plus.e;
+  m_minus.e= m_plus.e;
+
+  w= diy_fp_normalize(v);
+  c= grisu_cached_power(w.e, &k);
+  w= diy_fp_mul(w, c);
+  too_low= diy_fp_mul(m_minus, c);
+  too_high= diy_fp_mul(m_plus, c);
+  too_low.f-= unit;
+  too_high.f+= unit;
+  unsafe_interval= too_high.f - too_low.f;
+
+  one.e= w.e;
+  one.f= 1ULL << -one.e;
+  integrals= (ULong) (too_high.f >> -one.e);
+  fractionals= too_high.f & (one.f - 1);
+  divisor= biggest_power10(integrals, 64 + one.e, &kappa);
+  *len= 0;
+
+  while (kappa > 0)
+  {
+    buf[(*len)++]= (char) ('0' + integrals / divisor);
+    integrals%= divisor;
+    kappa--;
+    rest= ((ULLong) integrals << -one.e) + fractionals;
+    if (rest < unsafe_interval)
+    {
+      if (grisu_round_weed(buf, *len, too_high.f - w.f, unsafe_interval,
+                           rest, (ULLong) divisor << -one.e, unit))
+        return TRUE;
+      goto done;
+    }
+    divisor/= 10;
+  }
+  for (;;)
+  {
+    fractionals*= 10;
+    unit*= 10;
+    unsafe_interval*= 10;
+    buf[(*len)++]= (char) ('0' + (fractionals >> -one.e));
+    fractionals&= one.f - 1;
+    kappa--;
+    if (fractionals < unsafe_interval)
+    {
+      if (grisu_round_weed(buf, *len, (too_high.f - w.f) * unit,
+                           unsafe_interval, fractionals, one.f, unit))
+        return TRUE;
+      break;
+    }
+  }
+
+done:
+  if (!ndigits || *len <= ndigits)
+    goto strip;
+
+  /* Round the value itself to ndigits, the error of w is one unit */
+  unit= 1;
+  integrals= (ULong) (w.f >> -one.e);
+  fractionals= w.f & (one.f - 1);
+  divisor= biggest_power10(integrals, 64 + one.e, &kappa);
+  *len= 0;
+  while (kappa > 0)
+  {
+    buf[(*len)++]= (char) ('0' + integrals / divisor);
+    integrals%= divisor;
+    kappa--;
+    if (*len == ndigits)
+    {
+      rest= ((ULLong) integrals << -one.e) + fractionals;
+      if (grisu_round_weed_counted(buf, *len, rest,
+                                   (ULLong) divisor << -one.e, unit, &kappa))
+        return TRUE;
+      goto strip;
+    }
+    divisor/= 10;
+  }
+  while (*len < ndigits)
+  {
+    if (fractionals <= unit)
+      return TRUE;
+    fractionals*= 10;
+    unit*= 10;
+    buf[(*len)++]= (char) ('0' + (fractionals >> -one.e));
+    fractionals&= one.f - 1;
+    kappa--;
+  }
+  if (grisu_round_weed_counted(buf, *len, fractionals, one.f, unit, &kappa))
+    return TRUE;
+
+strip:
+  *decpt= *len + kappa - k;
+  while (*len > 1 && buf[*len - 1] == '0')
+    (*len)--;
+  return FALSE;
+}
+
+
+/*
+  my_strtod() of a number with at most 19 significant digits and no
+  leading spaces. This covers the output of my_gcvt().
+
+  @retval FALSE  *res and *end are set
+  @retval TRUE   the string must be converted by my_strtod_int()
+*/
+
+static my_bool strtod_fast(const char *s, char **end, double *res)
+{
+  const char *str_end= *end;
+  ULLong w= 0;
+  uint c;
+  int nd= 0, e10= 0, neg= 0, have_digits= 0;
+  Diy_fp x, p;
+  ULLong error, precision_bits, half_way;
+  int k, adj, old_e;
+  U u;
+
+  if (s < str_end && (*s == '-' || *s == '+'))
+    neg= *s++ == '-';
+  for (; s < str_end && *s == '0'; s++)
+    have_digits= 1;
+  for (; s < str_end && (c= (uint) (uchar) *s - '0') <= 9; s++, nd++)
+    w= w * 10 + c;
+  if (s < str_end && *s == '.')
+  {
+    s++;
+    if (!nd)
+    {
+      for (; s < str_end && *s == '0'; s++, e10--)
+        have_digits= 1;
+    }
+    for (; s < str_end && (c= (uint) (uchar) *s - '0') <= 9; s++, nd++, e10--)
+      w= w * 10 + c;
+  }
+  if ((!nd && !have_digits) || nd > 19)
+    return TRUE;
+  if (s < str_end && (*s == 'e' || *s == 'E'))
+  {
+    const char *e= s + 1;
+    int exp_neg= 0, exp= 0, exp_digits= 0;
+    if (e < str_end && (*e == '-' || *e == '+'))
+      exp_neg= *e++ == '-';
+    for (; e < str_end && (c= (uint) (uchar) *e - '0') <= 9; e++)
+    {
+      if (++exp_digits > 4)
+        return TRUE;
+      exp= exp * 10 + c;
+    }
+    if (!exp_digits)
+      return TRUE;
+    e10+= exp_neg ? -exp : exp;
+    s= e;
+  }
+
+  if (!w)
+  {
+    *res= neg ? -0.0 : 0.0;
+    *end= (char*) s;
+    return FALSE;
+  }
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  /* Both w and 10^|e10| are exact, so is the rounding of the result */
+  if (w <= 1ULL << 53 && e10 >= -Ten_pmax && e10 <= Ten_pmax)
+  {
+    double d= (double) w;
+    d= e10 < 0 ? d / tens[-e10] : d * tens[e10];
+    *res= neg ? -d : d;
+    *end= (char*) s;
+    return FALSE;
+  }
+#endif
+
+  /* Leave overflow, underflow and denormals to my_strtod_int() */
+  if (e10 + nd > DBL_MAX_10_EXP || e10 + nd <= DBL_MIN_10_EXP + 1)
+    return TRUE;
+
+  /* The error is counted in 1/8 of the last bit of x */
+  x.f= w;
+  x.e= 0;
+  x= diy_fp_normalize(x);
+  k= (e10 + CACHED_POWERS_OFFSET) / CACHED_POWERS_STEP;
+  p.f= cached_powers[k].f;
+  p.e= cached_powers[k].e;
+  error= 0;
+  if ((adj= e10 - cached_powers[k].k))
+  {
+    x= diy_fp_mul(x, adjustment_powers[adj - 1]);
+    if (nd + adj > 19)
+      error+= 4;
+  }
+  x= diy_fp_mul(x, p);
+  error+= 4 + (error != 0) + 4;
+  old_e= x.e;
+  x= diy_fp_normalize(x);
+  error<<= old_e - x.e;
+  if (x.e + 64 < Emin + 1)
+    return TRUE;
+
+  /* Round to the 53 bits of a double */
+  precision_bits= (x.f & ((1 << 11) - 1)) * 8;
+  half_way= (1 << 10) * 8;
+  if (half_way - error < precision_bits && precision_bits < half_way + error)
+    return TRUE;
+  x.f>>= 11;
+  x.e+= 11;
+  if (precision_bits >= half_way + error && ++x.f == 1ULL << 53)
+  {
+    x.f>>= 1;
+    x.e++;
+  }
+  if (x.e + Bias + P - 1 >= 0x7FF)
+    return TRUE;
+  word0(&u)= (ULong) ((x.f >> 32) & Frac_mask) |
+             (ULong) (x.e + Bias + P - 1) << Exp_shift;
+  word1(&u)= (ULong) x.f;
+  *res= neg ? -dval(&u) : dval(&u);
+  *end= (char*) s;
+  return FALSE;
+}
+
+
 /*
    dtoa for IEEE arithmetic (dmg): convert double to ASCII string.
 
@@ -2245,6 +2790,21 @@ static char *dtoa(double dd, int mode, int ndigits, int *decpt, int *sign,
       *rve= res + 1;
     return res;
   }
+
+  if ((mode == 0 || mode == 4) && my_fast_dtoa)
+  {
+    char digits[24];
+    int len;
+    if (!grisu_dtoa(&u, mode ? MY_MAX(ndigits, 1) : 0, digits, &len, decpt))
+    {
+      char *res= (char*) dtoa_alloc(len + 1, &alloc);
+      memcpy(res, digits, len);
+      res[len]= '\0';
+      if (rve)
+        *rve= res + len;
+      return res;
+    }
+  }
   
 #ifdef Honor_FLT_ROUNDS
   if ((rounding= Flt_Rounds) >= 2)
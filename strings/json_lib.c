@@ -17,6 +17,7 @@
 #include <string.h>
 #include <m_ctype.h>
 #include "json_lib.h"
+#include "ctype-simd.h"
 
 /*
   JSON escaping lets user specify UTF16 codes of characters.
@@ -41,6 +42,14 @@ void json_string_set_cs(json_string_t *s, CHARSET_INFO *i_cs)
   s->cs= i_cs;
   s->error= 0;
   s->wc= i_cs->cset->mb_wc;
+  /*
+    In the multi-byte character sets other than utf8, like sjis,
+    the second byte of a character can be below 0x80.
+  */
+  s->ascii_plain= i_cs->mbminlen == 1 && !(i_cs->state & MY_CS_NONASCII) &&
+                  (i_cs->mbmaxlen == 1 ||
+                   i_cs->cset == my_charset_utf8mb3_bin.cset ||
+                   i_cs->cset == my_charset_utf8mb4_bin.cset);
 }
 
 
@@ -371,6 +380,11 @@ static int skip_str_constant(json_engine_t *j)
   int t, c_len;
   for (;;)
   {
+    /* Skip the plain ASCII characters in bulk */
+    if (j->s.ascii_plain &&
+        j->s.str_end - j->s.c_str >= MY_SIMD_MIN_LENGTH)
+      j->s.c_str+= my_json_plain_prefix_length(j->s.c_str, j->s.str_end);
+
     if ((c_len= json_next_char(&j->s)) > 0)
     {
       j->s.c_str+= c_len;
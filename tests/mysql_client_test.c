@@ -20737,6 +20737,168 @@ static void test_bulk_delete_returning()
   rc= mysql_query(mysql, "DROP TABLE t1");
   myquery(rc);
 }
+
+static void test_bulk_select()
+{
+  int rc;
+  MYSQL_STMT *stmt;
+  MYSQL_BIND bind[2], res_bind[2];
+  int        i,
+             id[]= {3, 1, 5, 3},
+             from[]= {3, 4},
+             to[]= {4, 9},
+             count= sizeof(id)/sizeof(id[0]);
+  /* Expected bulk_row and id of each result row */
+  int        exp_row[]= {0, 1, 3}, exp_id[]= {3, 1, 3};
+  int        exp_range_row[]= {0, 0, 1}, exp_range_id[]= {3, 4, 4};
+  unsigned long length[2];
+  my_bool       is_null[2];
+  my_bool       error[2];
+  longlong      bulk_row;
+  int32         res;
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (id int not null primary key)");
+  myquery(rc);
+  rc= mysql_query(mysql, "insert into t1 values (1), (2), (3), (4)");
+  myquery(rc);
+  verify_affected_rows(4);
+
+  /* Point lookups, one of the keys doesn't exist, one is repeated */
+  stmt= mysql_stmt_init(mysql);
+  rc= mysql_stmt_prepare(stmt, "SELECT id FROM t1 WHERE id=?", -1);
+  check_execute(stmt, rc);
+
+  memset(bind, 0, sizeof(bind));
+  bind[0].buffer_type = MYSQL_TYPE_LONG;
+  bind[0].buffer = (void *)id;
+  bind[0].buffer_length = 0;
+
+  mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*)&count);
+  rc= mysql_stmt_bind_param(stmt, bind);
+  check_execute(stmt, rc);
+
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  DIE_UNLESS(mysql_stmt_field_count(stmt) == 2);
+
+  memset(res_bind, 0, sizeof(res_bind));
+  res_bind[0].buffer_type= MYSQL_TYPE_LONGLONG;
+  res_bind[0].buffer= (char *)&bulk_row;
+  res_bind[1].buffer_type= MYSQL_TYPE_LONG;
+  res_bind[1].buffer= (char *)&res;
+  for (i= 0; i < 2; i++)
+  {
+    res_bind[i].is_null= &is_null[i];
+    res_bind[i].length= &length[i];
+    res_bind[i].error= &error[i];
+  }
+  rc= mysql_stmt_bind_result(stmt, res_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_store_result(stmt);
+  check_execute(stmt, rc);
+
+  i= 0;
+  while (!mysql_stmt_fetch(stmt))
+  {
+    DIE_IF(i >= 3);
+    DIE_IF(is_null[0] || is_null[1]);
+    DIE_IF(bulk_row != exp_row[i]);
+    DIE_IF(res != exp_id[i]);
+    i++;
+  }
+  DIE_IF(i != 3);
+  mysql_stmt_close(stmt);
+
+  /* Several rows per parameter row, two parameters */
+  stmt= mysql_stmt_init(mysql);
+  rc= mysql_stmt_prepare(stmt,
+                         "SELECT id FROM t1 WHERE id BETWEEN ? AND ? "
+                         "ORDER BY id", -1);
+  check_execute(stmt, rc);
+
+  memset(bind, 0, sizeof(bind));
+  bind[0].buffer_type = MYSQL_TYPE_LONG;
+  bind[0].buffer = (void *)from;
+  bind[1].buffer_type = MYSQL_TYPE_LONG;
+  bind[1].buffer = (void *)to;
+
+  count= sizeof(from)/sizeof(from[0]);
+  mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*)&count);
+  rc= mysql_stmt_bind_param(stmt, bind);
+  check_execute(stmt, rc);
+
+  rc= mysql_stmt_execute(stmt);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_bind_result(stmt, res_bind);
+  check_execute(stmt, rc);
+  rc= mysql_stmt_store_result(stmt);
+  check_execute(stmt, rc);
+
+  i= 0;
+  while (!mysql_stmt_fetch(stmt))
+  {
+    DIE_IF(i >= 3);
+    DIE_IF(bulk_row != exp_range_row[i]);
+    DIE_IF(res != exp_range_id[i]);
+    i++;
+  }
+  DIE_IF(i != 3);
+  mysql_stmt_close(stmt);
+
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
+
+
+static void test_bulk_select_unsupported()
+{
+  int rc;
+  MYSQL_STMT *stmt;
+  MYSQL_BIND bind[1];
+  int        i,
+             id[]= {1, 2},
+             count= sizeof(id)/sizeof(id[0]);
+  const char *queries[]=
+  {
+    "SELECT id INTO @a FROM t1 WHERE id=?",
+    "EXPLAIN SELECT id FROM t1 WHERE id=?",
+    "SELECT id FROM t1 WHERE id=? UNION SELECT id FROM t1",
+    "SELECT t1.id FROM t1, t1 AS t2 WHERE t1.id=? AND t2.id=t1.id",
+    "SELECT ?"
+  };
+
+  rc= mysql_query(mysql, "DROP TABLE IF EXISTS t1");
+  myquery(rc);
+  rc= mysql_query(mysql, "CREATE TABLE t1 (id int not null primary key)");
+  myquery(rc);
+  rc= mysql_query(mysql, "insert into t1 values (1), (2)");
+  myquery(rc);
+
+  memset(bind, 0, sizeof(bind));
+  bind[0].buffer_type = MYSQL_TYPE_LONG;
+  bind[0].buffer = (void *)id;
+
+  for (i= 0; i < (int) (sizeof(queries)/sizeof(queries[0])); i++)
+  {
+    if (!opt_silent)
+      fprintf(stdout, "\n %s", queries[i]);
+    stmt= mysql_stmt_init(mysql);
+    rc= mysql_stmt_prepare(stmt, queries[i], -1);
+    check_execute(stmt, rc);
+    mysql_stmt_attr_set(stmt, STMT_ATTR_ARRAY_SIZE, (void*)&count);
+    rc= mysql_stmt_bind_param(stmt, bind);
+    check_execute(stmt, rc);
+    rc= mysql_stmt_execute(stmt);
+    DIE_UNLESS(rc && mysql_stmt_errno(stmt) == ER_UNSUPPORTED_PS);
+    mysql_stmt_close(stmt);
+  }
+
+  /* The connection is still usable */
+  rc= mysql_query(mysql, "DROP TABLE t1");
+  myquery(rc);
+}
 #endif
 
 
@@ -21991,6 +22153,8 @@ static struct my_tests_st my_tests[]= {
   { "test_bulk_replace", test_bulk_replace },
   { "test_bulk_insert_returning", test_bulk_insert_returning },
   { "test_bulk_delete_returning", test_bulk_delete_returning },
+  { "test_bulk_select", test_bulk_select },
+  { "test_bulk_select_unsupported", test_bulk_select_unsupported },
 #endif
   { "test_ps_params_in_ctes", test_ps_params_in_ctes },
   { "test_explain_meta", test_explain_meta },
@@ -19,8 +19,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111 - 1301 USA*/
 #include "mysqld_error.h"
 
 #include <liburing.h>
+#include <fcntl.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <thread>
 #include <mutex>
@@ -28,39 +32,62 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111 - 1301 USA*/
 namespace
 {
 
+/** Nesting depth of aio_uring::begin_batch() in the current thread */
+static thread_local unsigned batch_depth;
+/** The ring whose requests the current thread queues, if batch_depth */
+static thread_local tpool::aio *batch_aio;
+
+/** Maximum number of requests that a thread queues in a batch */
+static constexpr unsigned MAX_BATCH= 64;
+/** Largest buffer that the kernel can register */
+static constexpr size_t MAX_FIXED_BUFFER= 1U << 30;
+/** Idle time in milliseconds before the submission queue thread sleeps */
+static constexpr unsigned SQPOLL_IDLE_MS= 1000;
+
+static unsigned long long now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#ifndef IORING_FEAT_SQPOLL_NONFIXED
+# define IORING_FEAT_SQPOLL_NONFIXED (1U << 7)
+#endif
+
 class aio_uring final : public tpool::aio
 {
 public:
-  aio_uring(tpool::thread_pool *tpool, int max_aio) : tpool_(tpool)
+  aio_uring(tpool::thread_pool *tpool, int max_aio, int options)
+    : tpool_(tpool)
   {
-    if (io_uring_queue_init(max_aio, &uring_, 0) != 0)
+    io_uring_params params;
+    init_ring(max_aio, options, params);
+    if ((params.flags & IORING_SETUP_SQPOLL) &&
+        !(params.features & IORING_FEAT_SQPOLL_NONFIXED))
     {
-      switch (const auto e= errno) {
-      case ENOMEM:
-        my_printf_error(ER_UNKNOWN_ERROR,
-                        "io_uring_queue_init() failed with ENOMEM:"
-                        " try larger memory locked limit, ulimit -l"
-                        ", or https://mariadb.com/kb/en/systemd/#configuring-limitmemlock"
-                        " under systemd"
-#ifdef HAVE_IO_URING_MLOCK_SIZE
-                        " (%zd bytes required)", ME_ERROR_LOG | ME_WARNING,
-                        io_uring_mlock_size(max_aio, 0));
-#else
-                        , ME_ERROR_LOG | ME_WARNING);
-#endif
-        break;
-      case ENOSYS:
-        my_printf_error(ER_UNKNOWN_ERROR,
-                        "io_uring_queue_init() failed with ENOSYS:"
-                        " try uprading the kernel",
-                        ME_ERROR_LOG | ME_WARNING);
-        break;
-      default:
-        my_printf_error(ER_UNKNOWN_ERROR,
-                        "io_uring_queue_init() failed with errno %d",
-                        ME_ERROR_LOG | ME_WARNING, e);
+      // Before Linux 5.11, SQPOLL only works with registered files
+      // (IOSQE_FIXED_FILE); requests to plain file descriptors would
+      // fail with EBADF.
+      my_printf_error(ER_UNKNOWN_ERROR,
+                      "io_uring: the kernel does not support submission"
+                      " queue polling for unregistered files;"
+                      " continuing without it",
+                      ME_ERROR_LOG | ME_WARNING);
+      io_uring_queue_exit(&uring_);
+      options&= ~tpool::AIO_SQPOLL;
+      init_ring(max_aio, options, params);
+    }
+    if (options & tpool::AIO_IOPOLL)
+    {
+      // Polling only works with O_DIRECT. Some files, e.g. of
+      // ROW_FORMAT=COMPRESSED tables, are opened without it.
+      try {
+        buffered_.reset(new aio_uring(tpool, max_aio,
+                                      options & ~tpool::AIO_IOPOLL));
+      } catch (std::runtime_error &) {
+        io_uring_queue_exit(&uring_);
+        throw;
       }
-      throw std::runtime_error("aio_uring()");
     }
 
     thread_= std::thread(thread_routine, this);
@@ -89,46 +116,284 @@ class aio_uring final : public tpool::aio
 
   int submit_io(tpool::aiocb *cb) final
   {
+    if (buffered_ && !is_direct(cb->m_fh))
+      return buffered_->submit_io(cb);
+
     cb->iov_base= cb->m_buffer;
     cb->iov_len= cb->m_len;
+    cb->m_submit_time= now_ns();
 
     // The whole operation since io_uring_get_sqe() and till io_uring_submit()
     // must be atomical. This is because liburing provides thread-unsafe calls.
-    std::lock_guard<std::mutex> _(mutex_);
+    std::unique_lock<std::mutex> lk(mutex_);
 
-    io_uring_sqe *sqe= io_uring_get_sqe(&uring_);
-    if (cb->m_opcode == tpool::aio_opcode::AIO_PREAD)
-      io_uring_prep_readv(sqe, cb->m_fh, static_cast<struct iovec *>(cb), 1,
-                          cb->m_offset);
+    io_uring_sqe *sqe;
+    while (!(sqe= io_uring_get_sqe(&uring_)))
+      // The queue is full of the requests of batches, or with SQPOLL,
+      // of requests that the kernel thread has not picked up yet.
+      submit_queued(lk);
+
+    const int index= find_buffer(cb->m_buffer, cb->m_len);
+    if (index < 0)
+    {
+      if (cb->m_opcode == tpool::aio_opcode::AIO_PREAD)
+        io_uring_prep_readv(sqe, cb->m_fh, static_cast<struct iovec *>(cb), 1,
+                            cb->m_offset);
+      else
+        io_uring_prep_writev(sqe, cb->m_fh, static_cast<struct iovec *>(cb),
+                             1, cb->m_offset);
+    }
+    else if (cb->m_opcode == tpool::aio_opcode::AIO_PREAD)
+      io_uring_prep_read_fixed(sqe, cb->m_fh, cb->m_buffer, cb->m_len,
+                               cb->m_offset, index);
     else
-      io_uring_prep_writev(sqe, cb->m_fh, static_cast<struct iovec *>(cb), 1,
-                           cb->m_offset);
+      io_uring_prep_write_fixed(sqe, cb->m_fh, cb->m_buffer, cb->m_len,
+                                cb->m_offset, index);
     io_uring_sqe_set_data(sqe, cb);
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    if (batch_depth && batch_aio == this && ++batch_size_ < MAX_BATCH)
+      return 0;
+    batch_size_= 0;
+    return submit() < 1 ? -1 : 0;
+  }
+
+  int register_buffer(void *ptr, size_t size) final
+  {
+    std::unique_lock<std::mutex> lk(mutex_);
+    std::vector<iovec> buffers(buffers_);
+    for (size_t ofs= 0; ofs < size; ofs+= MAX_FIXED_BUFFER)
+      buffers.push_back({static_cast<char*>(ptr) + ofs,
+                         std::min(size - ofs, MAX_FIXED_BUFFER)});
+    std::sort(buffers.begin(), buffers.end(),
+              [](const iovec &a, const iovec &b)
+              { return a.iov_base < b.iov_base; });
+    if (int ret= update_buffers(buffers, lk))
+    {
+      my_printf_error(ER_UNKNOWN_ERROR,
+                      "io_uring_register_buffers() failed with errno %d:"
+                      " the buffer pool will be accessed without fixed"
+                      " buffers; try larger memory locked limit, ulimit -l",
+                      ME_ERROR_LOG | ME_WARNING, -ret);
+      return ret;
+    }
+    lk.unlock();
+    return buffered_ ? buffered_->register_buffer(ptr, size) : 0;
+  }
 
-    return io_uring_submit(&uring_) == 1 ? 0 : -1;
+  void unregister_buffer(void *ptr, size_t size) final
+  {
+    std::unique_lock<std::mutex> lk(mutex_);
+    std::vector<iovec> buffers;
+    for (const iovec &b : buffers_)
+      if (b.iov_base < ptr || b.iov_base >= static_cast<char*>(ptr) + size)
+        buffers.push_back(b);
+    if (buffers.size() != buffers_.size())
+      update_buffers(buffers, lk);
+    lk.unlock();
+    if (buffered_)
+      buffered_->unregister_buffer(ptr, size);
+  }
+
+  void begin_batch() final
+  {
+    if (!batch_depth++)
+      batch_aio= this;
+  }
+
+  void submit_batch() final
+  {
+    if (batch_aio != this)
+      return;
+    std::unique_lock<std::mutex> lk(mutex_);
+    batch_size_= 0;
+    if (io_uring_sq_ready(&uring_))
+      submit_queued(lk);
+  }
+
+  void end_batch() final
+  {
+    assert(batch_depth);
+    if (--batch_depth)
+      return;
+    submit_batch();
+    batch_aio= nullptr;
+  }
+
+  void get_stats(tpool::aio_stats *stats) final
+  {
+    stats->submitted= submitted_.load(std::memory_order_relaxed);
+    stats->submit_calls= submit_calls_.load(std::memory_order_relaxed);
+    stats->submit_time= submit_time_.load(std::memory_order_relaxed);
+    stats->completed= completed_.load(std::memory_order_relaxed);
+    stats->completion_time= completion_time_.load(std::memory_order_relaxed);
+    if (buffered_)
+    {
+      tpool::aio_stats s;
+      buffered_->get_stats(&s);
+      stats->submitted+= s.submitted;
+      stats->submit_calls+= s.submit_calls;
+      stats->submit_time+= s.submit_time;
+      stats->completed+= s.completed;
+      stats->completion_time+= s.completion_time;
+    }
   }
 
+  /** Note whether a file that was opened is using O_DIRECT, so that
+  submit_io() can choose the ring without a system call */
   int bind(native_file_handle &fd) final
   {
+    if (!buffered_)
+      return 0;
+    const int flags= fcntl(fd, F_GETFL);
+    if (flags == -1 || !(flags & O_DIRECT))
+      return 0;
     std::lock_guard<std::mutex> _(files_mutex_);
-    auto it= std::lower_bound(files_.begin(), files_.end(), fd);
-    assert(it == files_.end() || *it != fd);
-    files_.insert(it, fd);
-    return io_uring_register_files_update(&uring_, 0, files_.data(),
-                                          files_.size());
+    auto it= std::lower_bound(direct_files_.begin(), direct_files_.end(), fd);
+    if (it == direct_files_.end() || *it != fd)
+      direct_files_.insert(it, fd);
+    return 0;
   }
 
+  /** Forget about a file before it is closed */
   int unbind(const native_file_handle &fd) final
   {
+    if (!buffered_)
+      return 0;
     std::lock_guard<std::mutex> _(files_mutex_);
-    auto it= std::lower_bound(files_.begin(), files_.end(), fd);
-    assert(*it == fd);
-    files_.erase(it);
-    return io_uring_register_files_update(&uring_, 0, files_.data(),
-                                          files_.size());
+    auto it= std::lower_bound(direct_files_.begin(), direct_files_.end(), fd);
+    if (it != direct_files_.end() && *it == fd)
+      direct_files_.erase(it);
+    return 0;
   }
 
 private:
+  /** @return whether bind() found that a file is opened with O_DIRECT */
+  bool is_direct(native_file_handle fd)
+  {
+    std::lock_guard<std::mutex> _(files_mutex_);
+    return std::binary_search(direct_files_.begin(), direct_files_.end(), fd);
+  }
+
+  /** Set up the ring
+  @param max_aio  number of submission queue entries
+  @param options  aio_options
+  @param params   the parameters, as updated by the kernel
+  @throw std::runtime_error on failure */
+  void init_ring(int max_aio, int options, io_uring_params &params)
+  {
+    params= io_uring_params{};
+    if (options & tpool::AIO_SQPOLL)
+    {
+      params.flags|= IORING_SETUP_SQPOLL;
+      params.sq_thread_idle= SQPOLL_IDLE_MS;
+    }
+    if (options & tpool::AIO_IOPOLL)
+      params.flags|= IORING_SETUP_IOPOLL;
+    if (int ret= io_uring_queue_init_params(max_aio, &uring_, &params))
+    {
+      errno= -ret;
+      switch (const auto e= errno) {
+      case ENOMEM:
+        my_printf_error(ER_UNKNOWN_ERROR,
+                        "io_uring_queue_init() failed with ENOMEM:"
+                        " try larger memory locked limit, ulimit -l"
+                        ", or https://mariadb.com/kb/en/systemd/#configuring-limitmemlock"
+                        " under systemd"
+#ifdef HAVE_IO_URING_MLOCK_SIZE
+                        " (%zd bytes required)", ME_ERROR_LOG | ME_WARNING,
+                        io_uring_mlock_size(max_aio, params.flags));
+#else
+                        , ME_ERROR_LOG | ME_WARNING);
+#endif
+        break;
+      case ENOSYS:
+        my_printf_error(ER_UNKNOWN_ERROR,
+                        "io_uring_queue_init() failed with ENOSYS:"
+                        " try uprading the kernel",
+                        ME_ERROR_LOG | ME_WARNING);
+        break;
+      default:
+        my_printf_error(ER_UNKNOWN_ERROR,
+                        "io_uring_queue_init() failed with errno %d",
+                        ME_ERROR_LOG | ME_WARNING, e);
+      }
+      throw std::runtime_error("aio_uring()");
+    }
+  }
+
+  /** Submit the queued requests, with mutex_ held
+  @return number of submitted requests, or negative errno */
+  int submit()
+  {
+    const auto start= now_ns();
+    int ret= io_uring_submit(&uring_);
+    submit_calls_.fetch_add(1, std::memory_order_relaxed);
+    submit_time_.fetch_add(now_ns() - start, std::memory_order_relaxed);
+    return ret;
+  }
+
+  /** Submit the queued requests of all threads, and with SQPOLL wait
+  until the kernel has picked them up. The requests have been handed out
+  already, so a failure can only be retried.
+  @param lk  lock on mutex_, released while waiting */
+  void submit_queued(std::unique_lock<std::mutex> &lk)
+  {
+    for (;;)
+    {
+      int ret= submit();
+      if (!io_uring_sq_ready(&uring_))
+        return;
+      if (ret < 0 && ret != -EAGAIN && ret != -EBUSY && ret != -EINTR)
+      {
+        my_printf_error(ER_UNKNOWN_ERROR,
+                        "io_uring_submit() returned %d\n",
+                        ME_ERROR_LOG | ME_FATAL, ret);
+        abort();
+      }
+      // Let the completion thread reap completions or resubmit requests
+      lk.unlock();
+      std::this_thread::yield();
+      lk.lock();
+    }
+  }
+
+  /** Find the registered buffer that contains a request
+  @return index of the buffer, or -1 */
+  int find_buffer(const void *ptr, size_t len) const
+  {
+    auto it= std::upper_bound(buffers_.begin(), buffers_.end(), ptr,
+                              [](const void *p, const iovec &b)
+                              { return p < b.iov_base; });
+    if (it == buffers_.begin())
+      return -1;
+    --it;
+    if (static_cast<const char*>(ptr) + len >
+        static_cast<const char*>(it->iov_base) + it->iov_len)
+      return -1;
+    return int(it - buffers_.begin());
+  }
+
+  /** Replace the registered buffers, with mutex_ held
+  @return 0 or negative errno; on error, no buffers are registered */
+  int update_buffers(std::vector<iovec> &buffers,
+                     std::unique_lock<std::mutex> &lk)
+  {
+    // Queued requests refer to the buffers by their index
+    if (io_uring_sq_ready(&uring_))
+      submit_queued(lk);
+    if (!buffers_.empty())
+      io_uring_unregister_buffers(&uring_);
+    buffers_.clear();
+    if (buffers.empty())
+      return 0;
+    if (int ret= io_uring_register_buffers(&uring_, buffers.data(),
+                                           unsigned(buffers.size())))
+      return ret;
+    buffers_.swap(buffers);
+    return 0;
+  }
+
   static void thread_routine(aio_uring *aio)
   {
     for (;;)
@@ -161,6 +426,9 @@ class aio_uring final : public tpool::aio
       }
 
       io_uring_cqe_seen(&aio->uring_, cqe);
+      aio->completed_.fetch_add(1, std::memory_order_relaxed);
+      aio->completion_time_.fetch_add(now_ns() - iocb->m_submit_time,
+                                      std::memory_order_relaxed);
       finish_synchronous(iocb);
 
       // If we need to resubmit the IO operation, but the ring is full,
@@ -180,8 +448,25 @@ class aio_uring final : public tpool::aio
   tpool::thread_pool *tpool_;
   std::thread thread_;
 
-  std::vector<native_file_handle> files_;
+  /** Registered buffers, ordered by address; protected by mutex_ */
+  std::vector<iovec> buffers_;
+  /** Number of requests queued by batches; protected by mutex_ */
+  unsigned batch_size_= 0;
+
+  std::atomic<unsigned long long> submitted_{0};
+  std::atomic<unsigned long long> submit_calls_{0};
+  std::atomic<unsigned long long> submit_time_{0};
+  std::atomic<unsigned long long> completed_{0};
+  std::atomic<unsigned long long> completion_time_{0};
+
+  /** With IORING_SETUP_IOPOLL, the bound files that are opened with
+  O_DIRECT, ordered; protected by files_mutex_. Requests to other files
+  go to buffered_. */
+  std::vector<native_file_handle> direct_files_;
   std::mutex files_mutex_;
+
+  /** With IORING_SETUP_IOPOLL, the ring for the files without O_DIRECT */
+  std::unique_ptr<aio_uring> buffered_;
 };
 
 } // namespace
@@ -189,10 +474,10 @@ class aio_uring final : public tpool::aio
 namespace tpool
 {
 
-aio *create_linux_aio(thread_pool *pool, int max_aio)
+aio *create_linux_aio(thread_pool *pool, int max_aio, int options)
 {
   try {
-    return new aio_uring(pool, max_aio);
+    return new aio_uring(pool, max_aio, options);
   } catch (std::runtime_error& error) {
     return nullptr;
   }
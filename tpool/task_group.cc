@@ -25,11 +25,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111 - 1301 USA*/
 #endif
 namespace tpool
 {
-  task_group::task_group(unsigned int max_concurrency) :
+  task_group::task_group(unsigned int max_concurrency,
+                         task_priority priority) :
     m_queue(8),
     m_mtx(),
     m_tasks_running(),
-    m_max_concurrent_tasks(max_concurrency)
+    m_max_concurrent_tasks(max_concurrency),
+    m_priority(priority)
   {};
 
   void task_group::set_max_tasks(unsigned int max_concurrency)
@@ -57,6 +57,30 @@ typedef void (*callback_func)(void *);
 typedef void (*callback_func_np)(void);
 class task;
 
+/**
+  Scheduling classes of tasks. The generic thread pool serves the queued
+  tasks of a higher priority first, unless a task of a lower priority
+  has been waiting for too long.
+*/
+enum task_priority
+{
+  /** Latency critical work, such as IO completions */
+  TASK_PRIORITY_HIGH,
+  TASK_PRIORITY_NORMAL,
+  /** Background work, such as purge or buffer pool load */
+  TASK_PRIORITY_LOW,
+  N_TASK_PRIORITIES
+};
+
+/** Queueing statistics of a task priority class */
+struct task_queue_stats
+{
+  /** Number of tasks that were taken from the queue */
+  unsigned long long tasks;
+  /** Total time that these tasks waited in the queue, in nanoseconds */
+  unsigned long long wait_time;
+};
+
 /** A class that can be used e.g. for
 restricting concurrency for specific class of tasks. */
 
@@ -68,11 +92,14 @@ class task_group
   std::condition_variable m_cv;
   unsigned int m_tasks_running;
   unsigned int m_max_concurrent_tasks;
+  const task_priority m_priority;
 public:
-  task_group(unsigned int max_concurrency= 100000);
+  task_group(unsigned int max_concurrency= 100000,
+             task_priority priority= TASK_PRIORITY_NORMAL);
   void set_max_tasks(unsigned int max_concurrent_tasks);
   void execute(task* t);
   void cancel_pending(task *t);
+  task_priority get_priority() const { return m_priority; }
   ~task_group();
 };
 
@@ -89,6 +116,9 @@ class task
   task(callback_func func, void* arg, task_group* group = nullptr);
   void* get_arg() { return m_arg; }
   callback_func get_func() { return m_func; }
+  /** @return the scheduling class, inherited from the task group */
+  task_priority get_priority() const
+  { return m_group ? m_group->get_priority() : TASK_PRIORITY_NORMAL; }
   virtual void execute();
   virtual ~task() {}
 };
@@ -143,6 +173,10 @@ struct aiocb
   void *m_internal;
   task m_internal_task;
   alignas(8) char m_userdata[MAX_AIO_USERDATA_LEN];
+#ifdef HAVE_URING
+  /** Submission time in nanoseconds, for the completion latency */
+  unsigned long long m_submit_time;
+#endif
 
   aiocb() : m_internal_task(nullptr, nullptr)
   {}
@@ -154,6 +188,31 @@ struct aiocb
 };
 
 
+/** Options of the native AIO, only used by io_uring */
+enum aio_options
+{
+  /** A kernel thread polls the submission queue */
+  AIO_SQPOLL= 1,
+  /** Completions are polled; requests to files that are not opened with
+  O_DIRECT use a second ring without polling */
+  AIO_IOPOLL= 2
+};
+
+/** Counters of the native AIO, only maintained by io_uring */
+struct aio_stats
+{
+  /** Number of submitted requests */
+  unsigned long long submitted;
+  /** Number of system calls which submitted the requests */
+  unsigned long long submit_calls;
+  /** Total time of the submitting system calls, in nanoseconds */
+  unsigned long long submit_time;
+  /** Number of completed requests */
+  unsigned long long completed;
+  /** Total time from submission to completion, in nanoseconds */
+  unsigned long long completion_time;
+};
+
 /**
  AIO interface
 */
@@ -169,6 +228,26 @@ class aio
   virtual int bind(native_file_handle &fd)= 0;
   /** "Unind" file to AIO handler (used on Windows only) */
   virtual int unbind(const native_file_handle &fd)= 0;
+  /**
+    Register a memory area which IO buffers are often allocated from,
+    so that the kernel does not need to map the pages for every request
+    (used with io_uring only).
+    @return 0 on success, or if the registration is not supported */
+  virtual int register_buffer(void *, size_t) { return 0; }
+  /** Unregister a memory area that was passed to register_buffer() */
+  virtual void unregister_buffer(void *, size_t) {}
+  /**
+    Start queueing the requests that the current thread submits, so that
+    they can be passed to the kernel in a single system call by end_batch().
+    Calls may be nested (used with io_uring only).
+  */
+  virtual void begin_batch() {}
+  /** Submit the requests that the current thread has queued so far */
+  virtual void submit_batch() {}
+  /** Submit the queued requests, and stop queueing them */
+  virtual void end_batch() {}
+  /** Get the counters of the submitted and completed requests */
+  virtual void get_stats(aio_stats *stats) { *stats= aio_stats(); }
   virtual ~aio(){};
 protected:
   static void synchronous(aiocb *cb);
@@ -203,7 +282,7 @@ class thread_pool
 protected:
   /* AIO handler */
   std::unique_ptr<aio> m_aio;
-  virtual aio *create_native_aio(int max_io)= 0;
+  virtual aio *create_native_aio(int max_io, int options)= 0;
 
   /**
     Functions to be called at worker thread start/end
@@ -223,10 +302,16 @@ class thread_pool
     m_worker_init_callback= init;
     m_worker_destroy_callback= destroy;
   }
-  int configure_aio(bool use_native_aio, int max_io)
+  /**
+    Create the AIO handler
+    @param use_native_aio  whether to use io_uring, libaio or IOCP
+    @param max_io          maximum number of requests in flight
+    @param options         aio_options for the native AIO
+  */
+  int configure_aio(bool use_native_aio, int max_io, int options= 0)
   {
     if (use_native_aio)
-      m_aio.reset(create_native_aio(max_io));
+      m_aio.reset(create_native_aio(max_io, options));
     else
       m_aio.reset(create_simulated_aio(this));
     return !m_aio ? -1 : 0;
@@ -235,11 +320,32 @@ class thread_pool
   {
     m_aio.reset();
   }
-  int bind(native_file_handle &fd) { return m_aio->bind(fd); }
+  int bind(native_file_handle &fd) { return m_aio ? m_aio->bind(fd) : 0; }
   void unbind(const native_file_handle &fd) { if (m_aio) m_aio->unbind(fd); }
   int submit_io(aiocb *cb) { return m_aio->submit_io(cb); }
+  int register_buffer(void *ptr, size_t size)
+  { return m_aio ? m_aio->register_buffer(ptr, size) : 0; }
+  void unregister_buffer(void *ptr, size_t size)
+  { if (m_aio) m_aio->unregister_buffer(ptr, size); }
+  void begin_batch() { if (m_aio) m_aio->begin_batch(); }
+  void submit_batch() { if (m_aio) m_aio->submit_batch(); }
+  void end_batch() { if (m_aio) m_aio->end_batch(); }
+  void get_aio_stats(aio_stats *stats)
+  {
+    if (m_aio)
+      m_aio->get_stats(stats);
+    else
+      *stats= aio_stats();
+  }
   virtual void wait_begin() {};
   virtual void wait_end() {};
+  /** Get the queueing statistics of each task_priority
+  @param stats  array of N_TASK_PRIORITIES elements */
+  virtual void get_queue_stats(task_queue_stats *stats)
+  {
+    for (int i= 0; i < N_TASK_PRIORITIES; i++)
+      stats[i]= task_queue_stats();
+  }
   virtual ~thread_pool() {}
 };
 const int DEFAULT_MIN_POOL_THREADS= 1;
@@ -39,9 +39,9 @@ namespace tpool
 
 #ifdef __linux__
 #if defined(HAVE_URING) || defined(LINUX_NATIVE_AIO)
-  extern aio* create_linux_aio(thread_pool* tp, int max_io);
+  extern aio* create_linux_aio(thread_pool* tp, int max_io, int options);
 #else
-  aio *create_linux_aio(thread_pool *, int) { return nullptr; };
+  aio *create_linux_aio(thread_pool *, int, int) { return nullptr; };
 #endif
 #endif
 #ifdef _WIN32
@@ -203,13 +203,104 @@ struct MY_ALIGNED(CPU_LEVEL1_DCACHE_LINESIZE)  worker_data
 
 static thread_local worker_data* tls_worker_data;
 
+
+/**
+  How much longer a task waits than a task of the next higher priority
+  that was submitted at the same time, at most. This bounds the delay of
+  background work under a sustained load of more urgent tasks.
+*/
+static constexpr std::chrono::milliseconds TASK_AGING_TIME(100);
+
+/**
+  The task queue of the pool, with a FIFO queue per task_priority.
+  The task with the earliest deadline is served first, where the deadline
+  is the submission time plus TASK_AGING_TIME for each priority level
+  below TASK_PRIORITY_HIGH. So a queued task of a higher priority
+  normally goes first, but an old task of a lower priority is not starved.
+*/
+class task_queue
+{
+  struct entry
+  {
+    task *m_task;
+    std::chrono::steady_clock::time_point m_time;
+  };
+  circular_queue<entry> m_queues[N_TASK_PRIORITIES];
+  task_queue_stats m_stats[N_TASK_PRIORITIES];
+
+public:
+  explicit task_queue(size_t size) : m_stats()
+  {
+    for (auto &q : m_queues)
+      q.resize(size);
+  }
+
+  bool empty()
+  {
+    for (auto &q : m_queues)
+      if (!q.empty())
+        return false;
+    return true;
+  }
+
+  void push(task *t, std::chrono::steady_clock::time_point now)
+  {
+    m_queues[t->get_priority()].push({t, now});
+  }
+
+  /** Dequeue the next task to execute. The queue must not be empty. */
+  task *pop(std::chrono::steady_clock::time_point now)
+  {
+    int p= -1;
+    std::chrono::steady_clock::time_point deadline;
+    for (int i= 0; i < N_TASK_PRIORITIES; i++)
+    {
+      if (m_queues[i].empty())
+        continue;
+      auto d= m_queues[i].front().m_time + i * TASK_AGING_TIME;
+      if (p < 0 || d < deadline)
+      {
+        deadline= d;
+        p= i;
+      }
+    }
+    assert(p >= 0);
+    const entry e= m_queues[p].front();
+    m_queues[p].pop();
+    m_stats[p].tasks++;
+    m_stats[p].wait_time+= std::chrono::duration_cast
+      <std::chrono::nanoseconds>(now - e.m_time).count();
+    return e.m_task;
+  }
+
+  /** Cancel the queued executions of a task */
+  void cancel(task *t)
+  {
+    for (auto &q : m_queues)
+      for (auto it= q.begin(); it != q.end(); it++)
+      {
+        if ((*it).m_task == t)
+        {
+          t->release();
+          (*it).m_task= nullptr;
+        }
+      }
+  }
+
+  void get_stats(task_queue_stats *stats)
+  {
+    std::copy(m_stats, m_stats + N_TASK_PRIORITIES, stats);
+  }
+};
+
+
 class thread_pool_generic : public thread_pool
 {
   /** Cache for per-worker structures */
   cache<worker_data> m_thread_data_cache;
 
   /** The task queue */
-  circular_queue<task*> m_task_queue;
+  task_queue m_task_queue;
 
   /** List of standby (idle) workers */
   doubly_linked_list<worker_data> m_standby_threads;
@@ -316,12 +407,17 @@ class thread_pool_generic : public thread_pool
   void wait_begin() override;
   void wait_end() override;
   void submit_task(task *task) override;
-  virtual aio *create_native_aio(int max_io) override
+  void get_queue_stats(task_queue_stats *stats) override
+  {
+    std::unique_lock<std::mutex> lk(m_mtx);
+    m_task_queue.get_stats(stats);
+  }
+  virtual aio *create_native_aio(int max_io, int options) override
   {
 #ifdef _WIN32
     return create_win_aio(this, max_io);
 #elif defined(__linux__)
-    return create_linux_aio(this,max_io);
+    return create_linux_aio(this, max_io, options);
 #else
     return nullptr;
 #endif
@@ -458,14 +554,7 @@ class thread_pool_generic : public thread_pool
 void thread_pool_generic::cancel_pending(task* t)
 {
   std::unique_lock <std::mutex> lk(m_mtx);
-  for (auto it = m_task_queue.begin(); it != m_task_queue.end(); it++)
-  {
-    if (*it == t)
-    {
-      t->release();
-      *it = nullptr;
-    }
-  }
+  m_task_queue.cancel(t);
 }
 /**
   Register worker in standby list, and wait to be woken.
@@ -548,8 +637,7 @@ bool thread_pool_generic::get_task(worker_data *thread_var, task **t)
   }
 
   /* Dequeue from the task queue.*/
-  *t= m_task_queue.front();
-  m_task_queue.pop();
+  *t= m_task_queue.pop(std::chrono::steady_clock::now());
   m_tasks_dequeued++;
   thread_var->m_state |= worker_data::EXECUTING_TASK;
   thread_var->m_task_start_time = m_timestamp;
@@ -855,12 +943,13 @@ bool thread_pool_generic::too_many_active_threads()
 /** Submit a new task*/
 void thread_pool_generic::submit_task(task* task)
 {
+  const auto now= std::chrono::steady_clock::now();
   std::unique_lock<std::mutex> lk(m_mtx);
   if (m_in_shutdown)
     return;
   task->add_ref();
   m_tasks_enqueued++;
-  m_task_queue.push(task);
+  m_task_queue.push(task, now);
   maybe_wake_or_create_thread();
 }
 
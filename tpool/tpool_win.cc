@@ -271,7 +271,7 @@ class thread_pool_win : public thread_pool
       abort();
   }
 
-  aio *create_native_aio(int max_io) override
+  aio *create_native_aio(int max_io, int) override
   {
     return new native_aio(*this, max_io);
   }
@@ -171,16 +171,80 @@ test_search()
 }
 
 
+/*
+  Scan a document, with or without the bulk skipping of plain ASCII
+  in string constants, and return a checksum of what was seen.
+*/
+static ulong scan_checksum(const uchar *j, size_t len, my_bool ascii_plain)
+{
+  json_engine_t je;
+  ulong csum= 0;
+
+  if (json_scan_start(&je, ci, j, j + len))
+    return 0;
+  je.s.ascii_plain= ascii_plain;
+  do
+  {
+    csum= csum * 31 + je.state;
+    if (je.state == JST_VALUE && json_read_value(&je) == 0 &&
+        json_value_scalar(&je))
+      csum= csum * 31 + je.value_type * 1000 + je.value_len;
+  } while (json_scan_next(&je) == 0);
+
+  return csum * 31 + (ulong) (je.s.c_str - j) * 100 + je.s.error;
+}
+
+
+/*
+  String constants with random content must scan the same way whether
+  the plain ASCII bytes are skipped in bulk or one by one.
+*/
+static void
+test_string_skipping()
+{
+  static const char *pieces[]= {"a", "z", " ", "~", "\\\"", "\\n", "\\u00e9",
+                                "\\", "\"", "\t", "\x7f", "\xc3\xa9",
+                                "\xe2\x82\xac", "\xc3", "\xff",
+                                "abcdefghijklmnopqrstuvwxyz0123456789"};
+  uchar buf[512];
+  ulong rnd= 1;
+  int i, n_diff= 0;
+
+  for (i= 0; i < 20000; i++)
+  {
+    size_t len= 0;
+    buf[len++]= '[';
+    buf[len++]= '"';
+    while (len < sizeof(buf) - 64)
+    {
+      const char *piece;
+      rnd= rnd * 1103515245 + 12345;
+      if ((rnd >> 16) % 64 == 0)
+        break;
+      piece= pieces[(rnd >> 8) % array_elements(pieces)];
+      memcpy(buf + len, piece, strlen(piece));
+      len+= strlen(piece);
+    }
+    memcpy(buf + len, "\", 1]", 5);
+    len+= 5;
+    if (scan_checksum(buf, len, 0) != scan_checksum(buf, len, 1))
+      n_diff++;
+  }
+  ok(n_diff == 0, "string skipping");
+}
+
+
 int main()
 {
   ci= &my_charset_utf8mb3_general_ci;
 
-  plan(6);
+  plan(7);
   diag("Testing json_lib functions.");
 
   test_json_parsing();
   test_path_parsing();
   test_search();
+  test_string_skipping();
 
   return exit_status();
 }
@@ -90,13 +90,77 @@ test_decimal2string()
   return 0;
 
 }
+
+/*
+  Test the conversions between decimals and integers scaled by 10^scale
+*/
+static int
+test_scaled_longlong()
+{
+  ulonglong rnd= 1;
+  int bad_str= 0, bad_bin= 0, bad_dec= 0, bad_frac= 0;
+
+  for (int i= 0; i < 100000; i++)
+  {
+    my_decimal d, d_str, d_bin;
+    uchar bin[16];
+    char str[32], *end;
+    longlong val, res, max= 1;
+    ulonglong abs_val;
+    int len;
+
+    rnd= rnd * 6364136223846793005ULL + 1442695040888963407ULL;
+    decimal_digits_t prec= (decimal_digits_t)
+      (1 + (rnd >> 33) % DECIMAL_SCALED_LONGLONG_DIGITS);
+    decimal_digits_t scale= (decimal_digits_t) ((rnd >> 20) % (prec + 1));
+    for (int j= (int) (rnd >> 10) % (prec + 1); j > 0; j--)
+      max*= 10;
+    rnd= rnd * 6364136223846793005ULL + 1442695040888963407ULL;
+    val= (longlong) ((rnd >> 1) % max);
+    if (rnd & 1)
+      val= -val;
+
+    /* The same value from a string */
+    abs_val= val < 0 ? -(ulonglong) val : (ulonglong) val;
+    len= sprintf(str, "%s%0*llu", val < 0 ? "-" : "", scale + 1, abs_val);
+    if (scale)
+    {
+      memmove(str + len - scale + 1, str + len - scale, scale + 1);
+      str[len - scale]= '.';
+      len++;
+    }
+    end= str + len;
+    string2decimal(str, &d_str, &end);
+
+    if (longlong_scaled2decimal(val, scale, &d) ||
+        my_decimal_cmp(&d, &d_str))
+      bad_str++;
+    if (d.frac != scale)
+      bad_frac++;
+    if (decimal2longlong_scaled(&d_str, scale, &res) || res != val)
+      bad_dec++;
+    decimal2bin(&d, bin, prec, scale);
+    if (bin2longlong_scaled(bin, prec, scale, &res) || res != val ||
+        bin2decimal(bin, &d_bin, prec, scale) || my_decimal_cmp(&d, &d_bin))
+      bad_bin++;
+  }
+  ok(bad_str == 0, "longlong_scaled2decimal");
+  ok(bad_frac == 0, "longlong_scaled2decimal scale");
+  ok(bad_dec == 0, "decimal2longlong_scaled");
+  ok(bad_bin == 0, "bin2longlong_scaled");
+
+  return 0;
+}
+
+
 int main()
 {
-  plan(15);
+  plan(19);
   diag("Testing my_decimal constructor and assignment operators");
 
   test_copy_and_compare();
   test_decimal2string();
+  test_scaled_longlong();
 
   return exit_status();
 }
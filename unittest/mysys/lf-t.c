@@ -174,10 +174,63 @@ pthread_handler_t test_lf_hash(void *arg)
   return 0;
 }
 
+/*
+  read mostly load: look up keys that are always there, now and then
+  insert and delete a key of its own to keep the reclamation busy
+*/
+#define N_STABLE 1000
+pthread_handler_t test_lf_hash_search(void *arg)
+{
+  int    m= *(int *)arg;
+  int32 x, z, missed= 0;
+  LF_PINS *pins;
+
+  pins= lf_hash_get_pins(&lf_hash);
+
+  for (x= ((int)(intptr)(&m)); m ; m--)
+  {
+    int32 *el;
+    x= (x*m+0x87654321) & INT_MAX32;
+    z= x % N_STABLE;
+    el= (int32 *)lf_hash_search(&lf_hash, pins, &z, sizeof(z));
+    if (!el || *el != z)
+      missed++;
+    lf_hash_search_unpin(pins);
+    if (m % 16 == 0)
+    {
+      z= N_STABLE + x % 1000000;
+      lf_hash_insert(&lf_hash, pins, &z);
+      lf_hash_delete(&lf_hash, pins, (uchar *)&z, sizeof(z));
+    }
+  }
+  lf_hash_put_pins(pins);
+  pthread_mutex_lock(&mutex);
+  bad+= missed;
+
+  if (--N == 0)
+  {
+    diag("%d mallocs, %d pins in stack, %d hash size",
+         lf_hash.alloc.mallocs, lf_hash.alloc.pinbox.pins_in_array,
+         lf_hash.size);
+    bad|= lf_hash.count != N_STABLE;
+  }
+  pthread_mutex_unlock(&mutex);
+  return 0;
+}
+
+void fill_lf_hash()
+{
+  LF_PINS *pins= lf_hash_get_pins(&lf_hash);
+  int32 z;
+  for (z= 0; z < N_STABLE; z++)
+    lf_hash_insert(&lf_hash, pins, &z);
+  lf_hash_put_pins(pins);
+}
+
 
 void do_tests()
 {
-  plan(6);
+  plan(10);
 
   lf_alloc_init(&lf_allocator, sizeof(TLA), offsetof(TLA, not_used));
   lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE, 0, sizeof(int), 0,
@@ -195,5 +248,32 @@ void do_tests()
 
   lf_hash_destroy(&lf_hash);
   lf_alloc_destroy(&lf_allocator);
+
+  /* the same with epoch based reclamation instead of pins */
+  lf_alloc_init(&lf_allocator, sizeof(TLA), offsetof(TLA, not_used));
+  lf_alloc_set_epoch_based(&lf_allocator);
+  lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE | LF_HASH_EPOCH, 0,
+               sizeof(int), 0, &my_charset_bin);
+
+  test_concurrently("lf_alloc (epochs)", test_lf_alloc, N= THREADS, CYCLES);
+  test_concurrently("lf_hash (epochs)",  test_lf_hash,  N= THREADS, CYCLES);
+
+  lf_hash_destroy(&lf_hash);
+  lf_alloc_destroy(&lf_allocator);
+
+  /* compare the two on lookups */
+  lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE, 0, sizeof(int), 0,
+               &my_charset_bin);
+  fill_lf_hash();
+  test_concurrently("lf_hash_search (pins)", test_lf_hash_search,
+                    N= THREADS, CYCLES*5);
+  lf_hash_destroy(&lf_hash);
+
+  lf_hash_init(&lf_hash, sizeof(int), LF_HASH_UNIQUE | LF_HASH_EPOCH, 0,
+               sizeof(int), 0, &my_charset_bin);
+  fill_lf_hash();
+  test_concurrently("lf_hash_search (epochs)", test_lf_hash_search,
+                    N= THREADS, CYCLES*5);
+  lf_hash_destroy(&lf_hash);
 }
 
@@ -0,0 +1,100 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+#include <my_global.h>
+#include <my_sys.h>
+#include "tap.h"
+
+/* Allocate like a statement, and check that the memory is usable */
+static my_bool run_statement(MEM_ROOT *root, uint count, size_t length)
+{
+  uint i;
+  for (i= 0; i < count; i++)
+  {
+    char *p= (char*) alloc_root(root, length);
+    if (!p)
+      return TRUE;
+    memset(p, (int) i, length);
+  }
+  return FALSE;
+}
+
+static size_t block_count(MEM_ROOT *root)
+{
+  size_t n= 0;
+  USED_MEM *b;
+  for (b= root->free; b; b= b->next)
+    n++;
+  for (b= root->used; b; b= b->next)
+    n++;
+  return n;
+}
+
+int main(int argc __attribute__((unused)),char *argv[])
+{
+  MEM_ROOT root;
+  size_t allocated, blocks;
+  int i;
+  MY_INIT(argv[0]);
+
+  plan(8);
+
+  /* Without a keep limit, only the preallocated block survives */
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &root, 1024, 2048, MYF(0));
+  ok(!run_statement(&root, 100, 200), "allocate");
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  ok(block_count(&root) <= 1 && root.blocks_reused == 0,
+     "blocks are freed without a keep limit");
+
+  /* With a keep limit, repeating a statement does not allocate */
+  set_root_keep_limit(&root, 64 * 1024);
+  run_statement(&root, 100, 200);
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  allocated= root.blocks_allocated;
+  for (i= 0; i < 10; i++)
+  {
+    run_statement(&root, 100, 200);
+    free_root(&root, MYF(MY_KEEP_PREALLOC));
+  }
+  ok(root.blocks_allocated == allocated, "no blocks allocated when repeated");
+  ok(root.blocks_reused > 0, "blocks reused");
+
+  /* A big statement keeps no more than the limit */
+  ok(!run_statement(&root, 10000, 100), "allocate more than the limit");
+  free_root(&root, MYF(MY_KEEP_PREALLOC));
+  blocks= block_count(&root);
+  {
+    size_t kept= 0;
+    USED_MEM *b;
+    for (b= root.free; b; b= b->next)
+      kept+= b->size;
+    ok(kept <= 64 * 1024, "kept %zu bytes, at most the limit", kept);
+  }
+
+  /* After the peak, small statements let the kept memory shrink */
+  for (i= 0; i < 50; i++)
+  {
+    run_statement(&root, 1, 100);
+    free_root(&root, MYF(MY_KEEP_PREALLOC));
+  }
+  ok(block_count(&root) < blocks, "kept blocks shrink after a peak: %zu < %zu",
+     block_count(&root), blocks);
+
+  free_root(&root, MYF(0));
+  ok(!root.free && !root.used, "everything freed");
+
+  my_end(0);
+  return exit_status();
+}
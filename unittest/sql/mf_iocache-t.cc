@@ -17,6 +17,8 @@
 #include <my_sys.h>
 #include <my_crypt.h>
 #include <tap.h>
+#include "../../mysys/mysys_priv.h"
+#include <thread>
 
 /*** tweaks and stubs for encryption code to compile ***************/
 #define KEY_SIZE (128/8)
@@ -445,10 +447,139 @@ void mdev10963()
   my_delete(file_name, MYF(MY_WME));
 }
 
+/*
+  Asynchronous read service that reads in a new thread, in place of the
+  thread pool of the server
+*/
+static uint aio_reads;
+static std::thread aio_thread;
+
+static int test_aio_read(IO_CACHE_AIO *aio)
+{
+  aio_reads++;
+  /* An IO_CACHE has at most one read-ahead in flight */
+  if (aio_thread.joinable())
+    aio_thread.join();
+  aio_thread= std::thread([aio]()
+  {
+    my_thread_init();
+    size_t length= my_pread(aio->file, aio->buffer, aio->length,
+                            aio->pos_in_file, MYF(0));
+    my_b_aio_read_done(aio, length, length == (size_t) -1 ? my_errno : 0);
+    my_thread_end();
+  });
+  return 0;
+}
+
+static uchar read_ahead_byte(my_off_t pos)
+{
+  return (uchar) (pos * 7 + pos / 251);
+}
+
+static int read_ahead_data_bad(const uchar *buf, my_off_t pos, size_t len)
+{
+  for (size_t i= 0; i < len; i++)
+    if (buf[i] != read_ahead_byte(pos + i))
+      return 1;
+  return 0;
+}
+
+void read_ahead()
+{
+  int res;
+  uchar buf[CACHE_SIZE * 3];
+  const size_t file_size= CACHE_SIZE * 20 + 1000;
+  const size_t chunks[]= { 1, 100, CACHE_SIZE - 3, CACHE_SIZE * 2 + 17, 5000 };
+  const char *file_name= "read_ahead.dat";
+  my_off_t pos;
+  size_t i;
+  File file;
+
+  diag("read-ahead of READ_CACHE");
+
+  _my_b_aio_read= test_aio_read;
+  file= my_open(file_name, O_RDWR | O_TRUNC | O_CREAT, MYF(MY_WME));
+  ok(file >= 0, "file created");
+  for (pos= 0; pos < file_size; pos+= i)
+  {
+    i= MY_MIN(sizeof(buf), file_size - pos);
+    for (size_t j= 0; j < i; j++)
+      buf[j]= read_ahead_byte(pos + j);
+    my_write(file, buf, i, MYF(MY_WME | MY_NABP));
+  }
+
+  res= init_io_cache(&info, file, CACHE_SIZE, READ_CACHE, 0, 0,
+                     MYF(MY_WME | MY_READ_AHEAD));
+  ok(res == 0 && info.aio, "cache with read-ahead" INFO_TAIL);
+
+  /* Sequential reads of different sizes, some larger than the buffer */
+  aio_reads= 0;
+  res= 0;
+  for (pos= 0, i= 0; pos + chunks[i] <= file_size;
+       pos+= chunks[i], i= (i + 1) % array_elements(chunks))
+    res|= my_b_read(&info, buf, chunks[i]) ||
+          read_ahead_data_bad(buf, pos, chunks[i]);
+  ok(res == 0 && my_b_tell(&info) == pos, "sequential reads" INFO_TAIL);
+  ok(aio_reads > 0, "%u read-aheads", aio_reads);
+
+  /* The rest of the file and EOF */
+  res= my_b_read(&info, buf, (size_t) (file_size - pos) + 1);
+  ok(res && info.error == (int) (file_size - pos) &&
+     !read_ahead_data_bad(buf, pos, (size_t) (file_size - pos)),
+     "read at end of file returns the rest");
+
+  /* A seek backwards discards the read-ahead */
+  pos= CACHE_SIZE * 5 + 11;
+  my_b_seek(&info, pos);
+  res= my_b_read(&info, buf, 300) || read_ahead_data_bad(buf, pos, 300);
+  pos+= 300;
+  res|= my_b_read(&info, buf, CACHE_SIZE) ||
+        read_ahead_data_bad(buf, pos, CACHE_SIZE);
+  ok(res == 0, "reads after seek" INFO_TAIL);
+
+  /* Restart reading from the beginning */
+  res= reinit_io_cache(&info, READ_CACHE, 0, 0, 0);
+  for (pos= 0; !res && pos < file_size; pos+= i)
+  {
+    i= MY_MIN(sizeof(buf) / 2, file_size - pos);
+    res= my_b_read(&info, buf, i) || read_ahead_data_bad(buf, pos, i);
+  }
+  ok(res == 0, "reads after reinit_io_cache" INFO_TAIL);
+
+  end_io_cache(&info);
+  ok(info.aio == NULL, "read-ahead is freed");
+
+  /* A temporary file, like the result of filesort */
+  res= open_cached_file(&info, 0, 0, CACHE_SIZE, MYF(MY_READ_AHEAD));
+  for (pos= 0; !res && pos < file_size; pos+= i)
+  {
+    i= MY_MIN(sizeof(buf), file_size - pos);
+    for (size_t j= 0; j < i; j++)
+      buf[j]= read_ahead_byte(pos + j);
+    res= my_b_write(&info, buf, i);
+  }
+  res|= reinit_io_cache(&info, READ_CACHE, 0, 0, 0);
+  ok(res == 0 && (info.aio || encrypt_tmp_files),
+     "temporary file turned to read");
+  for (pos= 0; !res && pos < file_size; pos+= i)
+  {
+    i= MY_MIN(1000, file_size - pos);
+    res= my_b_read(&info, buf, i) || read_ahead_data_bad(buf, pos, i);
+  }
+  ok(res == 0, "temporary file read" INFO_TAIL);
+  close_cached_file(&info);
+
+  _my_b_aio_read= 0;
+  if (aio_thread.joinable())
+    aio_thread.join();
+  my_close(file, MYF(MY_WME));
+  my_delete(file_name, MYF(MY_WME));
+}
+
 int main(int argc __attribute__((unused)),char *argv[])
 {
   MY_INIT(argv[0]);
-  plan(277);
+  plan(287);
 
   /* temp files with and without encryption */
   encrypt_tmp_files= 1;
@@ -468,6 +599,8 @@ int main(int argc __attribute__((unused)),char *argv[])
   mdev17133();
   mdev10963();
 
+  read_ahead();
+
   my_end(0);
   return exit_status();
 }
@@ -0,0 +1,319 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  Tests and speed of the fast paths of my_gcvt() and my_strtod(),
+  see strings/dtoa.c. They are compared with the bignum conversions,
+  which are used when my_fast_dtoa is cleared.
+*/
+
+#include <tap.h>
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+
+
+static ulonglong rnd_state= 88172645463325252ULL;
+
+static ulonglong rnd64(void)
+{
+  /* xorshift64 */
+  rnd_state^= rnd_state << 13;
+  rnd_state^= rnd_state >> 7;
+  rnd_state^= rnd_state << 17;
+  return rnd_state;
+}
+
+
+/*
+  Random finite doubles: any bit pattern, short decimal fractions like
+  in DECIMAL columns, and floats
+*/
+static double rnd_double(uint kind)
+{
+  ulonglong bits;
+  double x;
+  switch (kind % 3) {
+  case 0:
+    do
+    {
+      bits= rnd64();
+      memcpy(&x, &bits, sizeof(x));
+    } while (isnan(x) || isinf(x));
+    return x;
+  case 1:
+    {
+      static const double pow10[]= { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7 };
+      return (double) ((longlong) (rnd64() % 2000000001) - 1000000000) /
+             pow10[rnd64() % array_elements(pow10)];
+    }
+  default:
+    {
+      float f;
+      uint32 fbits;
+      do
+      {
+        fbits= (uint32) rnd64();
+        memcpy(&f, &fbits, sizeof(f));
+      } while (isnan(f) || isinf(f));
+      return f;
+    }
+  }
+}
+
+
+static int test_gcvt(uint count)
+{
+  char fast[MY_GCVT_MAX_FIELD_WIDTH + 1], slow[MY_GCVT_MAX_FIELD_WIDTH + 1];
+  uint i, failed= 0;
+  int width, type;
+  for (i= 0; i < count; i++)
+  {
+    double x= rnd_double(i);
+    for (type= MY_GCVT_ARG_FLOAT; type <= MY_GCVT_ARG_DOUBLE; type++)
+      for (width= 1; width <= MY_GCVT_MAX_FIELD_WIDTH; width++)
+      {
+        my_bool fast_error, slow_error;
+        size_t fast_length, slow_length;
+        my_fast_dtoa= TRUE;
+        fast_length= my_gcvt(x, (my_gcvt_arg_type) type, width, fast,
+                             &fast_error);
+        my_fast_dtoa= FALSE;
+        slow_length= my_gcvt(x, (my_gcvt_arg_type) type, width, slow,
+                             &slow_error);
+        if (fast_length != slow_length || fast_error != slow_error ||
+            strcmp(fast, slow))
+        {
+          if (failed++ < 10)
+            diag("%.17g type=%d width=%d: '%s', expected '%s'",
+                 x, type, width, fast, slow);
+        }
+      }
+  }
+  my_fast_dtoa= TRUE;
+  return failed;
+}
+
+
+/* Fill buf with a random number, maybe followed by other characters */
+static size_t rnd_number(char *buf)
+{
+  char *s= buf;
+  uint i;
+  if (rnd64() % 3 == 0)
+    *s++= "-+"[rnd64() % 2];
+  for (i= rnd64() % 22; i; i--)
+    *s++= '0' + rnd64() % 10;
+  if (rnd64() % 2)
+  {
+    *s++= '.';
+    for (i= rnd64() % 22; i; i--)
+      *s++= '0' + rnd64() % 10;
+  }
+  if (rnd64() % 2)
+  {
+    *s++= "eE"[rnd64() % 2];
+    if (rnd64() % 2)
+      *s++= "-+"[rnd64() % 2];
+    for (i= rnd64() % 5; i; i--)
+      *s++= '0' + rnd64() % (i == 1 ? 10 : 4);
+  }
+  if (rnd64() % 2)
+    *s++= "x 0e."[rnd64() % 5];
+  *s= '\0';
+  return s - buf;
+}
+
+
+static int test_strtod(uint count)
+{
+  char buf[100];
+  uint i, failed= 0;
+  for (i= 0; i < count; i++)
+  {
+    double fast, slow;
+    char *fast_end, *slow_end;
+    int fast_error, slow_error;
+    size_t length;
+    switch (i % 3) {
+    case 0:
+      length= my_gcvt(rnd_double(i / 3), MY_GCVT_ARG_DOUBLE,
+                      MY_GCVT_MAX_FIELD_WIDTH, buf, NULL);
+      break;
+    case 1:
+      length= sprintf(buf, "%.*e", (int) (rnd64() % 19), rnd_double(i / 3));
+      break;
+    default:
+      length= rnd_number(buf);
+    }
+    fast_end= slow_end= buf + rnd64() % (length + 1);
+    my_fast_dtoa= TRUE;
+    fast= my_strtod(buf, &fast_end, &fast_error);
+    my_fast_dtoa= FALSE;
+    slow= my_strtod(buf, &slow_end, &slow_error);
+    if (memcmp(&fast, &slow, sizeof(fast)) || fast_end != slow_end ||
+        fast_error != slow_error)
+    {
+      if (failed++ < 10)
+        diag("'%.*s': %.17g, expected %.17g", (int) (slow_end - buf), buf,
+             fast, slow);
+    }
+  }
+  my_fast_dtoa= TRUE;
+  return failed;
+}
+
+
+/* The shortest digits of my_gcvt() read back to the same double */
+static int test_round_trip(uint count)
+{
+  char buf[MY_GCVT_MAX_FIELD_WIDTH + 1];
+  uint i, failed= 0;
+  for (i= 0; i < count; i++)
+  {
+    double x= rnd_double(i), y;
+    char *end;
+    int error;
+    end= buf + my_gcvt(x, MY_GCVT_ARG_DOUBLE, MY_GCVT_MAX_FIELD_WIDTH, buf,
+                       NULL);
+    y= my_strtod(buf, &end, &error);
+    if (x != y)
+    {
+      if (failed++ < 10)
+        diag("%.17g: '%s' reads as %.17g", x, buf, y);
+    }
+  }
+  return failed;
+}
+
+
+static const struct
+{
+  double x;
+  const char *max_width, *width10, *flt;
+} known_values[]=
+{
+  { 0.1, "0.1", "0.1", "0.1" },
+  { 1.0/3, "0.3333333333333333", "0.33333333", "0.333333" },
+  { 1e23, "1e23", "1e23", "1e23" },
+  { 123456789012345678.0, "1.2345678901234568e17", "1.23457e17",
+    "1.23457e17" },
+  { 2.2250738585072014e-308, "2.2250738585072014e-308", "2.225e-308",
+    "2.22507e-308" },
+  { DBL_MAX, "1.7976931348623157e308", "1.7977e308", "1.79769e308" },
+  { 4.35, "4.35", "4.35", "4.35" },
+  { 0.3f, "0.30000001192092896", "0.30000001", "0.3" },
+  { 1e-5, "0.00001", "0.00001", "0.00001" },
+  { -1.5e300, "-1.5e300", "-1.5e300", "-1.5e300" }
+};
+
+static int test_known_values(void)
+{
+  char buf[MY_GCVT_MAX_FIELD_WIDTH + 1];
+  uint i, failed= 0;
+  for (i= 0; i < array_elements(known_values); i++)
+  {
+    double x= known_values[i].x;
+    my_gcvt(x, MY_GCVT_ARG_DOUBLE, MY_GCVT_MAX_FIELD_WIDTH, buf, NULL);
+    if (strcmp(buf, known_values[i].max_width))
+    {
+      failed++;
+      diag("%.17g: '%s', expected '%s'", x, buf, known_values[i].max_width);
+    }
+    my_gcvt(x, MY_GCVT_ARG_DOUBLE, 10, buf, NULL);
+    if (strcmp(buf, known_values[i].width10))
+    {
+      failed++;
+      diag("%.17g width 10: '%s', expected '%s'", x, buf,
+           known_values[i].width10);
+    }
+    my_gcvt(x, MY_GCVT_ARG_FLOAT, 12, buf, NULL);
+    if (strcmp(buf, known_values[i].flt))
+    {
+      failed++;
+      diag("%.17g float: '%s', expected '%s'", x, buf, known_values[i].flt);
+    }
+  }
+  return failed;
+}
+
+
+#define BENCH_COUNT 1000000
+
+static double ns_per_value(ulonglong nsec)
+{
+  return (double) nsec / BENCH_COUNT;
+}
+
+/* Format and read back doubles, as when dumping and loading a table */
+static void bench(const char *name, uint kind)
+{
+  double *values= (double *) malloc(BENCH_COUNT * sizeof(double));
+  char *text= (char *) malloc(BENCH_COUNT * (MY_GCVT_MAX_FIELD_WIDTH + 1));
+  ulonglong start, gcvt[2], strtod[2];
+  double sum= 0;
+  uint i;
+  int fast;
+
+  for (i= 0; i < BENCH_COUNT; i++)
+    values[i]= rnd_double(kind);
+  for (fast= 0; fast < 2; fast++)
+  {
+    my_fast_dtoa= fast;
+    start= my_interval_timer();
+    for (i= 0; i < BENCH_COUNT; i++)
+      my_gcvt(values[i], MY_GCVT_ARG_DOUBLE, MY_GCVT_MAX_FIELD_WIDTH,
+              text + i * (MY_GCVT_MAX_FIELD_WIDTH + 1), NULL);
+    gcvt[fast]= my_interval_timer() - start;
+
+    start= my_interval_timer();
+    for (i= 0; i < BENCH_COUNT; i++)
+    {
+      char *s= text + i * (MY_GCVT_MAX_FIELD_WIDTH + 1);
+      char *end= s + strlen(s);
+      int error;
+      sum+= my_strtod(s, &end, &error);
+    }
+    strtod[fast]= my_interval_timer() - start;
+  }
+  my_fast_dtoa= TRUE;
+
+  diag("%-8s my_gcvt: %6.1f ns, bignum %6.1f ns; "
+       "my_strtod: %6.1f ns, bignum %6.1f ns",
+       name, ns_per_value(gcvt[1]), ns_per_value(gcvt[0]),
+       ns_per_value(strtod[1]), ns_per_value(strtod[0]));
+  ok(sum != 0, "%s: conversions", name);
+  free(text);
+  free(values);
+}
+
+
+int main(int ac __attribute__((unused)), char **av)
+{
+  MY_INIT(av[0]);
+  plan(7);
+
+  ok(test_gcvt(30000) == 0, "my_gcvt is the same as with bignums");
+  ok(test_strtod(300000) == 0, "my_strtod is the same as with bignums");
+  ok(test_round_trip(300000) == 0, "my_gcvt round trip");
+  ok(test_known_values() == 0, "my_gcvt known values");
+
+  bench("random", 0);
+  bench("decimal", 1);
+  bench("float", 2);
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,384 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  Tests and throughput of the vectorized UTF-8 validation and
+  ASCII conversion paths, see strings/ctype-simd.c, and of the
+  ASCII fast path of the UCA sort keys and hashes, see strings/ctype-uca.ic
+*/
+
+#include <tap.h>
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_ctype.h>
+
+
+static uint32 rnd_state= 1;
+
+static uint rnd(uint n)
+{
+  /* xorshift32 */
+  rnd_state^= rnd_state << 13;
+  rnd_state^= rnd_state >> 17;
+  rnd_state^= rnd_state << 5;
+  return rnd_state % n;
+}
+
+
+/*
+  Fill a buffer with characters of the given lengths (0 means a random
+  byte), the length of each one chosen with the given weights.
+  Returns the number of bytes written.
+*/
+static size_t fill_utf8(uchar *buf, size_t size, const uint *weights)
+{
+  static const char *samples[5][4]=
+  {
+    {"\x80", "\xC0", "\xED\xA0\x80", "\xF4\x90\x80\x80"},   /* random, bad */
+    {"a", " ", "Z", "\x7F"},
+    {"\xC3\x9F", "\xC2\x80", "\xDF\xBF", "\xD0\x96"},
+    {"\xE0\xA0\x80", "\xEF\xBF\xBF", "\xE4\xB8\xAD", "\xED\x9F\xBF"},
+    {"\xF0\x90\x80\x80", "\xF4\x8F\xBF\xBF", "\xF0\x9F\x98\x80",
+     "\xF3\xA0\x80\x80"}
+  };
+  uint total= weights[0] + weights[1] + weights[2] + weights[3] + weights[4];
+  uchar *p= buf, *end= buf + size;
+  while (p + 4 <= end)
+  {
+    uint w= rnd(total), len;
+    for (len= 0; w >= weights[len]; len++)
+      w-= weights[len];
+    if (len == 0 && rnd(2))
+      *p++= (uchar) rnd(256);
+    else
+    {
+      const char *s= samples[len][rnd(4)];
+      size_t l= strlen(s);
+      memcpy(p, s, l);
+      p+= l;
+    }
+  }
+  return (size_t) (p - buf);
+}
+
+
+/* the well formed length, one character at a time */
+static size_t ref_well_formed_char_length(CHARSET_INFO *cs,
+                                          const char *b, const char *e,
+                                          size_t nchars,
+                                          MY_STRCOPY_STATUS *status)
+{
+  size_t nchars0= nchars;
+  int chlen;
+  for ( ; nchars; nchars--, b+= chlen)
+  {
+    if ((chlen= my_ci_charlen(cs, (const uchar *) b, (const uchar *) e)) <= 0)
+    {
+      status->m_well_formed_error_pos= b < e ? b : NULL;
+      status->m_source_end_pos= b;
+      return nchars0 - nchars;
+    }
+  }
+  status->m_well_formed_error_pos= NULL;
+  status->m_source_end_pos= b;
+  return nchars0 - nchars;
+}
+
+
+static int test_well_formed(CHARSET_INFO *cs)
+{
+  static const uint weights[][5]=
+  {
+    {0, 100, 0, 0, 0},
+    {0, 90, 10, 0, 0},
+    {0, 10, 10, 70, 10},
+    {0, 20, 20, 20, 40},
+    {1, 500, 50, 50, 50},
+    {1, 30, 10, 10, 10}
+  };
+  uchar buf[300];
+  uint i, failed= 0;
+
+  for (i= 0; i < 50000; i++)
+  {
+    const uint *w= weights[i % array_elements(weights)];
+    size_t length= fill_utf8(buf, rnd(sizeof(buf)), w);
+    size_t nchars= rnd(4) ? length : rnd((uint) length + 1);
+    const char *b= (const char *) buf + rnd(4);
+    const char *e= (const char *) buf + length;
+    MY_STRCOPY_STATUS st, ref_st;
+    size_t res, ref;
+    if (b > e)
+      b= e;
+    res= my_ci_well_formed_char_length(cs, b, e, nchars, &st);
+    ref= ref_well_formed_char_length(cs, b, e, nchars, &ref_st);
+    if (res != ref || st.m_source_end_pos != ref_st.m_source_end_pos ||
+        st.m_well_formed_error_pos != ref_st.m_well_formed_error_pos)
+    {
+      if (failed++ < 10)
+        diag("%s: length=%d nchars=%d: %d chars, expected %d",
+             cs->cs_name.str, (int) (e - b), (int) nchars, (int) res,
+             (int) ref);
+    }
+  }
+  return failed;
+}
+
+
+static int test_convert(CHARSET_INFO *to_cs, CHARSET_INFO *from_cs)
+{
+  static const uint weights[]= {1, 40, 10, 0, 0};
+  uchar src[300];
+  char dst[1000], ref_dst[1000];
+  uint i, failed= 0;
+
+  for (i= 0; i < 20000; i++)
+  {
+    size_t length= fill_utf8(src, rnd(sizeof(src)), weights);
+    uint errors, ref_errors;
+    uint32 res, ref;
+    res= my_convert(dst, sizeof(dst), to_cs, (const char *) src,
+                    (uint32) length, from_cs, &errors);
+    ref= my_convert_using_func(ref_dst, sizeof(ref_dst), to_cs,
+                               to_cs->cset->wc_mb, (const char *) src,
+                               length, from_cs, from_cs->cset->mb_wc,
+                               &ref_errors);
+    if (res != ref || errors != ref_errors || memcmp(dst, ref_dst, res))
+      failed++;
+
+    if (from_cs->mbmaxlen == 1)
+    {
+      /* the first nchars bytes, in a buffer that may be too short */
+      MY_STRCOPY_STATUS copy_st;
+      MY_STRCONV_STATUS conv_st;
+      size_t nchars= rnd((uint) length + 1);
+      size_t dst_length= rnd(2) ? sizeof(dst) : rnd(sizeof(dst));
+      res= (uint32) my_convert_fix(to_cs, dst, dst_length, from_cs,
+                                   (const char *) src, length, nchars,
+                                   &copy_st, &conv_st);
+      ref= my_convert_using_func(ref_dst, dst_length, to_cs,
+                                 to_cs->cset->wc_mb, (const char *) src,
+                                 nchars, from_cs, from_cs->cset->mb_wc,
+                                 &ref_errors);
+      if (res != ref || memcmp(dst, ref_dst, res))
+        failed++;
+    }
+  }
+  if (failed)
+    diag("%s to %s: %u failures", from_cs->cs_name.str, to_cs->cs_name.str,
+         failed);
+  return failed;
+}
+
+
+/*
+  The utf8 UCA collations have a fast path for ASCII characters,
+  the utf32 ones do not. Both must give the same sort keys and hashes.
+*/
+static int test_uca(const char *utf8_name, const char *utf32_name)
+{
+  static const char *tokens[]=
+  {
+    "a", "b", "Z", "c", "h", "C", "H", "l", "L", "0", "-", "'", " ", " ", " ",
+    "ch", "CH", "ll", "\x01", "\x7F", "\xC3\xA4", "\xC3\x9F", "\xC2\xA0",
+    "\xD0\x96", "\xE0\xB9\x80", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80"
+  };
+  CHARSET_INFO *cs8= get_charset_by_name(utf8_name, MYF(0));
+  CHARSET_INFO *cs32= get_charset_by_name(utf32_name, MYF(0));
+  uchar src[200], src32[800], key[600], key32[600];
+  uint i, failed= 0;
+
+  if (!cs8 || !cs32)
+  {
+    diag("get_charset_by_name() failed");
+    return 1;
+  }
+  for (i= 0; i < 20000; i++)
+  {
+    uchar *p= src, *end= src + rnd(sizeof(src) - 8);
+    size_t length, length32, dstlen= rnd(sizeof(key) + 1);
+    uint nweights= rnd(4) ? (uint) sizeof(key) : rnd(100);
+    uint flags= rnd(4) ? MY_STRXFRM_PAD_WITH_SPACE : 0;
+    size_t res, res32;
+    ulong nr1= 1, nr2= 4, nr1_32= 1, nr2_32= 4;
+    uint errors;
+
+    /* Mostly ASCII, sometimes with trailing spaces */
+    while (p < end)
+    {
+      const char *t= tokens[rnd(8) ? rnd(19) : rnd(array_elements(tokens))];
+      memcpy(p, t, strlen(t));
+      p+= strlen(t);
+    }
+    if (!rnd(4))
+      for (end= p + rnd(8); p < end; )
+        *p++= ' ';
+    length= (size_t) (p - src);
+    length32= my_convert((char *) src32, sizeof(src32), cs32,
+                         (const char *) src, (uint32) length, cs8, &errors);
+    if (rnd(2))
+      flags|= MY_STRXFRM_PAD_TO_MAXLEN;
+
+    res= cs8->coll->strnxfrm(cs8, key, dstlen, nweights, src, length, flags);
+    res32= cs32->coll->strnxfrm(cs32, key32, dstlen, nweights,
+                                src32, length32, flags);
+    my_ci_hash_sort(cs8, src, length, &nr1, &nr2);
+    my_ci_hash_sort(cs32, src32, length32, &nr1_32, &nr2_32);
+    if (res != res32 || memcmp(key, key32, res) ||
+        nr1 != nr1_32 || nr2 != nr2_32)
+    {
+      if (failed++ < 5)
+        diag("%s: '%.*s' dstlen=%d nweights=%u flags=%u",
+             utf8_name, (int) length, src, (int) dstlen, nweights, flags);
+    }
+  }
+  return failed;
+}
+
+
+#define BENCH_SIZE (16*1024*1024)
+#define BENCH_ROUNDS 4
+
+static double gb_per_sec(size_t bytes, ulonglong nsec)
+{
+  return nsec ? (double) bytes / nsec : 0;
+}
+
+/*
+  Sort keys of short strings, like in a filesort, with a UCA
+  collation and with the binary collation.
+*/
+static void bench_uca(const char *name, const uint *weights)
+{
+  CHARSET_INFO *cs= &my_charset_utf8mb4_unicode_ci;
+  CHARSET_INFO *bin_cs= &my_charset_utf8mb4_bin;
+  uchar *buf= (uchar *) malloc(BENCH_SIZE);
+  uchar key[256];
+  size_t length= fill_utf8(buf, BENCH_SIZE, weights), bytes= 0, pos;
+  ulonglong start, uca, bin, hash;
+  ulong nr1= 1, nr2= 4;
+  uint i;
+
+  start= my_interval_timer();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    for (pos= 0; pos + 32 <= length; pos+= 32)
+      bytes+= cs->coll->strnxfrm(cs, key, sizeof(key), 32, buf + pos, 32,
+                                 MY_STRXFRM_PAD_WITH_SPACE);
+  uca= my_interval_timer() - start;
+
+  start= my_interval_timer();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    for (pos= 0; pos + 32 <= length; pos+= 32)
+      bytes+= bin_cs->coll->strnxfrm(bin_cs, key, sizeof(key), 32,
+                                     buf + pos, 32,
+                                     MY_STRXFRM_PAD_WITH_SPACE);
+  bin= my_interval_timer() - start;
+
+  start= my_interval_timer();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    for (pos= 0; pos + 32 <= length; pos+= 32)
+      my_ci_hash_sort(cs, buf + pos, 32, &nr1, &nr2);
+  hash= my_interval_timer() - start;
+
+  diag("%-8s utf8mb4_unicode_ci strnxfrm: %6.2f GB/s, "
+       "utf8mb4_bin strnxfrm: %6.2f GB/s, hash_sort: %6.2f GB/s",
+       name, gb_per_sec(length * BENCH_ROUNDS, uca),
+       gb_per_sec(length * BENCH_ROUNDS, bin),
+       gb_per_sec(length * BENCH_ROUNDS, hash));
+  ok(bytes > 0, "%s: sort keys", name);
+  free(buf);
+}
+
+
+static void bench(const char *name, const uint *weights)
+{
+  CHARSET_INFO *cs= &my_charset_utf8mb4_general_ci;
+  uchar *buf= (uchar *) malloc(BENCH_SIZE);
+  char *dst= (char *) malloc(BENCH_SIZE);
+  size_t length= fill_utf8(buf, BENCH_SIZE, weights);
+  const char *b= (const char *) buf, *e= b + length;
+  MY_STRCOPY_STATUS st;
+  size_t res= 0, ref= 0;
+  ulonglong start, simd, scalar, convert;
+  uint i, errors;
+
+  start= my_interval_timer();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    res+= my_ci_well_formed_char_length(cs, b, e, length, &st);
+  simd= my_interval_timer() - start;
+
+  start= my_interval_timer();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    ref+= ref_well_formed_char_length(cs, b, e, length, &st);
+  scalar= my_interval_timer() - start;
+
+  start= my_interval_timer();
+  for (i= 0; i < BENCH_ROUNDS; i++)
+    my_convert(dst, BENCH_SIZE, &my_charset_latin1, b, (uint32) length, cs,
+               &errors);
+  convert= my_interval_timer() - start;
+
+  diag("%-8s well_formed_char_length: %6.2f GB/s, "
+       "char by char: %6.2f GB/s, utf8mb4 to latin1: %6.2f GB/s",
+       name, gb_per_sec(length * BENCH_ROUNDS, simd),
+       gb_per_sec(length * BENCH_ROUNDS, scalar),
+       gb_per_sec(length * BENCH_ROUNDS, convert));
+  ok(res == ref, "%s: same number of characters", name);
+  free(buf);
+  free(dst);
+}
+
+
+int main(int ac __attribute__((unused)), char **av)
+{
+  static const uint ascii[]= {0, 100, 0, 0, 0};
+  static const uint latin[]= {0, 90, 10, 0, 0};
+  static const uint cjk[]=   {0, 10, 0, 90, 0};
+  static const uint emoji[]= {0, 50, 0, 0, 50};
+
+  MY_INIT(av[0]);
+  plan(16);
+
+  ok(test_well_formed(&my_charset_utf8mb4_general_ci) == 0,
+     "utf8mb4 well_formed_char_length");
+  ok(test_well_formed(&my_charset_utf8mb3_general_ci) == 0,
+     "utf8mb3 well_formed_char_length");
+  ok(test_convert(&my_charset_utf8mb4_general_ci, &my_charset_latin1) == 0,
+     "latin1 to utf8mb4");
+  ok(test_convert(&my_charset_latin1, &my_charset_utf8mb4_general_ci) == 0,
+     "utf8mb4 to latin1");
+
+  ok(test_uca("utf8mb4_unicode_ci", "utf32_unicode_ci") == 0,
+     "utf8mb4_unicode_ci sort keys and hashes");
+  ok(test_uca("utf8mb4_unicode_520_nopad_ci",
+              "utf32_unicode_520_nopad_ci") == 0,
+     "utf8mb4_unicode_520_nopad_ci sort keys and hashes");
+  ok(test_uca("utf8mb4_spanish2_ci", "utf32_spanish2_ci") == 0,
+     "utf8mb4_spanish2_ci sort keys and hashes");
+  ok(test_uca("utf8mb4_thai_520_w2", "utf32_thai_520_w2") == 0,
+     "utf8mb4_thai_520_w2 sort keys and hashes");
+
+  bench("ascii", ascii);
+  bench("latin", latin);
+  bench("cjk", cjk);
+  bench("emoji", emoji);
+  bench_uca("ascii", ascii);
+  bench_uca("latin", latin);
+  bench_uca("cjk", cjk);
+  bench_uca("emoji", emoji);
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2024, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA */
+
+/*
+  Tests of the order in which the generic thread pool runs queued tasks
+  of different task_priority.
+
+  The pool has a single thread, which is kept busy by a blocking task
+  while the tasks under test are queued, so that they all wait in the
+  queue and their order is decided by the priorities alone.
+*/
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <thr_timer.h>
+#include <tap.h>
+#include <tpool.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::mutex mtx;
+static std::condition_variable cv;
+static bool blocked, started;
+static std::vector<size_t> order;
+
+static tpool::task_group high_group(100000, tpool::TASK_PRIORITY_HIGH);
+static tpool::task_group normal_group(100000, tpool::TASK_PRIORITY_NORMAL);
+static tpool::task_group low_group(100000, tpool::TASK_PRIORITY_LOW);
+static tpool::task_group *const groups[tpool::N_TASK_PRIORITIES]=
+  { &high_group, &normal_group, &low_group };
+
+static void block(void *)
+{
+  std::unique_lock<std::mutex> lk(mtx);
+  started= true;
+  cv.notify_all();
+  while (blocked)
+    cv.wait(lk);
+}
+
+static void record(void *arg)
+{
+  std::lock_guard<std::mutex> lk(mtx);
+  order.push_back(size_t(arg));
+  cv.notify_all();
+}
+
+static tpool::task blocker(block, nullptr);
+
+/* Keep the only thread of the pool busy until unblock() */
+static void block_pool(tpool::thread_pool *pool)
+{
+  std::unique_lock<std::mutex> lk(mtx);
+  blocked= true;
+  started= false;
+  order.clear();
+  lk.unlock();
+  pool->submit_task(&blocker);
+  lk.lock();
+  while (!started)
+    cv.wait(lk);
+}
+
+/* Let the queued tasks run, and wait for n of them */
+static std::vector<size_t> unblock(size_t n)
+{
+  std::unique_lock<std::mutex> lk(mtx);
+  blocked= false;
+  cv.notify_all();
+  while (order.size() < n)
+    cv.wait(lk);
+  return order;
+}
+
+int main(int, char **argv)
+{
+  MY_INIT(argv[0]);
+  plan(3);
+  /* The maintenance timer of the pool runs on the mysys timer thread */
+  init_thr_timer(1);
+
+  tpool::thread_pool *pool= tpool::create_thread_pool_generic(1, 1);
+  std::vector<tpool::task> tasks;
+  tasks.reserve(8);
+  auto submit= [&](size_t id, tpool::task_priority priority)
+  {
+    tasks.emplace_back(record, reinterpret_cast<void*>(id), groups[priority]);
+    pool->submit_task(&tasks.back());
+  };
+
+  /* Tasks queued at about the same time run by priority, FIFO within one */
+  block_pool(pool);
+  submit(1, tpool::TASK_PRIORITY_LOW);
+  submit(2, tpool::TASK_PRIORITY_NORMAL);
+  submit(3, tpool::TASK_PRIORITY_HIGH);
+  submit(4, tpool::TASK_PRIORITY_NORMAL);
+  submit(5, tpool::TASK_PRIORITY_HIGH);
+  ok(unblock(5) == std::vector<size_t>({3, 5, 2, 4, 1}),
+     "queued tasks run by priority");
+
+  /*
+    A task of the lowest priority that waited longer than the aging time
+    of two priority levels (2 * 100ms) runs before newer tasks of higher
+    priority.
+  */
+  block_pool(pool);
+  submit(6, tpool::TASK_PRIORITY_LOW);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  submit(7, tpool::TASK_PRIORITY_NORMAL);
+  submit(8, tpool::TASK_PRIORITY_HIGH);
+  ok(unblock(3) == std::vector<size_t>({6, 8, 7}),
+     "an old task of low priority is not starved");
+
+  /* The blocking tasks have no task group, so they are of normal priority */
+  tpool::task_queue_stats stats[tpool::N_TASK_PRIORITIES];
+  pool->get_queue_stats(stats);
+  ok(stats[tpool::TASK_PRIORITY_HIGH].tasks == 3 &&
+     stats[tpool::TASK_PRIORITY_NORMAL].tasks == 5 &&
+     stats[tpool::TASK_PRIORITY_LOW].tasks == 2,
+     "tasks are counted by priority");
+
+  delete pool;
+  end_thr_timer();
+  my_end(0);
+  return exit_status();
+}